@@ -10,19 +10,31 @@ namespace sld {
     // API
     //-------------------------------------------------------------------
 
+    // same slot table as the block allocator, free arenas are
+    // decommitted so the free list lives in its own reservation
     struct arena_allocator_t {
         memory_t memory;
+        memory_t slots;
         u32      arena_size;
         u32      arena_count;
+        u32      page_size;
+        u32      free_count;
+        u32      free_head;
+        u32*     free_next;
+        u64*     used_bits;
     };
 
-    SLD_API_INLINE void     arena_allocator_reserve_os_memory (arena_allocator_t*       alctr, const u32 size_total, const u32 size_arena);
+    constexpr u32 ARENA_ALLOCATOR_INDEX_INVALID = 0xFFFFFFFF;
+
+    SLD_API_INLINE bool     arena_allocator_reserve_os_memory (arena_allocator_t*       alctr, const u32 size_total, const u32 size_arena, const os_memory_page_policy_e page_policy = os_memory_page_policy_e_default);
     SLD_API_INLINE void     arena_allocator_release_os_memory (arena_allocator_t*       alctr);
     SLD_API_INLINE bool     arena_allocator_is_valid          (const arena_allocator_t* alctr);
     SLD_API_INLINE bool     arena_allocator_is_arena_valid    (const arena_allocator_t* alctr, const arena_t* arena);
+    SLD_API_INLINE bool     arena_allocator_is_arena_used     (const arena_allocator_t* alctr, const u32 arena_index);
     SLD_API_INLINE void     arena_allocator_assert_valid      (const arena_allocator_t* alctr);
-    SLD_API_INLINE arena_t* arena_allocator_commit            (const arena_allocator_t* alctr);
-    SLD_API_INLINE void     arena_allocator_decommit          (const arena_allocator_t* alctr, arena_t* arena);
+    SLD_API_INLINE u32      arena_allocator_get_arena_index   (const arena_allocator_t* alctr, const arena_t* arena);
+    SLD_API_INLINE arena_t* arena_allocator_commit            (arena_allocator_t*       alctr);
+    SLD_API_INLINE void     arena_allocator_decommit          (arena_allocator_t*       alctr, arena_t* arena);
     SLD_API_INLINE u32      arena_allocator_get_size_total    (const arena_allocator_t* alctr);
     SLD_API_INLINE u32      arena_allocator_get_size_free     (const arena_allocator_t* alctr);
     SLD_API_INLINE u32      arena_allocator_get_size_used     (const arena_allocator_t* alctr);
@@ -33,11 +45,12 @@ namespace sld {
     // INLINE METHODS
     //-------------------------------------------------------------------
 
-    SLD_API_INLINE void 
+    SLD_API_INLINE bool
     arena_allocator_reserve_os_memory(
-        arena_allocator_t* alctr,
-        const u32          size_total,
-        const u32          size_arena) {
+        arena_allocator_t*            alctr,
+        const u32                     size_total,
+        const u32                     size_arena,
+        const os_memory_page_policy_e page_policy) {
 
         // check args
         bool can_acquire = true;
@@ -46,21 +59,56 @@ namespace sld {
         can_acquire &= (size_arena <  size_total);
         assert(can_acquire);
 
-        // calculate the aligned sizes
-        const u32 size_arena_aligned = os_memory_align_to_page (size_arena);
-        const u32 size_total_aligned = size_align_pow_2        (size_total, size_arena_aligned);
+        // calculate the aligned sizes, with huge pages every arena
+        // has to start and end on a page of the size we asked for
+        const u32 size_page          = os_memory_page_policy_size (page_policy);
+        const u32 size_arena_aligned = size_align_pow_2           (os_memory_align_to_page(size_arena), size_page);
+        const u32 size_total_aligned = size_align_pow_2           (size_total, size_arena_aligned);
 
         // reserve memory
         memory_t memory;
         memory.addr = 0;
         memory.size = size_total_aligned;
-        memory_os_reserve(memory);
+        const u32 page_size   = memory_os_reserve(memory, page_policy);
+        if (page_size == 0) return(false);
+        const u32 arena_count = memory.size / size_arena_aligned;
+
+        // reserve and commit the slot table
+        const u32 size_free_next = (arena_count * sizeof(u32));
+        const u32 size_used_bits = ((arena_count + 63) / 64) * sizeof(u64);
+        memory_t slots;
+        slots.addr = 0;
+        slots.size = (size_free_next + size_used_bits);
+        if (memory_os_reserve(slots) == 0) {
+            memory_os_release(memory);
+            return(false);
+        }
+        memory_os_commit(slots);
 
         // initialize the allocator
         alctr->memory      = memory;
+        alctr->slots       = slots;
+        alctr->page_size   = page_size;
         alctr->arena_size  = size_arena_aligned;
-        alctr->arena_count = alctr->memory.size / size_arena_aligned;
+        alctr->arena_count = arena_count;
+        alctr->free_count  = arena_count;
+        alctr->free_head   = 0;
+        alctr->free_next   = (u32*)(slots.addr);
+        alctr->used_bits   = (u64*)(slots.addr + size_free_next);
+
+        // every arena starts out free, linked in address order
+        for (
+            u32 arena_index = 0;
+                arena_index < arena_count;
+              ++arena_index) {
+
+            alctr->free_next[arena_index] = (arena_index + 1);
+        }
+        alctr->free_next[arena_count - 1] = ARENA_ALLOCATOR_INDEX_INVALID;
+        memset(alctr->used_bits, 0, size_used_bits);
+
         arena_allocator_assert_valid(alctr);
+        return(true);
     }
 
     SLD_API_INLINE void
@@ -69,6 +117,7 @@ namespace sld {
 
         arena_allocator_assert_valid(alctr);
         memory_os_release(alctr->memory);
+        memory_os_release(alctr->slots);
     }
 
     SLD_API_INLINE bool
@@ -78,13 +127,12 @@ namespace sld {
         bool is_valid = (alctr != NULL);
         if (is_valid) {
 
-            const bool is_reserved  = os_memory_is_reserved  (alctr->memory.ptr);
-            const bool is_committed = os_memory_is_committed (alctr->memory.ptr);
-
-            is_valid &= (is_reserved || is_committed);
-            is_valid &= (alctr->memory.addr != 0);  
-            is_valid &= (alctr->arena_count != 0);  
+            is_valid &= (alctr->memory.addr != 0);
+            is_valid &= (alctr->arena_count != 0);
             is_valid &= (alctr->arena_size  != 0);
+            is_valid &= (alctr->free_count  <= alctr->arena_count);
+            is_valid &= (alctr->free_next   != NULL);
+            is_valid &= (alctr->used_bits   != NULL);
         }
         return(is_valid);
     }
@@ -95,8 +143,8 @@ namespace sld {
         const arena_t*           arena) {
 
         bool is_valid = true;
-        is_valid &= arena_allocator_is_valid (alctr); 
-        is_valid &= arena_is_valid    (arena); 
+        is_valid &= arena_allocator_is_valid (alctr);
+        is_valid &= arena_is_valid    (arena);
 
         if (is_valid) {
 
@@ -104,16 +152,27 @@ namespace sld {
             memory_assert_valid(arena_memory);
 
             // make sure this arena is managed by the allocator;
-            const addr last_arena_addr = (alctr->memory.addr + alctr->memory.size) - alctr->arena_size; 
-            const u32  arena_offset    = (arena_memory.addr  - alctr->memory.addr);
-            is_valid &= (arena->size       == alctr->arena_size);
-            is_valid &= (arena_memory.addr <  last_arena_addr); 
+            const addr last_arena_addr = (alctr->memory.addr + alctr->memory.size) - alctr->arena_size;
+            const u64  arena_offset    = (arena_memory.addr  - alctr->memory.addr);
+            is_valid &= (arena_memory.size == alctr->arena_size);
+            is_valid &= (arena_memory.addr >= alctr->memory.addr);
+            is_valid &= (arena_memory.addr <= last_arena_addr);
             is_valid &= ((arena_offset % alctr->arena_size) == 0);
         }
 
         return(is_valid);
     }
 
+    SLD_API_INLINE bool
+    arena_allocator_is_arena_used(
+        const arena_allocator_t* alctr,
+        const u32                arena_index) {
+
+        const u64  used_word = alctr->used_bits[arena_index / 64];
+        const bool is_used   = ((used_word >> (arena_index % 64)) & 1);
+        return(is_used);
+    }
+
     SLD_API_INLINE void
     arena_allocator_assert_valid(
         const arena_allocator_t* alctr) {
@@ -121,54 +180,76 @@ namespace sld {
         assert(arena_allocator_is_valid(alctr));
     }
 
+    SLD_API_INLINE u32
+    arena_allocator_get_arena_index(
+        const arena_allocator_t* alctr,
+        const arena_t*           arena) {
+
+        const u64 arena_offset = ((addr)arena - alctr->memory.addr);
+        const u32 arena_index  = (u32)(arena_offset / alctr->arena_size);
+        return(arena_index);
+    }
+
     SLD_API_INLINE arena_t*
     arena_allocator_commit(
-        const arena_allocator_t* alctr) {
+        arena_allocator_t* alctr) {
 
         arena_allocator_assert_valid(alctr);
 
-        memory_t arena_memory;
-        arena_memory.size = alctr->arena_size;
-        arena_memory.addr = alctr->memory.addr;
+        // pop the next free arena
+        const u32 arena_index = alctr->free_head;
+        if (arena_index == ARENA_ALLOCATOR_INDEX_INVALID) return(NULL);
 
-        for (
-            u32 arena_index = 0;
-                arena_index < alctr->arena_count;
-              ++arena_index) {
+        assert(!arena_allocator_is_arena_used(alctr, arena_index));
+        alctr->free_head                    = alctr->free_next[arena_index];
+        alctr->free_next[arena_index]       = ARENA_ALLOCATOR_INDEX_INVALID;
+        alctr->used_bits[arena_index / 64] |= ((u64)1 << (arena_index % 64));
+        --alctr->free_count;
 
-            const bool is_free = memory_is_os_reserved(arena_memory);
-            if (is_free) {
-                memory_os_commit(arena_memory);
-
-                arena_t* arena  = arena_from_memory(arena_memory);
-                arena->position = 0;
-                arena->save     = 0;
-                arena->size     = (arena_memory.size - sizeof(arena_t));
-                arena_assert_valid(arena);
-                return(arena);
-            }
-            arena_memory.addr += alctr->arena_size;
-        }
-
-        return(NULL);
+        memory_t arena_memory;
+        arena_memory.size = alctr->arena_size;
+        arena_memory.addr = alctr->memory.addr + ((u64)arena_index * alctr->arena_size);
+        memory_os_commit(arena_memory);
+
+        arena_t* arena            = arena_from_memory(arena_memory);
+        arena->position           = 0;
+        arena->save               = 0;
+        arena->size               = (arena_memory.size - sizeof(arena_t));
+        arena->committed          = arena->size;
+        arena->commit_chunk       = 0;
+        arena->decommit_threshold = ARENA_DECOMMIT_THRESHOLD_NEVER;
+        arena_assert_valid(arena);
+        return(arena);
     }
-    
+
     SLD_API_INLINE void
     arena_allocator_decommit(
         arena_allocator_t* alctr,
-        arena_t*    arena) {
+        arena_t*           arena) {
+
+        bool can_free = arena_allocator_is_arena_valid (alctr, arena);
+        assert(can_free);
 
-        bool can_free = arena_allocator_is_arena_valid (alctr, arena); 
+        // make sure it isn't already free
+        const u32 arena_index = arena_allocator_get_arena_index(alctr, arena);
+        can_free &= arena_allocator_is_arena_used(alctr, arena_index);
         assert(can_free);
 
         // free the arena
         memory_t arena_memory = arena_to_memory(arena);
-        arena->size     = 0;
-        arena->position = 0;
-        arena->save     = 0;
+        arena->size      = 0;
+        arena->position  = 0;
+        arena->save      = 0;
+        arena->committed = 0;
         memory_os_decommit(arena_memory);
+
+        // push it back on the free list
+        alctr->used_bits[arena_index / 64] &= ~((u64)1 << (arena_index % 64));
+        alctr->free_next[arena_index]       = alctr->free_head;
+        alctr->free_head                    = arena_index;
+        ++alctr->free_count;
     }
-    
+
     SLD_API_INLINE u32
     arena_allocator_get_size_total(
         const arena_allocator_t* alctr) {
@@ -178,76 +259,47 @@ namespace sld {
         const u32 size_total = (alctr->arena_size * alctr->arena_count);
         return(size_total);
     }
-    
+
     SLD_API_INLINE u32
     arena_allocator_get_size_free(
         const arena_allocator_t* alctr) {
 
         arena_allocator_assert_valid(alctr);
 
-        u32 size_free    = 0;
-        memory_t arena_memory;
-        arena_memory.size = alctr->arena_size;
-        arena_memory.ptr  = alctr->memory.ptr; 
-        for (
-            u32 arena = 0;
-            arena < alctr->arena_count;
-            ++arena) {
-            
-            const bool is_free = memory_is_os_reserved(arena_memory); 
-            if (is_free) {
-                size_free += arena_memory.size;
-            } 
-            arena_memory.addr += arena_memory.size;
-        }
-
+        const u32 size_free = (alctr->arena_size * alctr->free_count);
         assert(size_free <= (arena_allocator_get_size_total(alctr)));
         return(size_free);
     }
-    
+
     SLD_API_INLINE u32
     arena_allocator_get_size_used(
         const arena_allocator_t* alctr) {
 
         arena_allocator_assert_valid(alctr);
 
-        u32 size_used    = 0;
-        memory_t arena_memory;
-        arena_memory.size = alctr->arena_size;
-        arena_memory.ptr  = alctr->memory.ptr; 
-        for (
-            u32 arena = 0;
-                arena < alctr->arena_count;
-              ++arena) {
-            
-            const bool is_used = memory_is_os_committed(arena_memory); 
-            if (is_used) {
-                size_used += arena_memory.size;
-            } 
-            arena_memory.addr += arena_memory.size;
-        }
-
-
+        const u32 size_used = (alctr->arena_size * (alctr->arena_count - alctr->free_count));
         assert(size_used <= (arena_allocator_get_size_total(alctr)));
         return(size_used);
     }
-    
+
     SLD_API_INLINE u32
     arena_allocator_get_arenas_free(
         const arena_allocator_t* alctr) {
-        
-        const u32 free_size  = arena_allocator_get_size_free(alctr); 
-        const u32 free_count = free_size / alctr->arena_size;
+
+        arena_allocator_assert_valid(alctr);
+
+        const u32 free_count = alctr->free_count;
         assert(free_count <= alctr->arena_count);
         return(free_count);
     }
-    
+
     SLD_API_INLINE u32
     arena_allocator_get_arenas_used(
         const arena_allocator_t* alctr) {
 
-        const u32 used_size  = arena_allocator_get_size_free(alctr); 
-        const u32 used_count = used_size / alctr->arena_size;
+        arena_allocator_assert_valid(alctr);
+
+        const u32 used_count = (alctr->arena_count - alctr->free_count);
         assert(used_count <= alctr->arena_count);
         return(used_count);
     }
@@ -3,27 +3,48 @@
 
 #include "sld-memory.hpp"
 
+#ifndef    SLD_ARENA_SCRATCH_COUNT
+#   define SLD_ARENA_SCRATCH_COUNT             2
+#endif
+#ifndef    SLD_ARENA_SCRATCH_SIZE_RESERVE
+#   define SLD_ARENA_SCRATCH_SIZE_RESERVE      sld::size_gigabytes(8)
+#endif
+
 namespace sld {
 
     //-------------------------------------------------------------------
     // ARENA API
     //-------------------------------------------------------------------
 
+    // committed is the number of bytes past the header backed by the os.
+    // fixed arenas are committed up front, so committed == size and
+    // commit_chunk is 0. virtual arenas reserve the full size and commit
+    // commit_chunk bytes at a time as the position advances
     struct arena_t {
         u64 size;
         u64 position;
         u64 save;
+        u64 committed;
+        u64 commit_chunk;
+        u64 decommit_threshold;
     };
 
-    constexpr u32 ARENA_HEADER_SIZE = sizeof(arena_t);
+    constexpr u32 ARENA_HEADER_SIZE                = sizeof(arena_t);
+    constexpr u64 ARENA_COMMIT_CHUNK_DEFAULT       = size_kilobytes(64);
+    constexpr u64 ARENA_DECOMMIT_THRESHOLD_DEFAULT = size_megabytes(4);
+    constexpr u64 ARENA_DECOMMIT_THRESHOLD_NEVER   = 0;
 
+    SLD_API_INLINE          arena_t* arena_reserve_os_memory   (const u64       size_reserve, const u64 size_commit_chunk = ARENA_COMMIT_CHUNK_DEFAULT, const u64 decommit_threshold = ARENA_DECOMMIT_THRESHOLD_DEFAULT, const os_memory_page_policy_e page_policy = os_memory_page_policy_e_default);
+    SLD_API_INLINE          void     arena_release_os_memory   (arena_t*        arena);
     SLD_API_INLINE          bool     arena_is_valid            (const arena_t*  arena);
+    SLD_API_INLINE          bool     arena_is_virtual          (const arena_t*  arena);
     SLD_API_INLINE          void     arena_assert_valid        (const arena_t*  arena);
     SLD_API_INLINE          memory_t arena_to_memory           (const arena_t*  arena);
     SLD_API_INLINE          void*    arena_get_header          (const arena_t*  arena);
     SLD_API_INLINE          void*    arena_get_start           (const arena_t*  arena);
     SLD_API_INLINE          void*    arena_get_position        (const arena_t*  arena);
     SLD_API_INLINE          u64      arena_get_space_remaining (const arena_t*  arena);
+    SLD_API_INLINE          u64      arena_get_size_committed  (const arena_t*  arena);
     SLD_API_INLINE          bool     arena_can_push            (const arena_t*  arena, const u64 size, const u64 alignment = 0);
     SLD_API_INLINE          arena_t* arena_from_memory         (const memory_t& memory);
     SLD_API_INLINE          void     arena_reset               (arena_t*        arena);
@@ -32,6 +53,47 @@ namespace sld {
     SLD_API_INLINE          void*    arena_push_bytes          (arena_t*        arena, const u64 size, const u64 alignment = 0);
     SLD_API_INLINE_TEMPLATE type*    arena_push_struct         (arena_t*        arena, const u32 count = 1);
 
+    //-------------------------------------------------------------------
+    // ARENA SCOPE API
+    //-------------------------------------------------------------------
+
+    // a scope remembers where the arena was when it began and rolls it
+    // back when it ends. scopes live on the caller's stack, so they nest
+    // and don't touch the single save slot in the arena
+    struct arena_scope_t {
+        arena_t* arena;
+        u64      position;
+    };
+
+    SLD_API_INLINE          arena_scope_t arena_scope_begin           (arena_t*        arena);
+    SLD_API_INLINE          void          arena_scope_end             (arena_scope_t&  scope);
+
+    //-------------------------------------------------------------------
+    // ARENA SCRATCH API
+    //-------------------------------------------------------------------
+
+    // every thread gets its own set of virtual scratch arenas, reserved
+    // the first time the thread asks for one. pass the arenas you are
+    // already allocating into as conflicts and you get back a scope on
+    // a different arena, so scratch memory never stomps on your results.
+    // the pool releases its arenas when the thread exits, call
+    // arena_scratch_release_thread to give them back sooner
+    struct arena_scratch_pool_t {
+        arena_t* arenas[SLD_ARENA_SCRATCH_COUNT];
+        ~arena_scratch_pool_t();
+    };
+
+    inline thread_local arena_scratch_pool_t _arena_scratch_pool;
+
+    SLD_API_INLINE          arena_scope_t arena_scratch_begin         (arena_t* const* conflicts = NULL, const u32 conflict_count = 0);
+    SLD_API_INLINE          arena_scope_t arena_scratch_begin         (arena_t*        conflict);
+    SLD_API_INLINE          void          arena_scratch_end           (arena_scope_t&  scope);
+    SLD_API_INLINE          void          arena_scratch_release_thread(void);
+    SLD_INTERNAL_INLINE     void          arena_scratch_pool_release  (arena_scratch_pool_t& pool);
+
+    SLD_INTERNAL_INLINE     bool     arena_commit_to           (arena_t*        arena, const u64 position);
+    SLD_INTERNAL_INLINE     void     arena_decommit_tail       (arena_t*        arena);
+
     //-------------------------------------------------------------------
     // ARENA INLINE METHODS
     //-------------------------------------------------------------------
@@ -46,6 +108,63 @@ namespace sld {
         return(arena);
     }
 
+    SLD_API_INLINE arena_t*
+    arena_reserve_os_memory(
+        const u64                     size_reserve,
+        const u64                     size_commit_chunk,
+        const u64                     decommit_threshold,
+        const os_memory_page_policy_e page_policy) {
+
+        // check args
+        bool can_reserve = true;
+        can_reserve &= (size_reserve      >  ARENA_HEADER_SIZE);
+        can_reserve &= (size_commit_chunk != 0);
+        can_reserve &= (size_commit_chunk <  size_reserve);
+        assert(can_reserve);
+
+        // reserve the whole range, nothing is committed yet
+        memory_t memory;
+        memory.addr = 0;
+        memory.size = size_reserve;
+        const u64 page_size = memory_os_reserve(memory, page_policy);
+        if (page_size == 0) return(NULL);
+
+        // chunks have to be whole pages so commits never overlap, and a
+        // power of two because the commit and decommit ends align to them
+        u64 commit_chunk = size_round_up_pow2(os_memory_align_to_page(size_commit_chunk));
+        if (commit_chunk < page_size) commit_chunk = page_size;
+
+        // commit the first chunk to hold the header, rounding the
+        // chunk up may have taken it past the end of a small reservation
+        memory_t memory_first;
+        memory_first.addr = memory.addr;
+        memory_first.size = (commit_chunk < memory.size) ? commit_chunk : memory.size;
+        memory_os_commit(memory_first);
+
+        arena_t* arena            = arena_from_memory(memory);
+        arena->size               = (memory.size       - ARENA_HEADER_SIZE);
+        arena->position           = 0;
+        arena->save               = 0;
+        arena->committed          = (memory_first.size - ARENA_HEADER_SIZE);
+        arena->commit_chunk       = commit_chunk;
+        arena->decommit_threshold = decommit_threshold;
+        arena_assert_valid(arena);
+        return(arena);
+    }
+
+    SLD_API_INLINE void
+    arena_release_os_memory(
+        arena_t* arena) {
+
+        bool can_release = true;
+        can_release &= arena_is_valid   (arena);
+        can_release &= arena_is_virtual (arena);
+        assert(can_release);
+
+        memory_t memory = arena_to_memory(arena);
+        memory_os_release(memory);
+    }
+
     SLD_API_INLINE bool
     arena_is_valid(
         const arena_t* arena) {
@@ -56,10 +175,21 @@ namespace sld {
             is_valid &= (arena->size     != 0); 
             is_valid &= (arena->position <  arena->size); 
             is_valid &= (arena->save     <= arena->position); 
+            is_valid &= (arena->committed <= arena->size);
+            is_valid &= (arena->commit_chunk == 0 || size_is_pow_2(arena->commit_chunk));
         }
         return(is_valid);
     }
 
+    SLD_API_INLINE bool
+    arena_is_virtual(
+        const arena_t* arena) {
+
+        arena_assert_valid(arena);
+        const bool is_virtual = (arena->commit_chunk != 0);
+        return(is_virtual);
+    }
+
     SLD_API_INLINE void
     arena_assert_valid(
         const arena_t* arena) {
@@ -86,6 +216,14 @@ namespace sld {
         return(space_remaining);
     }
 
+    SLD_API_INLINE u64
+    arena_get_size_committed(
+        const arena_t* arena) {
+
+        arena_assert_valid(arena);
+        return(arena->committed);
+    }
+
     SLD_API_INLINE bool
     arena_can_push(
         const arena_t* arena,
@@ -143,6 +281,7 @@ namespace sld {
         arena_assert_valid(arena);
         arena->position = 0;
         arena->save     = 0;
+        arena_decommit_tail(arena);
     }
 
     SLD_API_INLINE void
@@ -159,6 +298,7 @@ namespace sld {
 
         arena_assert_valid(arena);
         arena->position = arena->save;
+        arena_decommit_tail(arena);
     }
 
     SLD_API_INLINE void*
@@ -174,7 +314,7 @@ namespace sld {
         const u64 new_position    = arena->position + size_aligned;
         
         void* ptr = NULL;
-        if (new_position <= arena->size) {
+        if (new_position <= arena->size && arena_commit_to(arena, new_position)) {
 
             ptr = arena_get_position(arena);
             assert(ptr);
@@ -204,6 +344,182 @@ namespace sld {
         return(ptr);
     }
 
+    //-------------------------------------------------------------------
+    // ARENA SCOPE INLINE METHODS
+    //-------------------------------------------------------------------
+
+    SLD_API_INLINE arena_scope_t
+    arena_scope_begin(
+        arena_t* arena) {
+
+        arena_assert_valid(arena);
+
+        arena_scope_t scope;
+        scope.arena    = arena;
+        scope.position = arena->position;
+        return(scope);
+    }
+
+    SLD_API_INLINE void
+    arena_scope_end(
+        arena_scope_t& scope) {
+
+        arena_t* arena = scope.arena;
+        arena_assert_valid(arena);
+
+        // scopes have to end in the reverse order they began
+        bool can_end = true;
+        can_end &= (scope.position <= arena->position);
+        can_end &= (arena->save    <= scope.position);
+        assert(can_end);
+
+        arena->position = scope.position;
+        arena_decommit_tail(arena);
+        scope.arena = NULL;
+    }
+
+    //-------------------------------------------------------------------
+    // ARENA SCRATCH INLINE METHODS
+    //-------------------------------------------------------------------
+
+    SLD_API_INLINE arena_scope_t
+    arena_scratch_begin(
+        arena_t* const* conflicts,
+        const u32       conflict_count) {
+
+        assert(conflicts != NULL || conflict_count == 0);
+
+        arena_scratch_pool_t& pool    = _arena_scratch_pool;
+        arena_t*              scratch = NULL;
+
+        for (
+            u32 scratch_index = 0;
+                scratch_index < SLD_ARENA_SCRATCH_COUNT && scratch == NULL;
+              ++scratch_index) {
+
+            // reserve the arena the first time this thread needs it
+            arena_t* candidate = pool.arenas[scratch_index];
+            if (candidate == NULL) {
+                candidate = arena_reserve_os_memory(SLD_ARENA_SCRATCH_SIZE_RESERVE);
+                pool.arenas[scratch_index] = candidate;
+            }
+
+            bool is_conflict = false;
+            for (
+                u32 conflict_index = 0;
+                    conflict_index < conflict_count;
+                  ++conflict_index) {
+
+                is_conflict |= (conflicts[conflict_index] == candidate);
+            }
+            if (!is_conflict) scratch = candidate;
+        }
+
+        // more conflicts than scratch arenas, raise SLD_ARENA_SCRATCH_COUNT
+        assert(scratch != NULL);
+
+        arena_scope_t scope = arena_scope_begin(scratch);
+        return(scope);
+    }
+
+    SLD_API_INLINE arena_scope_t
+    arena_scratch_begin(
+        arena_t* conflict) {
+
+        arena_scope_t scope = arena_scratch_begin(&conflict, 1);
+        return(scope);
+    }
+
+    SLD_API_INLINE void
+    arena_scratch_end(
+        arena_scope_t& scope) {
+
+        arena_scope_end(scope);
+    }
+
+    SLD_API_INLINE void
+    arena_scratch_release_thread(
+        void) {
+
+        arena_scratch_pool_release(_arena_scratch_pool);
+    }
+
+    SLD_INTERNAL_INLINE void
+    arena_scratch_pool_release(
+        arena_scratch_pool_t& pool) {
+
+        for (
+            u32 scratch_index = 0;
+                scratch_index < SLD_ARENA_SCRATCH_COUNT;
+              ++scratch_index) {
+
+            arena_t* scratch = pool.arenas[scratch_index];
+            if (scratch != NULL) {
+                arena_release_os_memory(scratch);
+                pool.arenas[scratch_index] = NULL;
+            }
+        }
+    }
+
+    SLD_INLINE
+    arena_scratch_pool_t::~arena_scratch_pool_t(
+        void) {
+
+        // runs at thread exit, a thread that never asked for
+        // scratch memory has nothing reserved and nothing to do
+        arena_scratch_pool_release(*this);
+    }
+
+    //-------------------------------------------------------------------
+    // ARENA INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_INTERNAL_INLINE bool
+    arena_commit_to(
+        arena_t*  arena,
+        const u64 position) {
+
+        // fixed arenas are always fully committed
+        if (position <= arena->committed) return(true);
+        if (arena->commit_chunk == 0)      return(false);
+
+        // commit whole chunks up to the position, offsets are from the
+        // header so they stay page aligned
+        const u64 committed_end = (ARENA_HEADER_SIZE + arena->committed);
+        u64       required_end  = size_align_pow_2((ARENA_HEADER_SIZE + position), arena->commit_chunk);
+        const u64 reserved_end  = (ARENA_HEADER_SIZE + arena->size);
+        if (required_end > reserved_end) required_end = reserved_end;
+
+        memory_t memory_commit;
+        memory_commit.addr = ((addr)arena + committed_end);
+        memory_commit.size = (required_end - committed_end);
+        memory_os_commit(memory_commit);
+
+        arena->committed = ((committed_end + memory_commit.size) - ARENA_HEADER_SIZE);
+        return(position <= arena->committed);
+    }
+
+    SLD_INTERNAL_INLINE void
+    arena_decommit_tail(
+        arena_t* arena) {
+
+        const bool can_decommit = (arena->commit_chunk != 0 && arena->decommit_threshold != ARENA_DECOMMIT_THRESHOLD_NEVER);
+        if (!can_decommit) return;
+
+        // keep the chunk holding the position plus a threshold of slack,
+        // so an arena that is reset every frame doesn't churn commits
+        const u64 committed_end = (ARENA_HEADER_SIZE + arena->committed);
+        const u64 used_end      = size_align_pow_2((ARENA_HEADER_SIZE + arena->position), arena->commit_chunk);
+        const u64 keep_end      = size_align_pow_2((used_end + arena->decommit_threshold),  arena->commit_chunk);
+        if (committed_end <= keep_end) return;
+
+        memory_t memory_decommit;
+        memory_decommit.addr = ((addr)arena + keep_end);
+        memory_decommit.size = (committed_end - keep_end);
+        memory_os_decommit(memory_decommit);
+
+        arena->committed = (keep_end - ARENA_HEADER_SIZE);
+    }
 };
 
 #endif //SLD_ARENA_HPP
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef SLD_BLOCK_ALLOCATOR_HPP
 #define SLD_BLOCK_ALLOCATOR_HPP
 
+#include <atomic>
 #include "sld-memory.hpp"
 
 namespace sld {
@@ -9,20 +10,42 @@ namespace sld {
     // API
     //-------------------------------------------------------------------
 
+    // the slot table lives in its own committed reservation, since
+    // free blocks are decommitted and can't hold an intrusive list.
+    // free_next links the free block indices, used_bits has one bit
+    // per block so we can catch double frees without asking the os.
+    //
+    // commit and decommit are lock free. free_head packs the head index
+    // in the low 32 bits and a tag in the high 32 bits that changes on
+    // every push and pop, so a thread that read a stale head and next
+    // index can't swap them back in after other threads reused the slot
     struct block_allocator_t {
-        memory_t memory;
-        u32      block_size;
-        u32      block_count;
+        memory_t               memory;
+        memory_t               slots;
+        u32                    block_size;
+        u32                    block_count;
+        u32                    page_size;
+        std::atomic<u32>*      free_next;
+        std::atomic<u64>*      used_bits;
+        alignas(64)
+        std::atomic<u64>       free_head;
+        std::atomic<u32>       free_count;
     };
 
-    SLD_API_INLINE void     block_allocator_reserve_os_memory (block_allocator_t* alctr, const u32 size_total, const u32 size_block);
+    constexpr u32 BLOCK_ALLOCATOR_INDEX_INVALID = 0xFFFFFFFF;
+    constexpr u64 BLOCK_ALLOCATOR_TAG_INCREMENT = ((u64)1 << 32);
+
+    SLD_API_INLINE bool     block_allocator_reserve_os_memory (block_allocator_t* alctr, const u32 size_total, const u32 size_block, const os_memory_page_policy_e page_policy = os_memory_page_policy_e_default);
     SLD_API_INLINE void     block_allocator_release_os_memory (block_allocator_t* alctr);
     SLD_API_INLINE bool     block_allocator_is_valid          (const block_allocator_t* alctr);
     SLD_API_INLINE bool     block_allocator_is_block_valid    (const block_allocator_t* alctr, const memory_t& block);
+    SLD_API_INLINE bool     block_allocator_is_block_used     (const block_allocator_t* alctr, const u32 block_index);
     SLD_API_INLINE void     block_allocator_assert_valid      (const block_allocator_t* alctr);
-    SLD_API_INLINE void*    block_allocator_commit            (const block_allocator_t* alctr);
-    SLD_API_INLINE memory_t block_allocator_commit_memory     (const block_allocator_t* alctr);
-    SLD_API_INLINE void     block_allocator_decommit          (const block_allocator_t* alctr, void* block);
+    SLD_API_INLINE u32      block_allocator_get_block_index   (const block_allocator_t* alctr, const void* block);
+    SLD_API_INLINE void*    block_allocator_commit            (block_allocator_t* alctr);
+    SLD_API_INLINE memory_t block_allocator_commit_memory     (block_allocator_t* alctr);
+    SLD_API_INLINE void     block_allocator_decommit          (block_allocator_t* alctr, void* block);
+    SLD_API_INLINE void     block_allocator_free              (block_allocator_t* alctr, void* block);
     SLD_API_INLINE u32      block_allocator_get_size_total    (const block_allocator_t* alctr);
     SLD_API_INLINE u32      block_allocator_get_size_free     (const block_allocator_t* alctr);
     SLD_API_INLINE u32      block_allocator_get_size_used     (const block_allocator_t* alctr);
@@ -33,11 +56,12 @@ namespace sld {
     // API
     //-------------------------------------------------------------------
 
-    SLD_API_INLINE void 
+    SLD_API_INLINE bool
     block_allocator_reserve_os_memory(
-        block_allocator_t* alctr,
-        const u32          size_total,
-        const u32          size_block) {
+        block_allocator_t*            alctr,
+        const u32                     size_total,
+        const u32                     size_block,
+        const os_memory_page_policy_e page_policy) {
 
         // check args
         bool can_acquire = true;
@@ -46,21 +70,59 @@ namespace sld {
         can_acquire &= (size_block <  size_total);
         assert(can_acquire);
 
-        // calculate the aligned sizes
-        const u32 size_block_aligned = os_memory_align_to_page (size_block);
-        const u32 size_total_aligned = size_align_pow_2        (size_total, size_block_aligned);
+        // calculate the aligned sizes, with huge pages every block
+        // has to start and end on a page of the size we asked for
+        const u32 size_page          = os_memory_page_policy_size (page_policy);
+        const u32 size_block_aligned = size_align_pow_2           (os_memory_align_to_page(size_block), size_page);
+        const u32 size_total_aligned = size_align_pow_2           (size_total, size_block_aligned);
 
         // reserve memory
         memory_t memory;
         memory.addr = 0;
         memory.size = size_total_aligned;
-        memory_os_reserve(memory);
+        const u32 page_size   = memory_os_reserve(memory, page_policy);
+        if (page_size == 0) return(false);
+        const u32 block_count = memory.size / size_block_aligned;
+
+        // reserve and commit the slot table
+        const u32 size_free_next = (block_count * sizeof(std::atomic<u32>));
+        const u32 size_used_bits = ((block_count + 63) / 64) * sizeof(std::atomic<u64>);
+        memory_t slots;
+        slots.addr = 0;
+        slots.size = (size_free_next + size_used_bits);
+        if (memory_os_reserve(slots) == 0) {
+            memory_os_release(memory);
+            return(false);
+        }
+        memory_os_commit(slots);
 
         // initialize the allocator
         alctr->memory      = memory;
+        alctr->slots       = slots;
+        alctr->page_size   = page_size;
         alctr->block_size  = size_block_aligned;
-        alctr->block_count = alctr->memory.size / size_block_aligned;
+        alctr->block_count = block_count;
+        alctr->free_next   = (std::atomic<u32>*)(slots.addr);
+        alctr->used_bits   = (std::atomic<u64>*)(slots.addr + size_free_next);
+        alctr->free_count.store (block_count, std::memory_order_relaxed);
+        alctr->free_head.store  (0,           std::memory_order_relaxed);
+
+        // every block starts out free, linked in address order
+        for (
+            u32 block_index = 0;
+                block_index < block_count;
+              ++block_index) {
+
+            const u32 next_index = ((block_index + 1) < block_count)
+                ? (block_index + 1)
+                : BLOCK_ALLOCATOR_INDEX_INVALID;
+            alctr->free_next[block_index].store(next_index, std::memory_order_relaxed);
+        }
+        memset((void*)alctr->used_bits, 0, size_used_bits);
+        std::atomic_thread_fence(std::memory_order_release);
+
         block_allocator_assert_valid(alctr);
+        return(true);
     }
 
     SLD_API_INLINE void
@@ -69,10 +131,17 @@ namespace sld {
 
         block_allocator_assert_valid(alctr);
         memory_os_release(alctr->memory);
+        memory_os_release(alctr->slots);
         alctr->memory.addr = 0;
         alctr->memory.size = 0;
+        alctr->slots.addr  = 0;
+        alctr->slots.size  = 0;
         alctr->block_count = 0;
         alctr->block_size  = 0;
+        alctr->free_next   = NULL;
+        alctr->used_bits   = NULL;
+        alctr->free_count.store (0,                             std::memory_order_relaxed);
+        alctr->free_head.store  (BLOCK_ALLOCATOR_INDEX_INVALID, std::memory_order_relaxed);
     }
 
     SLD_API_INLINE bool
@@ -82,14 +151,13 @@ namespace sld {
         bool is_valid = (alctr != NULL);
         if (is_valid) {
 
-            const bool is_reserved  = os_memory_is_reserved  (alctr->memory.ptr);
-            const bool is_committed = os_memory_is_committed (alctr->memory.ptr);
-
-            is_valid &= (is_reserved || is_committed);
-            is_valid &= (alctr->memory.addr != 0);  
-            is_valid &= (alctr->block_count != 0);  
+            is_valid &= (alctr->memory.addr != 0);
+            is_valid &= (alctr->block_count != 0);
             is_valid &= (alctr->block_size  != 0);
-            is_valid &= size_is_pow_2(alctr->block_size); 
+            is_valid &= (alctr->free_count.load(std::memory_order_relaxed) <= alctr->block_count);
+            is_valid &= (alctr->free_next   != NULL);
+            is_valid &= (alctr->used_bits   != NULL);
+            is_valid &= size_is_pow_2(alctr->block_size);
         }
         return(is_valid);
     }
@@ -106,15 +174,26 @@ namespace sld {
         if (is_valid) {
 
             // make sure this block is managed by the allocator;
-            const addr last_block_addr = (alctr->memory.addr + alctr->memory.size) - alctr->block_size; 
-            const u32  block_offset    = (block_memory.addr  - alctr->memory.addr);
-            is_valid &= (block_memory.addr < last_block_addr); 
+            const addr last_block_addr = (alctr->memory.addr + alctr->memory.size) - alctr->block_size;
+            const u64  block_offset    = (block_memory.addr  - alctr->memory.addr);
+            is_valid &= (block_memory.addr >= alctr->memory.addr);
+            is_valid &= (block_memory.addr <= last_block_addr);
             is_valid &= ((block_offset % alctr->block_size) == 0);
         }
 
         return(is_valid);
     }
 
+    SLD_API_INLINE bool
+    block_allocator_is_block_used(
+        const block_allocator_t* alctr,
+        const u32                block_index) {
+
+        const u64  used_word = alctr->used_bits[block_index / 64].load(std::memory_order_acquire);
+        const bool is_used   = ((used_word >> (block_index % 64)) & 1);
+        return(is_used);
+    }
+
     SLD_API_INLINE void
     block_allocator_assert_valid(
         const block_allocator_t* alctr) {
@@ -122,47 +201,71 @@ namespace sld {
         assert(block_allocator_is_valid(alctr));
     }
 
+    SLD_API_INLINE u32
+    block_allocator_get_block_index(
+        const block_allocator_t* alctr,
+        const void*              block) {
+
+        const u64 block_offset = ((addr)block - alctr->memory.addr);
+        const u32 block_index  = (u32)(block_offset / alctr->block_size);
+        return(block_index);
+    }
+
     SLD_API_INLINE void*
     block_allocator_commit(
-        const block_allocator_t* alctr) {
+        block_allocator_t* alctr) {
 
         block_allocator_assert_valid(alctr);
 
+        // pop the next free block, the next index we read may be stale
+        // if another thread popped this block first, but then the tag
+        // changed and the swap fails
+        u64 head = alctr->free_head.load(std::memory_order_acquire);
+        u32 block_index;
+        for (;;) {
+
+            block_index = (u32)(head & 0xFFFFFFFF);
+            if (block_index == BLOCK_ALLOCATOR_INDEX_INVALID) return(NULL);
+
+            const u32 next_index = alctr->free_next[block_index].load(std::memory_order_relaxed);
+            const u64 next_head  = ((head & ~(u64)0xFFFFFFFF) + BLOCK_ALLOCATOR_TAG_INCREMENT) | next_index;
+            const bool did_pop   = alctr->free_head.compare_exchange_weak(
+                head, next_head,
+                std::memory_order_acquire,
+                std::memory_order_acquire);
+            if (did_pop) break;
+        }
+
+        // only counted out once it's off the list, the
+        // free count can run ahead of the list but never behind it
+        alctr->free_count.fetch_sub(1, std::memory_order_relaxed);
+
+        const u64 used_mask = ((u64)1 << (block_index % 64));
+        const u64 used_word = alctr->used_bits[block_index / 64].fetch_or(used_mask, std::memory_order_acq_rel);
+        assert((used_word & used_mask) == 0);
+
         memory_t block_memory;
         block_memory.size = alctr->block_size;
-        block_memory.addr = alctr->memory.addr;
+        block_memory.addr = alctr->memory.addr + ((u64)block_index * alctr->block_size);
+        memory_os_commit(block_memory);
 
-        for (
-            u32 block = 0;
-                block < alctr->block_count;
-              ++block) {
-
-            const bool is_free = memory_is_os_reserved(block_memory);
-            if (is_free) {
-                memory_os_commit(block_memory);
-                return(block_memory.ptr);
-            }
-            block_memory.addr += alctr->block_size;
-        }
-
-        return(NULL);
+        return(block_memory.ptr);
     }
-    
+
     SLD_API_INLINE memory_t
     block_allocator_commit_memory(
-        const block_allocator_t* alctr) {
-        
+        block_allocator_t* alctr) {
+
         memory_t memory;
         memory.ptr  = block_allocator_commit(alctr);
         memory.size = alctr->block_size;
         return(memory);
     }
 
-
     SLD_API_INLINE void
-    block_allocator_free(
-        const block_allocator_t* alctr,
-        void*                    block) {
+    block_allocator_decommit(
+        block_allocator_t* alctr,
+        void*              block) {
 
         bool can_free = true;
         can_free &= block_allocator_is_valid(alctr);
@@ -173,13 +276,48 @@ namespace sld {
         memory_t block_memory;
         block_memory.ptr  = block;
         block_memory.size = alctr->block_size;
-        can_free &= block_allocator_is_block_valid(alctr, block_memory); 
+        can_free &= block_allocator_is_block_valid(alctr, block_memory);
+        assert(can_free);
+
+        // make sure it isn't already free, clearing the bit first means
+        // only one of two racing frees gets past this
+        const u32 block_index = block_allocator_get_block_index(alctr, block);
+        const u64 used_mask   = ((u64)1 << (block_index % 64));
+        const u64 used_word   = alctr->used_bits[block_index / 64].fetch_and(~used_mask, std::memory_order_acq_rel);
+        can_free &= ((used_word & used_mask) != 0);
         assert(can_free);
+        if (!can_free) return;
 
-        // free the block
+        // free the block before it's visible, once it's on the list
+        // another thread can commit it again
         memory_os_decommit(block_memory);
+
+        // count it before it's visible, a thread that pops it right away
+        // takes the count back down and can't take it below zero
+        alctr->free_count.fetch_add(1, std::memory_order_relaxed);
+
+        // push it back on the free list
+        u64 head = alctr->free_head.load(std::memory_order_relaxed);
+        for (;;) {
+
+            alctr->free_next[block_index].store((u32)(head & 0xFFFFFFFF), std::memory_order_relaxed);
+            const u64  next_head = ((head & ~(u64)0xFFFFFFFF) + BLOCK_ALLOCATOR_TAG_INCREMENT) | block_index;
+            const bool did_push  = alctr->free_head.compare_exchange_weak(
+                head, next_head,
+                std::memory_order_release,
+                std::memory_order_relaxed);
+            if (did_push) break;
+        }
     }
-    
+
+    SLD_API_INLINE void
+    block_allocator_free(
+        block_allocator_t* alctr,
+        void*              block) {
+
+        block_allocator_decommit(alctr, block);
+    }
+
     SLD_API_INLINE u32
     block_allocator_get_size_total(
         const block_allocator_t* alctr) {
@@ -189,76 +327,47 @@ namespace sld {
         const u32 size_total = (alctr->block_size * alctr->block_count);
         return(size_total);
     }
-    
+
     SLD_API_INLINE u32
     block_allocator_get_size_free(
         const block_allocator_t* alctr) {
 
         block_allocator_assert_valid(alctr);
 
-        u32 size_free    = 0;
-        memory_t block_memory;
-        block_memory.size = alctr->block_size;
-        block_memory.ptr  = alctr->memory.ptr; 
-        for (
-            u32 block = 0;
-            block < alctr->block_count;
-            ++block) {
-            
-            const bool is_free = memory_is_os_reserved(block_memory); 
-            if (is_free) {
-                size_free += block_memory.size;
-            } 
-            block_memory.addr += block_memory.size;
-        }
-
+        const u32 size_free = (alctr->block_size * alctr->free_count.load(std::memory_order_relaxed));
         assert(size_free <= (block_allocator_get_size_total(alctr)));
         return(size_free);
     }
-    
+
     SLD_API_INLINE u32
     block_allocator_get_size_used(
         const block_allocator_t* alctr) {
 
         block_allocator_assert_valid(alctr);
 
-        u32 size_used    = 0;
-        memory_t block_memory;
-        block_memory.size = alctr->block_size;
-        block_memory.ptr  = alctr->memory.ptr; 
-        for (
-            u32 block = 0;
-                block < alctr->block_count;
-              ++block) {
-            
-            const bool is_used = memory_is_os_committed(block_memory); 
-            if (is_used) {
-                size_used += block_memory.size;
-            } 
-            block_memory.addr += block_memory.size;
-        }
-
-
+        const u32 size_used = (alctr->block_size * (alctr->block_count - alctr->free_count.load(std::memory_order_relaxed)));
         assert(size_used <= (block_allocator_get_size_total(alctr)));
         return(size_used);
     }
-    
+
     SLD_API_INLINE u32
     block_allocator_get_blocks_free(
         const block_allocator_t* alctr) {
-        
-        const u32 free_size  = block_allocator_get_size_free(alctr); 
-        const u32 free_count = free_size / alctr->block_size;
+
+        block_allocator_assert_valid(alctr);
+
+        const u32 free_count = alctr->free_count.load(std::memory_order_relaxed);
         assert(free_count <= alctr->block_count);
         return(free_count);
     }
-    
+
     SLD_API_INLINE u32
     block_allocator_get_blocks_used(
         const block_allocator_t* alctr) {
 
-        const u32 used_size  = block_allocator_get_size_free(alctr); 
-        const u32 used_count = used_size / alctr->block_size;
+        block_allocator_assert_valid(alctr);
+
+        const u32 used_count = (alctr->block_count - alctr->free_count.load(std::memory_order_relaxed));
         assert(used_count <= alctr->block_count);
         return(used_count);
     }
@@ -25,6 +25,7 @@ namespace sld {
     SLD_API_INLINE void      buffer_zero              (buffer_t* buffer);
     SLD_API_INLINE u32       buffer_append            (buffer_t* buffer, const byte* src_data, const u32 src_length);
     SLD_API_INLINE u32       buffer_copy              (buffer_t* buffer, const byte* src_data, const u32 src_length);  
+    SLD_API_INLINE u32       buffer_consume           (buffer_t* buffer, const u32 length);
 
     //-------------------------------------------------------------------
     // INLINE METHODS
@@ -158,6 +159,25 @@ namespace sld {
 
         return(buffer->length);
     }
+
+    // drops the first length bytes and moves the rest to the front, so a
+    // stream can keep what it hasn't used and append more behind it
+    SLD_API_INLINE u32
+    buffer_consume(
+        buffer_t* buffer,
+        const u32 length) {
+
+        buffer_assert_valid(buffer);
+
+        const u32 bytes_consumed  = (length < buffer->length) ? length : buffer->length;
+        const u32 bytes_remaining = (buffer->length - bytes_consumed);
+        if (bytes_remaining != 0) {
+            (void)memmove(buffer->data, &buffer->data[bytes_consumed], bytes_remaining);
+        }
+        buffer->length = bytes_remaining;
+
+        return(bytes_consumed);
+    }
 };
 
 #endif //SLD_BUFFER_HPP
\ No newline at end of file
@@ -0,0 +1,87 @@
+#ifndef SLD_CHUNK_STORE_HPP
+#define SLD_CHUNK_STORE_HPP
+
+#include "sld.hpp"
+#include "sld-hash.hpp"
+#include "sld-buffer.hpp"
+#include "sld-arena.hpp"
+#include "sld-arena-allocator.hpp"
+#include "sld-hash-table.hpp"
+
+namespace sld {
+
+    struct chunk_params_t;
+    struct chunk_t;
+    struct chunk_store_t;
+    struct chunk_store_entry_t;
+
+    SLD_API bool        chunk_params_init              (chunk_params_t&      params, const u32 size_avg);
+    SLD_API bool        chunk_params_is_valid          (const chunk_params_t& params);
+    SLD_API u32         chunk_find_cut                 (const chunk_params_t& params, const byte* data, const u32 length, const bool is_end);
+    SLD_API u32         chunk_buffer                   (const chunk_params_t& params, const buffer_t* buffer, const bool is_end, chunk_t* chunks, const u32 chunk_max);
+    SLD_API bool        chunk_store_reserve_os_memory  (chunk_store_t&       store,  const u32 chunk_max, const u64 size_data);
+    SLD_API void        chunk_store_release_os_memory  (chunk_store_t&       store);
+    SLD_API bool        chunk_store_is_valid           (const chunk_store_t& store);
+    SLD_API u32         chunk_store_add                (chunk_store_t&       store,  const byte* data, const u32 length);
+    SLD_API u32         chunk_store_add_hash           (chunk_store_t&       store,  const byte* data, const u32 length, const hash128_t& hash);
+    SLD_API u32         chunk_store_add_buffer         (chunk_store_t&       store,  const chunk_params_t& params, buffer_t* buffer, const bool is_end, u32* ids, const u32 id_max);
+    SLD_API u32         chunk_store_find               (const chunk_store_t& store,  const hash128_t& hash);
+    SLD_API u32         chunk_store_get_count          (const chunk_store_t& store);
+    SLD_API const byte* chunk_store_get_data           (const chunk_store_t& store,  const u32 id);
+    SLD_API u32         chunk_store_get_length         (const chunk_store_t& store,  const u32 id);
+    SLD_API bool        chunk_store_get_hash           (const chunk_store_t& store,  const u32 id, hash128_t& hash);
+
+    // content defined chunking in the style of fastcdc. a gear hash rolls
+    // over the data one byte at a time and a chunk ends where its high bits
+    // are all zero, so a cut depends only on the bytes just before it and
+    // an edit moves the cuts around it, not every cut after it. the first
+    // size_min bytes of a chunk are never tested. up to size_avg the mask
+    // is harder to hit and after it easier, which pulls chunk sizes in
+    // toward the average. a chunk never goes past size_max
+    struct chunk_params_t {
+        u32 size_min;
+        u32 size_avg;
+        u32 size_max;
+        u64 mask_small;
+        u64 mask_large;
+    };
+
+    struct chunk_t {
+        hash128_t hash;
+        u32       offset;
+        u32       length;
+    };
+
+    // every distinct chunk is stored once and named by a u32 id, chunks
+    // are identified by their hash128 the same way hash_table_t identifies
+    // keys. the bytes live in a virtual arena and never move, the id
+    // indexes an entry that points at them. adding a chunk the store
+    // already holds only counts it in size_added, so size_added against
+    // size_stored is how much the store saved. not thread safe
+    struct chunk_store_entry_t {
+        hash128_t   hash;
+        const byte* data;
+        u32         length;
+    };
+
+    struct chunk_store_t {
+        arena_t*          data;
+        arena_t*          entries;
+        arena_allocator_t table_allocator;
+        hash_table_t      table;
+        u32               count;
+        u32               chunk_max;
+        u64               size_stored;
+        u64               size_added;
+    };
+
+    constexpr u32 CHUNK_SIZE_AVG_DEFAULT         = size_kilobytes(8);
+    constexpr u32 CHUNK_SIZE_AVG_MIN             = 64;
+    constexpr u32 CHUNK_SIZE_AVG_MAX             = size_megabytes(16);
+    constexpr u32 CHUNK_NORMALIZATION            = 2;
+    constexpr u32 CHUNK_BATCH_SIZE               = 64;
+    constexpr u32 CHUNK_STORE_ID_INVALID         = 0xFFFFFFFF;
+    constexpr u32 CHUNK_STORE_TABLE_CAPACITY_MIN = 256;
+};
+
+#endif //SLD_CHUNK_STORE_HPP
\ No newline at end of file
@@ -0,0 +1,57 @@
+#ifndef SLD_CONCURRENT_HASH_TABLE_HPP
+#define SLD_CONCURRENT_HASH_TABLE_HPP
+
+#include <atomic>
+#include "sld.hpp"
+#include "sld-hash-table.hpp"
+#include "sld-spin-lock.hpp"
+#include "sld-epoch.hpp"
+
+namespace sld {
+
+    struct concurrent_hash_table_t;
+    struct concurrent_hash_table_shard_t;
+    struct concurrent_hash_table_array_t;
+
+    SLD_API bool concurrent_hash_table_init        (concurrent_hash_table_t&       table, epoch_domain_t* epoch, const u32 stride, const u32 capacity);
+    SLD_API void concurrent_hash_table_release     (concurrent_hash_table_t&       table);
+    SLD_API bool concurrent_hash_table_search      (const concurrent_hash_table_t& table, const u32 participant, const hash_table_key_t& key,  byte* value);
+    SLD_API bool concurrent_hash_table_search_hash (const concurrent_hash_table_t& table, const u32 participant, const hash128_t&        hash, byte* value);
+    SLD_API bool concurrent_hash_table_insert      (concurrent_hash_table_t&       table, const hash_table_key_t& key,  const byte* value);
+    SLD_API bool concurrent_hash_table_insert_hash (concurrent_hash_table_t&       table, const hash128_t&        hash, const byte* value);
+    SLD_API bool concurrent_hash_table_remove      (concurrent_hash_table_t&       table, const hash_table_key_t& key);
+    SLD_API bool concurrent_hash_table_remove_hash (concurrent_hash_table_t&       table, const hash128_t&        hash);
+    SLD_API u32  concurrent_hash_table_get_count   (const concurrent_hash_table_t& table);
+
+    // a hash_table_t split into shards by the top bits of the hash, for
+    // tables that every worker reads and few of them write.
+    // readers take no locks. each shard has a sequence that is odd while
+    // a writer is inside it, a reader copies the value out and retries if
+    // the sequence moved underneath it. writers serialize per shard on a
+    // spin lock. when a shard fills, the writer builds a bigger array off
+    // to the side, swaps the pointer and retires the old array to the
+    // epoch domain, so readers still probing it never see it freed.
+    // readers pass the participant they registered with the domain
+    struct concurrent_hash_table_array_t {
+        memory_t     memory;
+        hash_table_t table;
+    };
+
+    struct alignas(64) concurrent_hash_table_shard_t {
+        std::atomic<u32>                            sequence;
+        std::atomic<u32>                            count;
+        spin_lock_t                                 lock;
+        std::atomic<concurrent_hash_table_array_t*> array;
+    };
+
+    constexpr u32 CONCURRENT_HASH_TABLE_SHARD_COUNT_LOG2 = 6;
+    constexpr u32 CONCURRENT_HASH_TABLE_SHARD_COUNT      = (1 << CONCURRENT_HASH_TABLE_SHARD_COUNT_LOG2);
+
+    struct concurrent_hash_table_t {
+        epoch_domain_t*               epoch;
+        u32                           stride;
+        concurrent_hash_table_shard_t shards[CONCURRENT_HASH_TABLE_SHARD_COUNT];
+    };
+};
+
+#endif //SLD_CONCURRENT_HASH_TABLE_HPP
\ No newline at end of file
@@ -0,0 +1,251 @@
+#ifndef SLD_EPOCH_HPP
+#define SLD_EPOCH_HPP
+
+#include <atomic>
+#include "sld.hpp"
+#include "sld-spin-lock.hpp"
+
+#ifndef    SLD_EPOCH_PARTICIPANT_MAX
+#   define SLD_EPOCH_PARTICIPANT_MAX 64
+#endif
+#ifndef    SLD_EPOCH_RETIRE_MAX
+#   define SLD_EPOCH_RETIRE_MAX      256
+#endif
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // API
+    //-------------------------------------------------------------------
+
+    // epoch based reclamation for memory that lock free readers may still
+    // be looking at. readers enter the domain before touching shared data
+    // and exit when they are done. a writer that unlinks something retires
+    // it instead of freeing it, and it is only freed once every reader
+    // that could have seen it has exited. the global epoch can only move
+    // forward when every active reader has caught up to it, so anything
+    // retired two epochs back is unreachable.
+    // a participant is one thread. it must not retire while it is inside
+    // the domain, retiring can wait on readers to leave
+    typedef void (*epoch_free_f)(void* data);
+
+    struct epoch_retired_t {
+        void*        data;
+        epoch_free_f free;
+        u64          epoch;
+    };
+
+    struct alignas(64) epoch_participant_t {
+        std::atomic<u64> epoch;
+        std::atomic<u32> used;
+    };
+
+    struct epoch_domain_t {
+        alignas(64) std::atomic<u64> global;
+        spin_lock_t                  retire_lock;
+        u32                          retire_count;
+        epoch_retired_t              retired      [SLD_EPOCH_RETIRE_MAX];
+        epoch_participant_t          participants [SLD_EPOCH_PARTICIPANT_MAX];
+    };
+
+    constexpr u32 EPOCH_PARTICIPANT_INVALID = 0xFFFFFFFF;
+    constexpr u64 EPOCH_INACTIVE            = 0;
+
+    SLD_API_INLINE void epoch_domain_init      (epoch_domain_t& domain);
+    SLD_API_INLINE void epoch_domain_release   (epoch_domain_t& domain);
+    SLD_API_INLINE u32  epoch_register         (epoch_domain_t& domain);
+    SLD_API_INLINE void epoch_unregister       (epoch_domain_t& domain, const u32 participant);
+    SLD_API_INLINE void epoch_enter            (epoch_domain_t& domain, const u32 participant);
+    SLD_API_INLINE void epoch_exit             (epoch_domain_t& domain, const u32 participant);
+    SLD_API_INLINE void epoch_retire           (epoch_domain_t& domain, void* data, const epoch_free_f free);
+    SLD_API_INLINE u32  epoch_reclaim          (epoch_domain_t& domain);
+
+    SLD_INTERNAL_INLINE bool epoch_try_advance  (epoch_domain_t& domain);
+    SLD_INTERNAL_INLINE u32  epoch_free_retired (epoch_domain_t& domain);
+
+    //-------------------------------------------------------------------
+    // INLINE METHODS
+    //-------------------------------------------------------------------
+
+    SLD_API_INLINE void
+    epoch_domain_init(
+        epoch_domain_t& domain) {
+
+        domain.global.store(1, std::memory_order_relaxed);
+        domain.retire_count = 0;
+        spin_lock_init(domain.retire_lock);
+
+        for (
+            u32 index = 0;
+                index < SLD_EPOCH_PARTICIPANT_MAX;
+              ++index) {
+
+            domain.participants[index].epoch.store (EPOCH_INACTIVE, std::memory_order_relaxed);
+            domain.participants[index].used.store  (0,              std::memory_order_relaxed);
+        }
+    }
+
+    SLD_API_INLINE void
+    epoch_domain_release(
+        epoch_domain_t& domain) {
+
+        // nobody can be reading anymore, free everything
+        spin_lock_acquire(domain.retire_lock);
+        for (
+            u32 index = 0;
+                index < domain.retire_count;
+              ++index) {
+
+            epoch_retired_t& retired = domain.retired[index];
+            retired.free(retired.data);
+        }
+        domain.retire_count = 0;
+        spin_lock_release(domain.retire_lock);
+    }
+
+    SLD_API_INLINE u32
+    epoch_register(
+        epoch_domain_t& domain) {
+
+        for (
+            u32 index = 0;
+                index < SLD_EPOCH_PARTICIPANT_MAX;
+              ++index) {
+
+            u32 expected = 0;
+            const bool did_claim = domain.participants[index].used.compare_exchange_strong(
+                expected, 1, std::memory_order_acq_rel);
+            if (did_claim) return(index);
+        }
+        return(EPOCH_PARTICIPANT_INVALID);
+    }
+
+    SLD_API_INLINE void
+    epoch_unregister(
+        epoch_domain_t& domain,
+        const u32       participant) {
+
+        assert(participant < SLD_EPOCH_PARTICIPANT_MAX);
+        domain.participants[participant].epoch.store (EPOCH_INACTIVE, std::memory_order_release);
+        domain.participants[participant].used.store  (0,              std::memory_order_release);
+    }
+
+    SLD_API_INLINE void
+    epoch_enter(
+        epoch_domain_t& domain,
+        const u32       participant) {
+
+        assert(participant < SLD_EPOCH_PARTICIPANT_MAX);
+
+        // the fence keeps our shared reads from moving above the store,
+        // so a writer that sees us inactive knows we haven't started
+        const u64 epoch = domain.global.load(std::memory_order_relaxed);
+        domain.participants[participant].epoch.store(epoch, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    SLD_API_INLINE void
+    epoch_exit(
+        epoch_domain_t& domain,
+        const u32       participant) {
+
+        assert(participant < SLD_EPOCH_PARTICIPANT_MAX);
+        domain.participants[participant].epoch.store(EPOCH_INACTIVE, std::memory_order_release);
+    }
+
+    SLD_API_INLINE void
+    epoch_retire(
+        epoch_domain_t& domain,
+        void*           data,
+        const epoch_free_f free) {
+
+        bool can_retire = true;
+        can_retire &= (data != NULL);
+        can_retire &= (free != NULL);
+        assert(can_retire);
+
+        spin_lock_acquire(domain.retire_lock);
+
+        // the list is full, wait for readers to move on
+        while (domain.retire_count == SLD_EPOCH_RETIRE_MAX) {
+            (void)epoch_try_advance(domain);
+            if (epoch_free_retired(domain) == 0) _mm_pause();
+        }
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        epoch_retired_t& retired = domain.retired[domain.retire_count];
+        retired.data  = data;
+        retired.free  = free;
+        retired.epoch = domain.global.load(std::memory_order_relaxed);
+        ++domain.retire_count;
+
+        (void)epoch_try_advance  (domain);
+        (void)epoch_free_retired (domain);
+        spin_lock_release(domain.retire_lock);
+    }
+
+    SLD_API_INLINE u32
+    epoch_reclaim(
+        epoch_domain_t& domain) {
+
+        spin_lock_acquire(domain.retire_lock);
+        (void)epoch_try_advance(domain);
+        const u32 free_count = epoch_free_retired(domain);
+        spin_lock_release(domain.retire_lock);
+        return(free_count);
+    }
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_INTERNAL_INLINE bool
+    epoch_try_advance(
+        epoch_domain_t& domain) {
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        const u64 epoch = domain.global.load(std::memory_order_relaxed);
+        for (
+            u32 index = 0;
+                index < SLD_EPOCH_PARTICIPANT_MAX;
+              ++index) {
+
+            const u64 participant_epoch = domain.participants[index].epoch.load(std::memory_order_acquire);
+            const bool is_behind = (participant_epoch != EPOCH_INACTIVE && participant_epoch != epoch);
+            if (is_behind) return(false);
+        }
+
+        u64        expected    = epoch;
+        const bool did_advance = domain.global.compare_exchange_strong(
+            expected, epoch + 1, std::memory_order_acq_rel);
+        return(did_advance);
+    }
+
+    SLD_INTERNAL_INLINE u32
+    epoch_free_retired(
+        epoch_domain_t& domain) {
+
+        // called with the retire lock held
+        const u64 epoch      = domain.global.load(std::memory_order_acquire);
+        u32       free_count = 0;
+        u32       index      = 0;
+
+        while (index < domain.retire_count) {
+
+            epoch_retired_t& retired = domain.retired[index];
+            if ((retired.epoch + 2) <= epoch) {
+                retired.free(retired.data);
+                retired = domain.retired[domain.retire_count - 1];
+                --domain.retire_count;
+                ++free_count;
+            }
+            else {
+                ++index;
+            }
+        }
+        return(free_count);
+    }
+};
+
+#endif //SLD_EPOCH_HPP
\ No newline at end of file
@@ -0,0 +1,89 @@
+#ifndef SLD_HASH_FILTER_HPP
+#define SLD_HASH_FILTER_HPP
+
+#include "sld.hpp"
+#include "sld-hash.hpp"
+#include "sld-memory.hpp"
+
+namespace sld {
+
+    struct bloom_filter_t;
+    struct bloom_filter_block_t;
+    struct cuckoo_filter_t;
+
+    SLD_API u32  bloom_filter_block_count     (const u32 key_count, const u32 bits_per_key);
+    SLD_API u64  bloom_filter_memory_size     (const bloom_filter_t&  filter);
+    SLD_API bool bloom_filter_memory_init     (bloom_filter_t&        filter, const memory_t&  memory);
+    SLD_API bool bloom_filter_validate        (const bloom_filter_t&  filter);
+    SLD_API bool bloom_filter_reset           (bloom_filter_t&        filter);
+    SLD_API bool bloom_filter_insert          (bloom_filter_t&        filter, const hash128_t& hash);
+    SLD_API bool bloom_filter_contains        (const bloom_filter_t&  filter, const hash128_t& hash);
+    SLD_API u32  bloom_filter_contains_batch  (const bloom_filter_t&  filter, const u32 count, const hash128_t* hashes, bool* results);
+
+    SLD_API u32  cuckoo_filter_bucket_count   (const u32 key_count);
+    SLD_API u64  cuckoo_filter_memory_size    (const cuckoo_filter_t& filter);
+    SLD_API bool cuckoo_filter_memory_init    (cuckoo_filter_t&       filter, const memory_t&  memory);
+    SLD_API bool cuckoo_filter_validate       (const cuckoo_filter_t& filter);
+    SLD_API bool cuckoo_filter_reset          (cuckoo_filter_t&       filter);
+    SLD_API bool cuckoo_filter_insert         (cuckoo_filter_t&       filter, const hash128_t& hash);
+    SLD_API bool cuckoo_filter_remove         (cuckoo_filter_t&       filter, const hash128_t& hash);
+    SLD_API bool cuckoo_filter_contains       (const cuckoo_filter_t& filter, const hash128_t& hash);
+    SLD_API u32  cuckoo_filter_contains_batch (const cuckoo_filter_t& filter, const u32 count, const hash128_t* hashes, bool* results);
+
+    // filters answer "definitely not there" or "maybe there" for keys that
+    // are already hashed, so a miss never has to reach the table or the
+    // disk behind them. every position comes from the four u32 lanes of
+    // the key's hash128 and nothing is hashed again.
+
+    // a blocked bloom filter. a key lives in one cache line block picked
+    // by lane 0 and sets one bit in each of the block's 8 words, picked
+    // from lanes 1 and 2 by odd multipliers. a lookup is one cache miss,
+    // and with avx2 the 8 bits are built and tested with a few
+    // instructions. the block count doesn't have to be a power of two.
+    // keys can't be removed
+    struct alignas(64) bloom_filter_block_t {
+        u64 words[8];
+    };
+
+    struct bloom_filter_t {
+        u32                   block_count;
+        u32                   count;
+        bloom_filter_block_t* blocks;
+    };
+
+    constexpr u32 BLOOM_FILTER_BLOCK_BITS     = 512;
+    constexpr u32 BLOOM_FILTER_BITS_PER_KEY   = 12;
+    constexpr u32 BLOOM_FILTER_SALT[8]        = {
+        0x47B6137B, 0x44974D91, 0x8824AD5B, 0xA2B7289D,
+        0x705495C7, 0x2DF1424B, 0x9EFC4947, 0x5C6BFB31
+    };
+
+    // a cuckoo filter with 4 slots of 16 bit fingerprints per bucket, one
+    // bucket to a u64. lane 0 picks the first bucket and lane 3 is the
+    // fingerprint, the second bucket is the first xored with a hash of
+    // the fingerprint, so either bucket leads to the other without the
+    // key. a full pair of buckets kicks a fingerprint to its other bucket,
+    // starting from a slot picked by lane 2. when the kicks run out the
+    // last fingerprint waits as the victim and the filter is full until a
+    // remove makes room. only remove keys that were inserted, removing
+    // one that wasn't can take out another key's fingerprint
+    struct cuckoo_filter_t {
+        u32  bucket_count;
+        u32  count;
+        u64* buckets;
+        struct {
+            u32  index;
+            u16  fingerprint;
+            bool is_used;
+        } victim;
+    };
+
+    constexpr u32 CUCKOO_FILTER_SLOT_COUNT       = 4;
+    constexpr u32 CUCKOO_FILTER_BUCKET_COUNT_MIN = 16;
+    constexpr u32 CUCKOO_FILTER_KICK_MAX         = 500;
+    constexpr u32 CUCKOO_FILTER_LOAD_PERCENT     = 95;
+
+    constexpr u32 HASH_FILTER_BATCH_SIZE         = 64;
+};
+
+#endif //SLD_HASH_FILTER_HPP
\ No newline at end of file
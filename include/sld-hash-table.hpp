@@ -4,6 +4,8 @@
 #include "sld.hpp"
 #include "sld-hash.hpp"
 #include "sld-memory.hpp"
+#include "sld-arena-allocator.hpp"
+#include "sld-os.hpp"
 
 namespace sld {
 
@@ -12,34 +14,85 @@ namespace sld {
     struct hash_table_value_t;
     struct hash_table_kv_pair_t;
     struct hash_table_error_t;
+    struct hash_table_snapshot_header_t;
 
-    SLD_API const u32 hash_table_memory_size    (const hash_table_t& hash_table);
-    SLD_API bool      hash_table_memory_init    (hash_table_t&       hash_table, const memory_t& memory);
-    SLD_API bool      hash_table_validate       (const hash_table_t& hash_table);
-    SLD_API bool      hash_table_validate_key   (const hash_table_t& hash_table, const hash_table_key_t&   key);
-    SLD_API bool      hash_table_validate_value (const hash_table_t& hash_table, const hash_table_value_t& value);
-    SLD_API bool      hash_table_reset          (hash_table_t&       hash_table);
-    SLD_API bool      hash_table_insert         (hash_table_t&       hash_table, const byte*             value, hash_table_key_t& key);
-    SLD_API bool      hash_table_insert_at      (hash_table_t&       hash_table, const byte*             data, const u32 index, hash_t& key);
-    SLD_API bool      hash_table_remove_at      (hash_table_t&       hash_table, const u32               index);
-    SLD_API bool      hash_table_remove         (hash_table_t&       hash_table, const hash_table_key_t& key);
-    SLD_API bool      hash_table_search         (const hash_table_t& hash_table, const hash_table_key_t& key,   hash_table_value_t& value);
-    SLD_API bool      hash_table_get_key_at     (const hash_table_t& hash_table, const u32               index, hash_table_key_t&   key);
-    SLD_API bool      hash_table_get_value_at   (const hash_table_t& hash_table, const u32               index, hash_table_value_t& value);
+    SLD_API u64       hash_table_memory_size       (const hash_table_t& hash_table);
+    SLD_API bool      hash_table_memory_init       (hash_table_t&       hash_table, const memory_t& memory);
+    SLD_API bool      hash_table_validate          (const hash_table_t& hash_table);
+    SLD_API bool      hash_table_validate_key      (const hash_table_key_t&   key);
+    SLD_API bool      hash_table_validate_value    (const hash_table_t& hash_table, const hash_table_value_t& value);
+    SLD_API bool      hash_table_reset             (hash_table_t&       hash_table);
+    SLD_API bool      hash_table_insert            (hash_table_t&       hash_table, const byte*             value, const hash_table_key_t& key);
+    SLD_API bool      hash_table_insert_hash       (hash_table_t&       hash_table, const byte*             value, const hash128_t&        hash, hash_table_value_t& result);
+    SLD_API bool      hash_table_remove_at         (hash_table_t&       hash_table, const u32               index);
+    SLD_API bool      hash_table_remove            (hash_table_t&       hash_table, const hash_table_key_t& key);
+    SLD_API bool      hash_table_search            (const hash_table_t& hash_table, const hash_table_key_t& key,   hash_table_value_t& value);
+    SLD_API bool      hash_table_search_hash       (const hash_table_t& hash_table, const hash128_t&        hash,  hash_table_value_t& value);
+    SLD_API bool      hash_table_get_hash_at       (const hash_table_t& hash_table, const u32               index, hash128_t&          hash);
+    SLD_API bool      hash_table_get_value_at      (const hash_table_t& hash_table, const u32               index, hash_table_value_t& value);
+    SLD_API hash128_t hash_table_hash_key          (const hash_table_key_t& key);
+    SLD_API u32       hash_table_search_batch      (const hash_table_t& hash_table, const u32 count, const byte*      keys,   const u32 key_stride, hash_table_value_t* values);
+    SLD_API u32       hash_table_search_batch_hash (const hash_table_t& hash_table, const u32 count, const hash128_t* hashes, hash_table_value_t* values);
+    SLD_API u32       hash_table_insert_batch      (hash_table_t&       hash_table, const u32 count, const byte*      keys,   const u32 key_stride, const byte* values, hash_table_value_t* results);
+    SLD_API u32       hash_table_insert_batch_hash (hash_table_t&       hash_table, const u32 count, const hash128_t* hashes, const byte* values,     hash_table_value_t* results);
+    SLD_API bool      hash_table_allocator_init    (hash_table_t&       hash_table, arena_allocator_t* allocator);
+    SLD_API bool      hash_table_allocator_reserve (hash_table_t&       hash_table, arena_allocator_t* allocator, const u32 count_max);
+    SLD_API void      hash_table_allocator_release (hash_table_t&       hash_table);
+    SLD_API bool      hash_table_is_resizing       (const hash_table_t& hash_table);
+    SLD_API bool      hash_table_resize_step       (hash_table_t&       hash_table, const u32 slot_count);
+    SLD_API void      hash_table_resize_finish     (hash_table_t&       hash_table);
+    SLD_API u32       hash_table_get_count         (const hash_table_t& hash_table);
+    SLD_API u64       hash_table_snapshot_size     (const hash_table_t& hash_table);
+    SLD_API bool      hash_table_snapshot_write    (const hash_table_t& hash_table, const memory_t& memory);
+    SLD_API bool      hash_table_snapshot_load     (hash_table_t&       hash_table, const byte* data, const u64 size);
+    SLD_API bool      hash_table_snapshot_map_file (hash_table_t&       hash_table, const c8*   path, os_file_map_t& map);
 
     struct hash_table_error_t : s32_t { };
 
+    // open addressing with one control byte per slot. a full slot stores
+    // 7 bits of its hash as a tag, empty and deleted slots have the high
+    // bit set, so one sse2 compare checks 16 tags at once and a probe
+    // only touches the hash and value of slots whose tag matched. keys
+    // are identified by their 128 bit hash, values keep the fixed stride.
+    // the first group of control bytes is mirrored past the end so a
+    // group load never has to wrap.
+    // a table initialized from an arena allocator grows instead of
+    // failing when it fills. the new arrays come from a fresh arena and
+    // the old ones are kept as the source of a migration that moves a
+    // few slots on every insert and remove, so no single call pays for
+    // the whole rehash. until the old table drains, searches probe both
     struct hash_table_t {
         u32                capacity;
         u32                stride;
         u32                count;
+        u32                tombstone_count;
         hash_table_error_t error;
         struct {
-            hash_t* hash;
-            byte*   value;
+            u8*        control;
+            hash128_t* hash;
+            byte*      value;
         } array;
+        arena_allocator_t* allocator;
+        arena_t*           arena;
+        struct {
+            arena_t*   arena;
+            u32        capacity;
+            u32        count;
+            u32        position;
+            u8*        control;
+            hash128_t* hash;
+            byte*      value;
+        } old;
     };
 
+    constexpr u32 HASH_TABLE_GROUP_WIDTH     = 16;
+    constexpr u32 HASH_TABLE_CAPACITY_MIN    = HASH_TABLE_GROUP_WIDTH;
+    constexpr u8  HASH_TABLE_CONTROL_EMPTY   = 0x80;
+    constexpr u8  HASH_TABLE_CONTROL_DELETED = 0xFE;
+    constexpr u32 HASH_TABLE_INDEX_INVALID   = 0xFFFFFFFF;
+    constexpr u32 HASH_TABLE_BATCH_SIZE      = 64;
+    constexpr u32 HASH_TABLE_MIGRATE_STEP    = 32;
+
     struct hash_table_key_t {
         byte* data;
         u64   length;
@@ -50,6 +103,28 @@ namespace sld {
         u64   index;
     };
 
+    // a table written out as one position independent image, the header
+    // and then the hash, value and control arrays at fixed offsets. it
+    // holds no pointers, so a loaded image is used in place, straight
+    // out of a read only file mapping. the version changes whenever the
+    // layout or the key hash does
+    struct hash_table_snapshot_header_t {
+        u32 magic;
+        u32 version;
+        u32 capacity;
+        u32 stride;
+        u32 count;
+        u32 tombstone_count;
+        u64 offset_hash;
+        u64 offset_value;
+        u64 offset_control;
+        u64 size;
+    };
+
+    constexpr u32 HASH_TABLE_SNAPSHOT_MAGIC     = 0x48444C53; // SLDH
+    constexpr u32 HASH_TABLE_SNAPSHOT_VERSION   = 2;
+    constexpr u64 HASH_TABLE_SNAPSHOT_ALIGNMENT = 64;
+
     struct hash_table_kv_pair_t {
         hash_table_key_t   key; 
         hash_table_value_t value; 
@@ -63,7 +138,8 @@ namespace sld {
         hash_table_error_e_not_enough_memory   = -4,
         hash_table_error_e_max_count           = -5,
         hash_table_error_e_hash_failed         = -6,
-        hash_table_error_e_index_out_of_bounds = -7
+        hash_table_error_e_index_out_of_bounds = -7,
+        hash_table_error_e_invalid_snapshot    = -8
     };
 };
 
@@ -3,6 +3,7 @@
 
 #include <meow-hash/meow_hash_x64_aesni.h>
 #include "sld.hpp"
+#include "sld-os.hpp"
 
 #define SLD_HASH_ALIGN_128 alignas(16)
 #define SLD_HASH_ALIGN_32  alignas(4)
@@ -17,6 +18,9 @@ namespace sld {
     struct hash128_seed_t;
     struct hash128_state_t;
 
+    struct hash64_t;
+    struct hash64_seed_t;
+
     struct hash32_t;
     struct hash32_seed_t;
 
@@ -25,7 +29,8 @@ namespace sld {
     //-------------------------------------------------------------------
 
     SLD_API const hash128_t hash128_data          (const hash128_seed_t& seed,  const byte*           data,   const u32        length);
-    SLD_API bool            hash128_data_batch    (const hash128_seed_t& seed,  const u32             count,  const byte*      data,   const u32  stride, hash128_t* hashes);
+    SLD_API bool            hash128_data_batch          (const hash128_seed_t& seed,  const u32             count,  const byte*      data,   const u32  stride, hash128_t* hashes);
+    SLD_API bool            hash128_data_batch_threaded (const hash128_seed_t& seed,  const u32             count,  const byte*      data,   const u32  stride, hash128_t* hashes, const u32 thread_count);
     SLD_API bool            hash128_is_equal      (const hash128_seed_t& seed,  const byte*           data_a, const byte*      data_b, const u32  length);
     SLD_API bool            hash128_is_equal      (const hash128_seed_t& seed,  const hash128_t&      hash,   const byte*      data,   const u32  length);
     SLD_API bool            hash128_search        (const u32             count, const hash128_t       search, const hash128_t* array,  u32&       index);
@@ -37,7 +42,7 @@ namespace sld {
         union {
             u32  as_u32   [4];
             u64  as_u64   [2];
-            u32  as_u16   [8];
+            u16  as_u16   [8];
             byte as_bytes [16];
         } val;
     };
@@ -48,15 +53,63 @@ namespace sld {
 
     struct hash128_state_t : meow_state { };
 
+    //-------------------------------------------------------------------
+    // FILES
+    //-------------------------------------------------------------------
+
+    // a whole file through the hash128 block functions, so it matches
+    // hashing the same bytes with block_begin, consume and end. the batch
+    // spreads files over threads and returns how many hashed, each file
+    // keeps its own error
+    struct hash128_file_t;
+
+    SLD_API bool hash128_file       (const hash128_seed_t& seed, hash128_file_t& file);
+    SLD_API u32  hash128_file_batch (const hash128_seed_t& seed, const u32 count, hash128_file_t* files, const u32 thread_count);
+
+    struct hash128_file_t {
+        const c8*       path;
+        hash128_t       hash;
+        u64             size;
+        os_file_error_t error;
+    };
+
+    //-------------------------------------------------------------------
+    // SHORT KEYS
+    //-------------------------------------------------------------------
+
+    // hash_data picks the short hash or meow by length, use it for keys
+    // of any size. the short hashes are not meow, don't mix the two
+    SLD_API const hash64_t  hash64_short    (const hash64_seed_t   seed,  const byte* data, const u32   length);
+    SLD_API const hash128_t hash128_short   (const hash128_seed_t& seed,  const byte* data, const u32   length);
+    SLD_API const hash128_t hash_data       (const hash128_seed_t& seed,  const byte* data, const u32   length);
+    SLD_API bool            hash_data_batch (const hash128_seed_t& seed,  const u32   count, const byte* data,  const u32 stride, hash128_t* hashes);
+
+    struct hash64_t {
+        union {
+            u64  as_u64;
+            u32  as_u32   [2];
+            byte as_bytes [8];
+        };
+    };
+
+    struct hash64_seed_t : u64_t { };
+
     //-------------------------------------------------------------------
     // HASH 32
     //-------------------------------------------------------------------
 
     SLD_API const hash32_t hash32          (const hash32_seed_t seed,  const byte*    data,   const u32       length);
-    SLD_API bool           hash32_batch    (const hash32_seed_t seed,  const byte*    data,   const u32       stride, const u32      count, hash32_t* hashes);
+    SLD_API bool           hash32_batch          (const hash32_seed_t seed,  const byte*    data,   const u32       stride, const u32      count, hash32_t* hashes);
+    SLD_API bool           hash32_batch_threaded (const hash32_seed_t seed,  const byte*    data,   const u32       stride, const u32      count, hash32_t* hashes, const u32 thread_count);
     SLD_API bool           hash32_is_equal (const hash32_seed_t seed,  const byte*    data,   const u32       length, const hash32_t hash);
     SLD_API bool           hash32_search   (const u32           count, const hash32_t search, const hash32_t* array,  u32&           index);
 
+    // crc32c, not zlib compatible, in hardware where the cpu has it
+    SLD_API const hash32_t hash32c                (const hash32_seed_t seed,  const byte*    data,   const u32       length);
+    SLD_API bool           hash32c_batch          (const hash32_seed_t seed,  const byte*    data,   const u32       stride, const u32      count, hash32_t* hashes);
+    SLD_API bool           hash32c_batch_threaded (const hash32_seed_t seed,  const byte*    data,   const u32       stride, const u32      count, hash32_t* hashes, const u32 thread_count);
+    SLD_API bool           hash32c_is_equal       (const hash32_seed_t seed,  const byte*    data,   const u32       length, const hash32_t hash);
+
     struct SLD_HASH_ALIGN_32 hash32_t {
         union {
            u32  as_u32;
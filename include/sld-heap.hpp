@@ -11,13 +11,80 @@ namespace sld {
     struct heap_t;
     struct heap_root_t;
     struct heap_node_t;
+    struct heap_stats_t;
 
-    SLD_API const u64    heap_memory_size (const u64       heap_size_min);
-    SLD_API bool         heap_validate    (const heap_t*   heap);
-    SLD_API heap_t*      heap_init        (const memory_t& memory, const u64 granularity);
-    SLD_API bool         heap_reset       (heap_t*         heap);
-    SLD_API heap_node_t* heap_insert      (heap_t*         heap, const u32    size);
-    SLD_API bool         heap_remove      (heap_t*         heap, heap_node_t* node);
+    SLD_API const u64    heap_memory_size    (const u64          heap_size_min);
+    SLD_API bool         heap_validate       (const heap_t*      heap);
+    SLD_API heap_t*      heap_init           (const memory_t&    memory, const u64 granularity = SLD_HEAP_DEFAULT_GRANULARITY);
+    SLD_API bool         heap_reset          (heap_t*            heap);
+    SLD_API heap_node_t* heap_insert         (heap_t*            heap, const u32    size);
+    SLD_API bool         heap_remove         (heap_t*            heap, heap_node_t* node);
+    SLD_API void         heap_get_stats      (const heap_t*      heap, heap_stats_t& stats);
+    SLD_API void*        heap_node_get_data  (const heap_node_t* node);
+    SLD_API u64          heap_node_get_size  (const heap_node_t* node);
+    SLD_API heap_node_t* heap_node_from_data (const void*        data);
+
+    //-------------------------------------------------------------------
+    // TWO LEVEL SEGREGATED FIT
+    //-------------------------------------------------------------------
+
+    // free nodes are binned by a first level power of two and a second
+    // level linear split of that range. a bitmap per level lets insert
+    // and remove find a fitting bin with two bit scans, so both are O(1)
+    // and the worst case fragmentation is bounded by the bin width
+
+    constexpr u32 HEAP_ALIGN_SIZE_LOG2     = 3;
+    constexpr u32 HEAP_ALIGN_SIZE          = (1 << HEAP_ALIGN_SIZE_LOG2);
+    constexpr u32 HEAP_SL_INDEX_COUNT_LOG2 = 5;
+    constexpr u32 HEAP_SL_INDEX_COUNT      = (1 << HEAP_SL_INDEX_COUNT_LOG2);
+    constexpr u32 HEAP_FL_INDEX_MAX        = 32;
+    constexpr u32 HEAP_FL_INDEX_SHIFT      = (HEAP_SL_INDEX_COUNT_LOG2 + HEAP_ALIGN_SIZE_LOG2);
+    constexpr u32 HEAP_FL_INDEX_COUNT      = (HEAP_FL_INDEX_MAX - HEAP_FL_INDEX_SHIFT + 1);
+    constexpr u32 HEAP_SMALL_NODE_SIZE     = (1 << HEAP_FL_INDEX_SHIFT);
+
+    // the prev_physical pointer is only valid while the previous node is
+    // free, so it overlaps the last bytes of a used previous node. the
+    // free list links overlap the data of a used node, leaving the size
+    // as the only per allocation overhead
+    struct heap_node_t {
+        heap_node_t* prev_physical;
+        u64          size;
+        heap_node_t* next_free;
+        heap_node_t* prev_free;
+    };
+
+    constexpr u64 HEAP_NODE_FLAG_FREE      = 1;
+    constexpr u64 HEAP_NODE_FLAG_PREV_FREE = 2;
+    constexpr u64 HEAP_NODE_OVERHEAD       = sizeof(u64);
+    constexpr u64 HEAP_NODE_DATA_OFFSET    = (sizeof(heap_node_t*) + sizeof(u64));
+    constexpr u64 HEAP_NODE_SIZE_MIN       = (sizeof(heap_node_t) - sizeof(heap_node_t*));
+    constexpr u64 HEAP_NODE_SIZE_MAX       = ((u64)1 << HEAP_FL_INDEX_MAX) - HEAP_ALIGN_SIZE;
+
+    struct heap_root_t {
+        heap_node_t  null_node;
+        u32          fl_bitmap;
+        u32          sl_bitmap  [HEAP_FL_INDEX_COUNT];
+        heap_node_t* free_lists [HEAP_FL_INDEX_COUNT][HEAP_SL_INDEX_COUNT];
+    };
+
+    struct heap_stats_t {
+        u64 size_pool;
+        u64 size_used;
+        u64 size_used_peak;
+        u64 size_free;
+        u32 node_count_used;
+        u32 node_count_free;
+        u64 insert_count;
+        u64 remove_count;
+    };
+
+    struct heap_t {
+        memory_t     memory;
+        memory_t     pool;
+        u64          granularity;
+        heap_root_t  root;
+        heap_stats_t stats;
+    };
 };
 
 #endif //SLD_HEAP_HPP
\ No newline at end of file
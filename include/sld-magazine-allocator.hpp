@@ -0,0 +1,403 @@
+#ifndef SLD_MAGAZINE_ALLOCATOR_HPP
+#define SLD_MAGAZINE_ALLOCATOR_HPP
+
+#include "sld-memory.hpp"
+#include "sld-spin-lock.hpp"
+#include "sld-block-allocator.hpp"
+#include "sld-slab-allocator.hpp"
+
+#ifndef    SLD_MAGAZINE_ROUND_COUNT
+#   define SLD_MAGAZINE_ROUND_COUNT 32
+#endif
+#ifndef    SLD_MAGAZINE_DEPOT_COUNT
+#   define SLD_MAGAZINE_DEPOT_COUNT 64
+#endif
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // API
+    //-------------------------------------------------------------------
+
+    // a magazine is a small stack of objects. each thread keeps a cache
+    // of two magazines and only takes the depot lock when both are empty
+    // on alloc or both are full on free, so the shared allocator behind
+    // the depot is touched once per magazine instead of once per object.
+    // the depot owns every magazine, caches only borrow them, and the
+    // depot lock also guards the source allocator, which isn't thread safe
+
+    struct magazine_t {
+        magazine_t* next;
+        u32         count;
+        void*       rounds[SLD_MAGAZINE_ROUND_COUNT];
+    };
+
+    using magazine_source_alloc_f = void* (*) (void* source, const u32 size);
+    using magazine_source_free_f  = void  (*) (void* source, void* object);
+
+    struct magazine_depot_t {
+        alignas(64) spin_lock_t lock;
+        void*                   source;
+        magazine_source_alloc_f source_alloc;
+        magazine_source_free_f  source_free;
+        u32                     object_size;
+        u32                     full_count;
+        u32                     empty_count;
+        magazine_t*             full;
+        magazine_t*             empty;
+        magazine_t              magazines[SLD_MAGAZINE_DEPOT_COUNT];
+    };
+
+    // one per thread per depot, keep it in a thread_local
+    struct magazine_cache_t {
+        magazine_depot_t* depot;
+        magazine_t*       loaded;
+        magazine_t*       previous;
+    };
+
+    SLD_API_INLINE void  magazine_depot_init       (magazine_depot_t* depot, void* source, const u32 object_size, magazine_source_alloc_f source_alloc, magazine_source_free_f source_free);
+    SLD_API_INLINE void  magazine_depot_init_block (magazine_depot_t* depot, block_allocator_t* alctr);
+    SLD_API_INLINE void  magazine_depot_init_slab  (magazine_depot_t* depot, slab_allocator_t*  alctr, const u32 object_size);
+    SLD_API_INLINE void  magazine_depot_trim       (magazine_depot_t* depot, const u32 full_count_keep = 0);
+    SLD_API_INLINE bool  magazine_cache_init       (magazine_cache_t* cache, magazine_depot_t* depot);
+    SLD_API_INLINE void  magazine_cache_release    (magazine_cache_t* cache);
+    SLD_API_INLINE void  magazine_cache_flush      (magazine_cache_t* cache);
+    SLD_API_INLINE void* magazine_cache_alloc      (magazine_cache_t* cache);
+    SLD_API_INLINE void  magazine_cache_free       (magazine_cache_t* cache, void* object);
+
+    SLD_INTERNAL_INLINE void*       magazine_source_alloc_block (void* source, const u32 size);
+    SLD_INTERNAL_INLINE void        magazine_source_free_block  (void* source, void* object);
+    SLD_INTERNAL_INLINE void*       magazine_source_alloc_slab  (void* source, const u32 size);
+    SLD_INTERNAL_INLINE void        magazine_source_free_slab   (void* source, void* object);
+    SLD_INTERNAL_INLINE magazine_t* magazine_list_pop           (magazine_t*& list, u32& count);
+    SLD_INTERNAL_INLINE void        magazine_list_push          (magazine_t*& list, u32& count, magazine_t* magazine);
+    SLD_INTERNAL_INLINE void        magazine_depot_fill         (magazine_depot_t* depot, magazine_t* magazine);
+    SLD_INTERNAL_INLINE void        magazine_depot_drain        (magazine_depot_t* depot, magazine_t* magazine);
+
+    //-------------------------------------------------------------------
+    // INLINE METHODS
+    //-------------------------------------------------------------------
+
+    SLD_API_INLINE void
+    magazine_depot_init(
+        magazine_depot_t*       depot,
+        void*                   source,
+        const u32               object_size,
+        magazine_source_alloc_f source_alloc,
+        magazine_source_free_f  source_free) {
+
+        bool can_init = true;
+        can_init &= (depot        != NULL);
+        can_init &= (source       != NULL);
+        can_init &= (source_alloc != NULL);
+        can_init &= (source_free  != NULL);
+        assert(can_init);
+
+        spin_lock_init(depot->lock);
+        depot->source       = source;
+        depot->source_alloc = source_alloc;
+        depot->source_free  = source_free;
+        depot->object_size  = object_size;
+        depot->full         = NULL;
+        depot->empty        = NULL;
+        depot->full_count   = 0;
+        depot->empty_count  = 0;
+
+        // every magazine starts out empty
+        for (
+            u32 magazine_index = 0;
+                magazine_index < SLD_MAGAZINE_DEPOT_COUNT;
+              ++magazine_index) {
+
+            magazine_t* magazine = &depot->magazines[magazine_index];
+            magazine->count = 0;
+            magazine_list_push(depot->empty, depot->empty_count, magazine);
+        }
+    }
+
+    SLD_API_INLINE void
+    magazine_depot_init_block(
+        magazine_depot_t*  depot,
+        block_allocator_t* alctr) {
+
+        block_allocator_assert_valid(alctr);
+        magazine_depot_init(
+            depot,
+            alctr,
+            alctr->block_size,
+            magazine_source_alloc_block,
+            magazine_source_free_block);
+    }
+
+    SLD_API_INLINE void
+    magazine_depot_init_slab(
+        magazine_depot_t* depot,
+        slab_allocator_t* alctr,
+        const u32         object_size) {
+
+        slab_allocator_assert_valid(alctr);
+        magazine_depot_init(
+            depot,
+            alctr,
+            object_size,
+            magazine_source_alloc_slab,
+            magazine_source_free_slab);
+    }
+
+    SLD_API_INLINE void
+    magazine_depot_trim(
+        magazine_depot_t* depot,
+        const u32         full_count_keep) {
+
+        assert(depot != NULL);
+
+        // give the objects in surplus full magazines back to the source
+        spin_lock_acquire(depot->lock);
+        while (depot->full_count > full_count_keep) {
+
+            magazine_t* magazine = magazine_list_pop(depot->full, depot->full_count);
+            magazine_depot_drain (depot, magazine);
+            magazine_list_push   (depot->empty, depot->empty_count, magazine);
+        }
+        spin_lock_release(depot->lock);
+    }
+
+    SLD_API_INLINE bool
+    magazine_cache_init(
+        magazine_cache_t* cache,
+        magazine_depot_t* depot) {
+
+        bool can_init = true;
+        can_init &= (cache != NULL);
+        can_init &= (depot != NULL);
+        assert(can_init);
+
+        spin_lock_acquire(depot->lock);
+        can_init &= (depot->empty_count >= 2);
+        if (can_init) {
+            cache->depot    = depot;
+            cache->loaded   = magazine_list_pop(depot->empty, depot->empty_count);
+            cache->previous = magazine_list_pop(depot->empty, depot->empty_count);
+        }
+        spin_lock_release(depot->lock);
+
+        return(can_init);
+    }
+
+    SLD_API_INLINE void
+    magazine_cache_release(
+        magazine_cache_t* cache) {
+
+        assert(cache != NULL && cache->depot != NULL);
+        magazine_depot_t* depot = cache->depot;
+
+        // hand back full magazines as they are so other threads can use
+        // them, partial ones are drained
+        spin_lock_acquire(depot->lock);
+        magazine_t* magazines[2] = { cache->loaded, cache->previous };
+        for (
+            u32 magazine_index = 0;
+                magazine_index < 2;
+              ++magazine_index) {
+
+            magazine_t* magazine = magazines[magazine_index];
+            if (magazine->count == SLD_MAGAZINE_ROUND_COUNT) {
+                magazine_list_push(depot->full, depot->full_count, magazine);
+            }
+            else {
+                magazine_depot_drain (depot, magazine);
+                magazine_list_push   (depot->empty, depot->empty_count, magazine);
+            }
+        }
+        spin_lock_release(depot->lock);
+
+        cache->depot    = NULL;
+        cache->loaded   = NULL;
+        cache->previous = NULL;
+    }
+
+    SLD_API_INLINE void
+    magazine_cache_flush(
+        magazine_cache_t* cache) {
+
+        assert(cache != NULL && cache->depot != NULL);
+        magazine_depot_t* depot = cache->depot;
+
+        spin_lock_acquire    (depot->lock);
+        magazine_depot_drain (depot, cache->loaded);
+        magazine_depot_drain (depot, cache->previous);
+        spin_lock_release    (depot->lock);
+    }
+
+    SLD_API_INLINE void*
+    magazine_cache_alloc(
+        magazine_cache_t* cache) {
+
+        // fast path, no shared state
+        magazine_t* loaded = cache->loaded;
+        if (loaded->count != 0) {
+            return(loaded->rounds[--loaded->count]);
+        }
+
+        // the previous magazine still has objects
+        if (cache->previous->count != 0) {
+            cache->loaded   = cache->previous;
+            cache->previous = loaded;
+            return(cache->loaded->rounds[--cache->loaded->count]);
+        }
+
+        // both are empty, trade one for a full magazine from the depot
+        // or fill it from the source
+        magazine_depot_t* depot = cache->depot;
+        spin_lock_acquire(depot->lock);
+        magazine_t* full = magazine_list_pop(depot->full, depot->full_count);
+        if (full != NULL) {
+            magazine_list_push(depot->empty, depot->empty_count, loaded);
+            loaded = full;
+        }
+        else {
+            magazine_depot_fill(depot, loaded);
+        }
+        spin_lock_release(depot->lock);
+
+        cache->loaded = loaded;
+        void* object = (loaded->count != 0)
+            ? loaded->rounds[--loaded->count]
+            : NULL;
+        return(object);
+    }
+
+    SLD_API_INLINE void
+    magazine_cache_free(
+        magazine_cache_t* cache,
+        void*             object) {
+
+        assert(object != NULL);
+
+        // fast path, no shared state
+        magazine_t* loaded = cache->loaded;
+        if (loaded->count != SLD_MAGAZINE_ROUND_COUNT) {
+            loaded->rounds[loaded->count++] = object;
+            return;
+        }
+
+        // the previous magazine still has space
+        if (cache->previous->count != SLD_MAGAZINE_ROUND_COUNT) {
+            cache->loaded   = cache->previous;
+            cache->previous = loaded;
+            cache->loaded->rounds[cache->loaded->count++] = object;
+            return;
+        }
+
+        // both are full, trade one for an empty magazine from the depot
+        // or drain it back to the source
+        magazine_depot_t* depot = cache->depot;
+        spin_lock_acquire(depot->lock);
+        magazine_t* empty = magazine_list_pop(depot->empty, depot->empty_count);
+        if (empty != NULL) {
+            magazine_list_push(depot->full, depot->full_count, loaded);
+            loaded = empty;
+        }
+        else {
+            magazine_depot_drain(depot, loaded);
+        }
+        spin_lock_release(depot->lock);
+
+        cache->loaded = loaded;
+        loaded->rounds[loaded->count++] = object;
+    }
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_INTERNAL_INLINE void*
+    magazine_source_alloc_block(
+        void*     source,
+        const u32 size) {
+
+        // every block is the same size, a request can't ask for more
+        block_allocator_t* block_allocator = (block_allocator_t*)source;
+        if (size > block_allocator->block_size) return(NULL);
+
+        void* object = block_allocator_commit(block_allocator);
+        return(object);
+    }
+
+    SLD_INTERNAL_INLINE void
+    magazine_source_free_block(
+        void* source,
+        void* object) {
+
+        block_allocator_decommit((block_allocator_t*)source, object);
+    }
+
+    SLD_INTERNAL_INLINE void*
+    magazine_source_alloc_slab(
+        void*     source,
+        const u32 size) {
+
+        void* object = slab_allocator_alloc((slab_allocator_t*)source, size);
+        return(object);
+    }
+
+    SLD_INTERNAL_INLINE void
+    magazine_source_free_slab(
+        void* source,
+        void* object) {
+
+        slab_allocator_free((slab_allocator_t*)source, object);
+    }
+
+    SLD_INTERNAL_INLINE magazine_t*
+    magazine_list_pop(
+        magazine_t*& list,
+        u32&         count) {
+
+        magazine_t* magazine = list;
+        if (magazine != NULL) {
+            list           = magazine->next;
+            magazine->next = NULL;
+            --count;
+        }
+        return(magazine);
+    }
+
+    SLD_INTERNAL_INLINE void
+    magazine_list_push(
+        magazine_t*& list,
+        u32&         count,
+        magazine_t*  magazine) {
+
+        magazine->next = list;
+        list           = magazine;
+        ++count;
+    }
+
+    SLD_INTERNAL_INLINE void
+    magazine_depot_fill(
+        magazine_depot_t* depot,
+        magazine_t*       magazine) {
+
+        // caller holds the depot lock
+        while (magazine->count < SLD_MAGAZINE_ROUND_COUNT) {
+
+            void* object = depot->source_alloc(depot->source, depot->object_size);
+            if (object == NULL) break;
+            magazine->rounds[magazine->count++] = object;
+        }
+    }
+
+    SLD_INTERNAL_INLINE void
+    magazine_depot_drain(
+        magazine_depot_t* depot,
+        magazine_t*       magazine) {
+
+        // caller holds the depot lock
+        while (magazine->count != 0) {
+            depot->source_free(depot->source, magazine->rounds[--magazine->count]);
+        }
+    }
+};
+
+#endif //SLD_MAGAZINE_ALLOCATOR_HPP
\ No newline at end of file
@@ -24,7 +24,7 @@ namespace sld {
     SLD_API_INLINE          memory_t memory_add_offset         (const memory_t& memory, const u32 offset);
     SLD_API_INLINE          bool     memory_is_os_committed    (const memory_t& memory);
     SLD_API_INLINE          bool     memory_is_os_reserved     (const memory_t& memory);
-    SLD_API_INLINE          void     memory_os_reserve         (memory_t& memory);
+    SLD_API_INLINE          u64      memory_os_reserve         (memory_t& memory, const os_memory_page_policy_e page_policy = os_memory_page_policy_e_default);
     SLD_API_INLINE          void     memory_os_release         (memory_t& memory);
     SLD_API_INLINE          void     memory_os_commit          (memory_t& memory);
     SLD_API_INLINE          void     memory_os_decommit        (memory_t& memory);
@@ -62,19 +62,42 @@ namespace sld {
         return(offset_memory);
     }
 
-    SLD_API_INLINE void
-    memory_os_reserve(memory_t& memory) {
+    SLD_API_INLINE u64
+    memory_os_reserve(
+        memory_t&                     memory,
+        const os_memory_page_policy_e page_policy) {
 
-        const u64 requested_size = memory.size;
+        // huge page reservations have to be a multiple of the page size
+        // we ask for, which also covers any smaller size we fall back to
+        const u64 requested_size      = memory.size;
+        const u64 requested_page_size = os_memory_page_policy_size(page_policy);
         memory.size = os_memory_align_to_granularity (requested_size);
-        memory.ptr  = os_memory_reserve              (NULL, memory.size);
+        memory.size = size_align_pow_2               (memory.size, requested_page_size);
+
+        u64 page_size = 0;
+        if (page_policy == os_memory_page_policy_e_default) {
+            memory.ptr = os_memory_reserve       (NULL, memory.size);
+            page_size  = os_memory_align_to_page (1);
+        }
+        else {
+            memory.ptr = os_memory_reserve_huge  (NULL, memory.size, page_policy, page_size);
+        }
 
         bool is_valid = true; 
         is_valid &= (requested_size != 0);
         is_valid &= (memory.addr    != 0);
         is_valid &= (memory.size    != 0);
         is_valid &= (memory.size    >= requested_size);
-        assert(is_valid);
+        is_valid &= (page_size      != 0);
+
+        // running out of address space is up to the caller,
+        // a page size of 0 says nothing was reserved
+        if (!is_valid) {
+            if (memory.ptr != NULL) (void)os_memory_release(memory.ptr, memory.size);
+            memory.ptr = NULL;
+            page_size  = 0;
+        }
+        return(page_size);
     }
 
     SLD_API_INLINE void
@@ -105,6 +128,15 @@ namespace sld {
         assert(is_valid);
     }
 
+    SLD_API_INLINE void
+    memory_os_decommit(
+        memory_t& memory) {
+
+        memory_assert_valid(memory);
+        const bool did_decommit = os_memory_decommit(memory.ptr, memory.size);
+        assert(did_decommit);
+    }
+
     SLD_API_INLINE u32 
     memory_copy(
         memory_t&       memory_dst,
@@ -117,12 +149,10 @@ namespace sld {
             ? memory_src.size
             : memory_dst.size;
 
-        const errno_t error = memmove_s(
-            memory_dst.ptr, memory_dst.size,
-            memory_src.ptr, memory_src.size
-            );
-
-        assert(error == 0);
+        (void)memmove(
+            memory_dst.ptr,
+            memory_src.ptr,
+            copy_length);
 
         return(copy_length);
     }
@@ -141,7 +171,7 @@ namespace sld {
     }
 
     SLD_API_INLINE bool
-    memory_is_committed(
+    memory_is_os_committed(
         const memory_t& memory) {
 
         memory_assert_valid(memory);
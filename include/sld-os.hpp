@@ -382,7 +382,18 @@ namespace sld {
     // MEMORY
     //-------------------------------------------------------------------
 
+    enum os_memory_page_policy_e {
+        os_memory_page_policy_e_default     = 0, // base os pages
+        os_memory_page_policy_e_transparent = 1, // 2MB pages when the os can back the range with them
+        os_memory_page_policy_e_huge_2mb    = 2, // explicit 2MB pages, falls back to transparent
+        os_memory_page_policy_e_huge_1gb    = 3  // explicit 1GB pages, falls back to 2MB
+    };
+
+    constexpr u64 OS_MEMORY_PAGE_SIZE_2MB = size_megabytes(2);
+    constexpr u64 OS_MEMORY_PAGE_SIZE_1GB = size_gigabytes(1);
+
     using os_memory_reserve_f              = void* (*) (void* start, const u64 size);
+    using os_memory_reserve_huge_f         = void* (*) (void* start, const u64 size, const os_memory_page_policy_e page_policy, u64& page_size);
     using os_memory_release_f              = bool  (*) (void* start, const u64 size);
     using os_memory_commit_f               = void* (*) (void* start, const u64 size);
     using os_memory_decommit_f             = bool  (*) (void* start, const u64 size);
@@ -390,6 +401,22 @@ namespace sld {
     using os_memory_align_to_granularity_f = u64   (*) (const u64 size);
     using os_memory_is_reserved_f          = bool  (*) (void* start);
     using os_memory_is_committed_f         = bool  (*) (void* start);
+    using os_memory_map_mirrored_f         = void* (*) (const u64 size);
+    using os_memory_unmap_mirrored_f       = bool  (*) (void* start, const u64 size);
+
+    static inline u64
+    os_memory_page_policy_size(
+        const os_memory_page_policy_e page_policy) {
+
+        u64 page_size = 0;
+        switch (page_policy) {
+            case(os_memory_page_policy_e_transparent): page_size = OS_MEMORY_PAGE_SIZE_2MB; break;
+            case(os_memory_page_policy_e_huge_2mb):    page_size = OS_MEMORY_PAGE_SIZE_2MB; break;
+            case(os_memory_page_policy_e_huge_1gb):    page_size = OS_MEMORY_PAGE_SIZE_1GB; break;
+            default:                                   page_size = 0;                       break;
+        }
+        return(page_size);
+    }
 
     //-------------------------------------------------------------------
     // FILES
@@ -408,6 +435,7 @@ namespace sld {
     struct os_file_callback_context_t;
     struct os_file_os_context_t;
     struct os_file_async_context_t;
+    struct os_file_map_t;
 
     using os_file_async_callback_f = void                  (*) (const void* data, const os_file_error_t error, const u32 bytes_transferred);
     using os_file_open_f           = const os_file_error_t (*) (os_file_handle_t&      file_handle, const c8* path, const os_file_config_t& config);
@@ -416,6 +444,9 @@ namespace sld {
     using os_file_write_f          = const os_file_error_t (*) (const os_file_handle_t file_handle, os_file_buffer_t& buffer);    
     using os_file_read_async_f     = const os_file_error_t (*) (const os_file_handle_t file_handle, os_file_buffer_t& buffer, os_file_async_context_t& context);    
     using os_file_write_async_f    = const os_file_error_t (*) (const os_file_handle_t file_handle, os_file_buffer_t& buffer, os_file_async_context_t& context);    
+    using os_file_map_read_f       = const os_file_error_t (*) (const c8* path, os_file_map_t& map);
+    using os_file_unmap_f          = const os_file_error_t (*) (os_file_map_t& map);
+    using os_file_map_prefetch_f   = const os_file_error_t (*) (const os_file_map_t& map, const u64 offset, const u64 size);
 
     struct os_file_buffer_t {
         byte* data;
@@ -444,6 +475,15 @@ namespace sld {
         u32              bytes_transferred;
     };
 
+    // a whole file mapped read only. pages load on first touch and the
+    // mapping stays valid after the file handle is closed. an empty file
+    // is an empty view, data is NULL and there is nothing to unmap.
+    // prefetch asks the os to start reading a range in ahead of use
+    struct os_file_map_t {
+        const byte* data;
+        u64         size;
+    };
+
     enum os_file_access_flag_e {
         os_file_access_flag_e_none           = 0,        
         os_file_access_flag_e_read           = bit_value(0),        
@@ -524,7 +564,7 @@ namespace sld {
 
     using os_thread_callback_function_f   = void (*) (os_thread_context_t& context);
 
-    using os_thread_create_f              = const os_thread_error_t (*) (os_thread_handle_t&            thread_handle);
+    using os_thread_create_f              = const os_thread_error_t (*) (os_thread_handle_t&            thread_handle, os_thread_context_t& context);
     using os_thread_destroy_f             = const os_thread_error_t (*) (const os_thread_handle_t       thread_handle);
     using os_thread_exit_f                = const os_thread_error_t (*) (const os_thread_handle_t       thread_handle);
     using os_thread_sleep_f               = const os_thread_error_t (*) (const os_thread_handle_t       thread_handle);     
@@ -546,14 +586,17 @@ namespace sld {
         u64   size;
     };
 
+    // the new thread runs function(context) with the same context the
+    // creator passed in, so the context has to outlive the thread
     struct os_thread_context_t {
         os_thread_callback_function_f function;
         os_thread_callback_data_t     data;
     };
 
     enum os_thread_error_e {
-        os_thread_error_e_success = 1,
-        os_thread_error_e_unknown = -1
+        os_thread_error_e_success      =  1,
+        os_thread_error_e_unknown      = -1,
+        os_thread_error_e_invalid_args = -2
     };
 
     //-------------------------------------------------------------------
@@ -584,6 +627,7 @@ namespace sld {
     SLD_API_OS os_window_set_clear_color_f      os_window_set_clear_color;  
 
     SLD_API_OS os_memory_reserve_f              os_memory_reserve;
+    SLD_API_OS os_memory_reserve_huge_f         os_memory_reserve_huge;
     SLD_API_OS os_memory_release_f              os_memory_release;
     SLD_API_OS os_memory_commit_f               os_memory_commit;
     SLD_API_OS os_memory_decommit_f             os_memory_decommit;
@@ -591,6 +635,8 @@ namespace sld {
     SLD_API_OS os_memory_align_to_granularity_f os_memory_align_to_granularity;
     SLD_API_OS os_memory_is_reserved_f          os_memory_is_reserved;
     SLD_API_OS os_memory_is_committed_f         os_memory_is_committed;
+    SLD_API_OS os_memory_map_mirrored_f         os_memory_map_mirrored;
+    SLD_API_OS os_memory_unmap_mirrored_f       os_memory_unmap_mirrored;
 
     SLD_API_OS os_file_open_f                   os_file_open;
     SLD_API_OS os_file_size_f                   os_file_size;
@@ -598,6 +644,9 @@ namespace sld {
     SLD_API_OS os_file_write_f                  os_file_write;
     SLD_API_OS os_file_read_async_f             os_file_read_async;
     SLD_API_OS os_file_write_async_f            os_file_write_async;
+    SLD_API_OS os_file_map_read_f               os_file_map_read;
+    SLD_API_OS os_file_unmap_f                  os_file_unmap;
+    SLD_API_OS os_file_map_prefetch_f           os_file_map_prefetch;
 
     SLD_API_OS os_thread_create_f               os_thread_create;
     SLD_API_OS os_thread_destroy_f              os_thread_destroy;
@@ -0,0 +1,307 @@
+#ifndef SLD_PERFECT_HASH_HPP
+#define SLD_PERFECT_HASH_HPP
+
+#include "sld.hpp"
+
+#define SLD_PERFECT_HASH_TEMPLATE template<u32 key_count> inline constexpr
+
+#ifndef    SLD_PERFECT_HASH_SEED_ATTEMPTS
+#   define SLD_PERFECT_HASH_SEED_ATTEMPTS     16
+#endif
+#ifndef    SLD_PERFECT_HASH_DISPLACE_ATTEMPTS
+#   define SLD_PERFECT_HASH_DISPLACE_ATTEMPTS 4096
+#endif
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // API
+    //-------------------------------------------------------------------
+
+    // a collision free table over a fixed list of strings, built entirely
+    // at compile time with hash and displace. every key hashes once. the
+    // high half of the hash picks a bucket, the low half mixed with that
+    // bucket's displacement picks the slot, and the builder searches for
+    // displacements, largest buckets first, until no two keys share a
+    // slot. a lookup is one hash, one table read and one string compare,
+    // and returns the key's position in the list it was built from, so
+    // the list can be ordered to match an enum.
+    //
+    //     constexpr const cchar* NAMES[] = { "node", "attrib", "text" };
+    //     constexpr auto         TABLE   = perfect_hash_build(NAMES);
+    //     static_assert(TABLE.is_valid);
+    //     const u32 index = perfect_hash_find(TABLE, name, name_length);
+    //
+    // the search runs in the compiler, so it suits key sets in the
+    // hundreds. larger sets may need a higher constexpr step limit
+    template<u32 key_count>
+    struct perfect_hash_t {
+        static constexpr u32 bucket_count = (u32)size_round_up_pow2((key_count + 1) / 2);
+        static constexpr u32 slot_count   = (u32)size_round_up_pow2(key_count + (key_count / 4) + 1);
+
+        bool         is_valid;
+        u64          seed;
+        const cchar* keys         [key_count];
+        u32          key_lengths  [key_count];
+        u32          bucket_seeds [bucket_count];
+        u32          slot_keys    [slot_count];
+    };
+
+    constexpr u32 PERFECT_HASH_INDEX_INVALID = 0xFFFFFFFF;
+
+    SLD_UTILITY u32                     perfect_hash_string_length (const cchar* key);
+    SLD_UTILITY u64                     perfect_hash_string        (const cchar* key, const u32 length, const u64 seed);
+    SLD_UTILITY u32                     perfect_hash_slot          (const u64 hash, const u32 bucket_seed, const u32 slot_count);
+    SLD_UTILITY bool                    perfect_hash_string_equal  (const cchar* a, const cchar* b, const u32 length);
+    SLD_PERFECT_HASH_TEMPLATE perfect_hash_t<key_count> perfect_hash_build (const cchar* const (&keys)[key_count]);
+    SLD_PERFECT_HASH_TEMPLATE u32                       perfect_hash_find  (const perfect_hash_t<key_count>& table, const cchar* key, const u32 length);
+    SLD_PERFECT_HASH_TEMPLATE u32                       perfect_hash_find  (const perfect_hash_t<key_count>& table, const cchar* key);
+
+    //-------------------------------------------------------------------
+    // INLINE METHODS
+    //-------------------------------------------------------------------
+
+    SLD_UTILITY u32
+    perfect_hash_string_length(
+        const cchar* key) {
+
+        u32 length = 0;
+        while (key[length] != 0) ++length;
+        return(length);
+    }
+
+    SLD_UTILITY u64
+    perfect_hash_string(
+        const cchar* key,
+        const u32    length,
+        const u64    seed) {
+
+        // fnv-1a, then a finalizer so both halves are well mixed
+        u64 hash = (0xCBF29CE484222325 ^ seed);
+        for (
+            u32 index = 0;
+                index < length;
+              ++index) {
+
+            hash ^= (u8)key[index];
+            hash *= 0x00000100000001B3;
+        }
+
+        hash ^= (hash >> 33);
+        hash *= 0xFF51AFD7ED558CCD;
+        hash ^= (hash >> 33);
+        hash *= 0xC4CEB9FE1A85EC53;
+        hash ^= (hash >> 33);
+        return(hash);
+    }
+
+    SLD_UTILITY u32
+    perfect_hash_slot(
+        const u64 hash,
+        const u32 bucket_seed,
+        const u32 slot_count) {
+
+        u32 slot = ((u32)hash ^ bucket_seed);
+        slot ^= (slot >> 16);
+        slot *= 0x7FEB352D;
+        slot ^= (slot >> 15);
+        slot *= 0x846CA68B;
+        slot ^= (slot >> 16);
+        return(slot & (slot_count - 1));
+    }
+
+    SLD_UTILITY bool
+    perfect_hash_string_equal(
+        const cchar* a,
+        const cchar* b,
+        const u32    length) {
+
+        for (
+            u32 index = 0;
+                index < length;
+              ++index) {
+
+            if (a[index] != b[index]) return(false);
+        }
+        return(true);
+    }
+
+    SLD_PERFECT_HASH_TEMPLATE perfect_hash_t<key_count>
+    perfect_hash_build(
+        const cchar* const (&keys)[key_count]) {
+
+        using table_t = perfect_hash_t<key_count>;
+        constexpr u32 bucket_count = table_t::bucket_count;
+        constexpr u32 slot_count   = table_t::slot_count;
+
+        table_t table = {};
+        for (
+            u32 index = 0;
+                index < key_count;
+              ++index) {
+
+            table.keys[index]        = keys[index];
+            table.key_lengths[index] = perfect_hash_string_length(keys[index]);
+        }
+
+        u64 hashes        [key_count]        = {};
+        u32 bucket_keys   [key_count]        = {};
+        u32 bucket_start  [bucket_count + 1] = {};
+        u32 bucket_order  [bucket_count]     = {};
+        u32 bucket_fill   [bucket_count]     = {};
+        u32 bucket_slots  [key_count]        = {};
+
+        // a failed search usually means two keys agree on every bit we
+        // use, a new seed reshuffles everything
+        for (
+            u64 seed = 0;
+                seed < SLD_PERFECT_HASH_SEED_ATTEMPTS;
+              ++seed) {
+
+            // hash every key and sort them by bucket
+            for (u32 bucket = 0; bucket <= bucket_count; ++bucket) bucket_start[bucket] = 0;
+            for (
+                u32 index = 0;
+                    index < key_count;
+                  ++index) {
+
+                hashes[index] = perfect_hash_string(keys[index], table.key_lengths[index], seed);
+                const u32 bucket = (u32)(hashes[index] >> 32) & (bucket_count - 1);
+                ++bucket_start[bucket + 1];
+            }
+
+            u32 size_max = 0;
+            for (
+                u32 bucket = 0;
+                    bucket < bucket_count;
+                  ++bucket) {
+
+                if (bucket_start[bucket + 1] > size_max) size_max = bucket_start[bucket + 1];
+                bucket_start[bucket + 1] += bucket_start[bucket];
+                bucket_fill[bucket]       = bucket_start[bucket];
+            }
+
+            for (
+                u32 index = 0;
+                    index < key_count;
+                  ++index) {
+
+                const u32 bucket = (u32)(hashes[index] >> 32) & (bucket_count - 1);
+                bucket_keys[bucket_fill[bucket]++] = index;
+            }
+
+            // biggest buckets first, while the table is still empty
+            u32 order_count = 0;
+            for (
+                u32 size = size_max;
+                    size > 0;
+                  --size) {
+
+                for (
+                    u32 bucket = 0;
+                        bucket < bucket_count;
+                      ++bucket) {
+
+                    const u32 bucket_size = (bucket_start[bucket + 1] - bucket_start[bucket]);
+                    if (bucket_size == size) bucket_order[order_count++] = bucket;
+                }
+            }
+
+            for (u32 slot   = 0; slot   < slot_count;   ++slot)   table.slot_keys[slot]      = PERFECT_HASH_INDEX_INVALID;
+            for (u32 bucket = 0; bucket < bucket_count; ++bucket) table.bucket_seeds[bucket] = 0;
+
+            // find a displacement that drops the whole bucket into free
+            // slots that are also distinct from each other
+            bool did_place_all = true;
+            for (
+                u32 order = 0;
+                    order < order_count && did_place_all;
+                  ++order) {
+
+                const u32 bucket      = bucket_order[order];
+                const u32 first       = bucket_start[bucket];
+                const u32 bucket_size = (bucket_start[bucket + 1] - first);
+
+                bool did_place = false;
+                for (
+                    u32 bucket_seed = 0;
+                        bucket_seed < SLD_PERFECT_HASH_DISPLACE_ATTEMPTS && !did_place;
+                      ++bucket_seed) {
+
+                    did_place = true;
+                    for (
+                        u32 member = 0;
+                            member < bucket_size && did_place;
+                          ++member) {
+
+                        const u32 slot = perfect_hash_slot(hashes[bucket_keys[first + member]], bucket_seed, slot_count);
+                        did_place &= (table.slot_keys[slot] == PERFECT_HASH_INDEX_INVALID);
+                        for (
+                            u32 other = 0;
+                                other < member && did_place;
+                              ++other) {
+
+                            did_place &= (bucket_slots[other] != slot);
+                        }
+                        bucket_slots[member] = slot;
+                    }
+
+                    if (did_place) {
+                        table.bucket_seeds[bucket] = bucket_seed;
+                        for (
+                            u32 member = 0;
+                                member < bucket_size;
+                              ++member) {
+
+                            table.slot_keys[bucket_slots[member]] = bucket_keys[first + member];
+                        }
+                    }
+                }
+                did_place_all &= did_place;
+            }
+
+            if (did_place_all) {
+                table.seed     = seed;
+                table.is_valid = true;
+                return(table);
+            }
+        }
+
+        // duplicate keys land here, they can never be separated
+        table.is_valid = false;
+        return(table);
+    }
+
+    SLD_PERFECT_HASH_TEMPLATE u32
+    perfect_hash_find(
+        const perfect_hash_t<key_count>& table,
+        const cchar*                     key,
+        const u32                        length) {
+
+        using table_t = perfect_hash_t<key_count>;
+
+        // the slot can only hold this key, one compare says if it is
+        const u64 hash   = perfect_hash_string(key, length, table.seed);
+        const u32 bucket = (u32)(hash >> 32) & (table_t::bucket_count - 1);
+        const u32 slot   = perfect_hash_slot(hash, table.bucket_seeds[bucket], table_t::slot_count);
+        const u32 index  = table.slot_keys[slot];
+
+        const bool is_match = (index != PERFECT_HASH_INDEX_INVALID)
+            && (table.key_lengths[index] == length)
+            && perfect_hash_string_equal(table.keys[index], key, length);
+
+        return(is_match ? index : PERFECT_HASH_INDEX_INVALID);
+    }
+
+    SLD_PERFECT_HASH_TEMPLATE u32
+    perfect_hash_find(
+        const perfect_hash_t<key_count>& table,
+        const cchar*                     key) {
+
+        const u32 length = perfect_hash_string_length (key);
+        const u32 index  = perfect_hash_find          (table, key, length);
+        return(index);
+    }
+};
+
+#endif //SLD_PERFECT_HASH_HPP
\ No newline at end of file
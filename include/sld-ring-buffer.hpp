@@ -0,0 +1,213 @@
+#ifndef SLD_RING_BUFFER_HPP
+#define SLD_RING_BUFFER_HPP
+
+#include "sld-memory.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // API
+    //-------------------------------------------------------------------
+
+    // the same physical pages are mapped twice back to back, so a span
+    // that runs past the end of the first mapping just keeps going into
+    // the second one. any read or write of up to capacity bytes is one
+    // contiguous range and nothing is ever copied across the wrap.
+    // read and write are running totals, masked into the buffer on use
+    struct ring_buffer_t {
+        memory_t memory;
+        u64      capacity;
+        u64      read;
+        u64      write;
+    };
+
+    SLD_API_INLINE bool     ring_buffer_reserve_os_memory (ring_buffer_t*       ring, const u64 capacity);
+    SLD_API_INLINE void     ring_buffer_release_os_memory (ring_buffer_t*       ring);
+    SLD_API_INLINE bool     ring_buffer_is_valid          (const ring_buffer_t* ring);
+    SLD_API_INLINE void     ring_buffer_assert_valid      (const ring_buffer_t* ring);
+    SLD_API_INLINE void     ring_buffer_reset             (ring_buffer_t*       ring);
+    SLD_API_INLINE u64      ring_buffer_get_size_used     (const ring_buffer_t* ring);
+    SLD_API_INLINE u64      ring_buffer_get_size_free     (const ring_buffer_t* ring);
+    SLD_API_INLINE memory_t ring_buffer_get_read_span     (const ring_buffer_t* ring);
+    SLD_API_INLINE memory_t ring_buffer_get_write_span    (const ring_buffer_t* ring);
+    SLD_API_INLINE void     ring_buffer_commit_read       (ring_buffer_t*       ring, const u64 size);
+    SLD_API_INLINE void     ring_buffer_commit_write      (ring_buffer_t*       ring, const u64 size);
+    SLD_API_INLINE bool     ring_buffer_read              (ring_buffer_t*       ring, void*       data, const u64 size);
+    SLD_API_INLINE bool     ring_buffer_write             (ring_buffer_t*       ring, const void* data, const u64 size);
+
+    //-------------------------------------------------------------------
+    // INLINE METHODS
+    //-------------------------------------------------------------------
+
+    SLD_API_INLINE bool
+    ring_buffer_reserve_os_memory(
+        ring_buffer_t* ring,
+        const u64      capacity) {
+
+        bool can_reserve = true;
+        can_reserve &= (ring     != NULL);
+        can_reserve &= (capacity != 0);
+        assert(can_reserve);
+
+        // the mirror has to start on the allocation granularity, and a
+        // power of two capacity lets us mask instead of divide
+        const u64 capacity_aligned = size_round_up_pow2(os_memory_align_to_granularity(capacity));
+
+        void* memory = os_memory_map_mirrored(capacity_aligned);
+        if (memory == NULL) return(false);
+
+        ring->memory.ptr  = memory;
+        ring->memory.size = (capacity_aligned * 2);
+        ring->capacity    = capacity_aligned;
+        ring->read        = 0;
+        ring->write       = 0;
+        ring_buffer_assert_valid(ring);
+        return(true);
+    }
+
+    SLD_API_INLINE void
+    ring_buffer_release_os_memory(
+        ring_buffer_t* ring) {
+
+        ring_buffer_assert_valid(ring);
+
+        const bool did_release = os_memory_unmap_mirrored(ring->memory.ptr, ring->capacity);
+        assert(did_release);
+
+        ring->memory.ptr  = NULL;
+        ring->memory.size = 0;
+        ring->capacity    = 0;
+        ring->read        = 0;
+        ring->write       = 0;
+    }
+
+    SLD_API_INLINE bool
+    ring_buffer_is_valid(
+        const ring_buffer_t* ring) {
+
+        bool is_valid = (ring != NULL);
+        if (is_valid) {
+
+            is_valid &= memory_is_valid(ring->memory);
+            is_valid &= size_is_pow_2(ring->capacity);
+            is_valid &= (ring->memory.size == (ring->capacity * 2));
+            is_valid &= (ring->read  <= ring->write);
+            is_valid &= ((ring->write - ring->read) <= ring->capacity);
+        }
+        return(is_valid);
+    }
+
+    SLD_API_INLINE void
+    ring_buffer_assert_valid(
+        const ring_buffer_t* ring) {
+
+        assert(ring_buffer_is_valid(ring));
+    }
+
+    SLD_API_INLINE void
+    ring_buffer_reset(
+        ring_buffer_t* ring) {
+
+        ring_buffer_assert_valid(ring);
+        ring->read  = 0;
+        ring->write = 0;
+    }
+
+    SLD_API_INLINE u64
+    ring_buffer_get_size_used(
+        const ring_buffer_t* ring) {
+
+        ring_buffer_assert_valid(ring);
+        const u64 size_used = (ring->write - ring->read);
+        return(size_used);
+    }
+
+    SLD_API_INLINE u64
+    ring_buffer_get_size_free(
+        const ring_buffer_t* ring) {
+
+        ring_buffer_assert_valid(ring);
+        const u64 size_free = ring->capacity - (ring->write - ring->read);
+        return(size_free);
+    }
+
+    SLD_API_INLINE memory_t
+    ring_buffer_get_read_span(
+        const ring_buffer_t* ring) {
+
+        ring_buffer_assert_valid(ring);
+
+        // everything written and not yet read, in one piece
+        memory_t span;
+        span.addr = ring->memory.addr + (addr)(ring->read & (ring->capacity - 1));
+        span.size = (ring->write - ring->read);
+        return(span);
+    }
+
+    SLD_API_INLINE memory_t
+    ring_buffer_get_write_span(
+        const ring_buffer_t* ring) {
+
+        ring_buffer_assert_valid(ring);
+
+        // all the free space, in one piece
+        memory_t span;
+        span.addr = ring->memory.addr + (addr)(ring->write & (ring->capacity - 1));
+        span.size = ring->capacity - (ring->write - ring->read);
+        return(span);
+    }
+
+    SLD_API_INLINE void
+    ring_buffer_commit_read(
+        ring_buffer_t* ring,
+        const u64      size) {
+
+        ring_buffer_assert_valid(ring);
+        assert(size <= ring_buffer_get_size_used(ring));
+        ring->read += size;
+    }
+
+    SLD_API_INLINE void
+    ring_buffer_commit_write(
+        ring_buffer_t* ring,
+        const u64      size) {
+
+        ring_buffer_assert_valid(ring);
+        assert(size <= ring_buffer_get_size_free(ring));
+        ring->write += size;
+    }
+
+    SLD_API_INLINE bool
+    ring_buffer_read(
+        ring_buffer_t* ring,
+        void*          data,
+        const u64      size) {
+
+        bool can_read = (data != NULL);
+        can_read &= (size <= ring_buffer_get_size_used(ring));
+        if (!can_read) return(false);
+
+        const memory_t span = ring_buffer_get_read_span(ring);
+        (void)memcpy(data, span.ptr, size);
+        ring->read += size;
+        return(true);
+    }
+
+    SLD_API_INLINE bool
+    ring_buffer_write(
+        ring_buffer_t* ring,
+        const void*    data,
+        const u64      size) {
+
+        bool can_write = (data != NULL);
+        can_write &= (size <= ring_buffer_get_size_free(ring));
+        if (!can_write) return(false);
+
+        const memory_t span = ring_buffer_get_write_span(ring);
+        (void)memcpy(span.ptr, data, size);
+        ring->write += size;
+        return(true);
+    }
+};
+
+#endif //SLD_RING_BUFFER_HPP
\ No newline at end of file
@@ -9,6 +9,15 @@
 #    include <intrin.h>
 # else
 #    include <x86intrin.h>
+#    include <cpuid.h>
+# endif
+
+// msvc lets any function use any instruction set, gcc and clang need
+// kernels for wider sets marked so they can be dispatched at runtime
+# if defined(_MSC_VER) && !defined(__clang__)
+#    define SLD_SIMD_TARGET(isa)
+# else
+#    define SLD_SIMD_TARGET(isa) __attribute__((target(isa)))
 # endif
 
 #include "sld.hpp"
@@ -32,6 +41,131 @@ namespace sld {
     typedef __m128  reg_f128_t;
     typedef __m128i reg_u128_t;
 
+    //-------------------------------------------------------------------
+    // CPU FEATURES
+    //-------------------------------------------------------------------
+
+    // the widest instruction set both the cpu and the os support, checked
+    // once. kernels for wider sets are picked with this at runtime
+    enum simd_level_e {
+        simd_level_e_sse2   = 0,
+        simd_level_e_avx2   = 1,
+        simd_level_e_avx512 = 2
+    };
+
+    SLD_INLINE          simd_level_e simd_get_level    (void);
+    SLD_INLINE          bool         simd_has_sse42    (void);
+    SLD_INLINE          bool         simd_has_vaes     (void);
+    SLD_INTERNAL_INLINE void         simd_cpuid        (const u32 leaf, const u32 subleaf, u32 registers[4]);
+    SLD_INTERNAL_INLINE u64          simd_xgetbv       (void);
+    SLD_INTERNAL_INLINE simd_level_e simd_detect_level (void);
+    SLD_INTERNAL_INLINE bool         simd_detect_sse42 (void);
+    SLD_INTERNAL_INLINE bool         simd_detect_vaes  (void);
+
+    SLD_INTERNAL_INLINE void
+    simd_cpuid(
+        const u32 leaf,
+        const u32 subleaf,
+        u32       registers[4]) {
+
+    # if defined(_MSC_VER)
+        __cpuidex((int*)registers, (int)leaf, (int)subleaf);
+    # else
+        __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+    # endif
+    }
+
+    SLD_INTERNAL_INLINE u64
+    simd_xgetbv(
+        void) {
+
+    # if defined(_MSC_VER)
+        return(_xgetbv(0));
+    # else
+        u32 low  = 0;
+        u32 high = 0;
+        __asm__ volatile ("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+        return(((u64)high << 32) | low);
+    # endif
+    }
+
+    SLD_INTERNAL_INLINE simd_level_e
+    simd_detect_level(
+        void) {
+
+        u32 registers[4] = {0};
+        simd_cpuid(0, 0, registers);
+        const u32 leaf_max = registers[0];
+        if (leaf_max < 7) return(simd_level_e_sse2);
+
+        // the os has to save the wide registers too
+        simd_cpuid(1, 0, registers);
+        const bool has_osxsave = (registers[2] & bit_value(27)) != 0;
+        const bool has_avx     = (registers[2] & bit_value(28)) != 0;
+        if (!has_osxsave || !has_avx) return(simd_level_e_sse2);
+
+        const u64  xcr0          = simd_xgetbv();
+        const bool os_has_avx    = ((xcr0 & 0x06) == 0x06);
+        const bool os_has_avx512 = ((xcr0 & 0xE6) == 0xE6);
+
+        simd_cpuid(7, 0, registers);
+        const bool has_avx2    = (registers[1] & bit_value(5))  != 0;
+        const bool has_avx512f = (registers[1] & bit_value(16)) != 0;
+
+        if (os_has_avx512 && has_avx512f && has_avx2) return(simd_level_e_avx512);
+        if (os_has_avx    && has_avx2)                return(simd_level_e_avx2);
+        return(simd_level_e_sse2);
+    }
+
+    SLD_INLINE simd_level_e
+    simd_get_level(
+        void) {
+
+        static const simd_level_e level = simd_detect_level();
+        return(level);
+    }
+
+    SLD_INTERNAL_INLINE bool
+    simd_detect_sse42(
+        void) {
+
+        // sse4.2 brings the crc32c instruction
+        u32 registers[4] = {0};
+        simd_cpuid(1, 0, registers);
+        const bool has_sse42 = (registers[2] & bit_value(20)) != 0;
+        return(has_sse42);
+    }
+
+    SLD_INLINE bool
+    simd_has_sse42(
+        void) {
+
+        static const bool has_sse42 = simd_detect_sse42();
+        return(has_sse42);
+    }
+
+    SLD_INTERNAL_INLINE bool
+    simd_detect_vaes(
+        void) {
+
+        // only used on 512 bit registers, so it rides on the avx512 level
+        if (simd_get_level() != simd_level_e_avx512) return(false);
+
+        u32 registers[4] = {0};
+        simd_cpuid(7, 0, registers);
+        const bool has_avx512bw = (registers[1] & bit_value(30)) != 0;
+        const bool has_vaes     = (registers[2] & bit_value(9))  != 0;
+        return(has_avx512bw && has_vaes);
+    }
+
+    SLD_INLINE bool
+    simd_has_vaes(
+        void) {
+
+        static const bool has_vaes = simd_detect_vaes();
+        return(has_vaes);
+    }
+
     //-------------------------------------------------------------------
     // f128 | 4 x f32 | __m128
     //-------------------------------------------------------------------
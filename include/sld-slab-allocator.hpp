@@ -0,0 +1,322 @@
+#ifndef SLD_SLAB_ALLOCATOR_HPP
+#define SLD_SLAB_ALLOCATOR_HPP
+
+#include "sld-memory.hpp"
+#include "sld-block-allocator.hpp"
+
+#ifndef    SLD_SLAB_CLASS_COUNT_MAX
+#   define SLD_SLAB_CLASS_COUNT_MAX 16
+#endif
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // API
+    //-------------------------------------------------------------------
+
+    // every slab is one block from the block allocator, carved into
+    // objects of a single size class. the slab header sits at the start
+    // of the block, so freeing an object finds its slab from the block
+    // index. objects are handed out from a bump index first and then
+    // from an intrusive free list, so untouched objects cost nothing
+    struct slab_t {
+        slab_t* next;
+        slab_t* prev;
+        void*   free_head;
+        u32     class_index;
+        u32     object_count;
+        u32     used_count;
+        u32     bump_index;
+    };
+
+    // partial holds every slab of the class that has a free object
+    struct slab_class_t {
+        u32     object_size;
+        u32     object_count;
+        u32     slab_count;
+        u32     partial_count;
+        slab_t* partial;
+    };
+
+    constexpr u32 SLAB_HEADER_SIZE         = 64;
+    constexpr u32 SLAB_OBJECT_ALIGNMENT    = 8;
+    constexpr u32 SLAB_SMALL_SIZE_MAX      = 256;
+    constexpr u32 SLAB_SMALL_LOOKUP_COUNT  = (SLAB_SMALL_SIZE_MAX / SLAB_OBJECT_ALIGNMENT) + 1;
+    constexpr u32 SLAB_CLASS_INDEX_INVALID = 0xFF;
+    constexpr u32 SLAB_DEFAULT_CLASS_SIZES[] = { 16, 32, 64, 128, 256, 512, 1024, 2048 };
+
+    static_assert(sizeof(slab_t) <= SLAB_HEADER_SIZE, "slab header doesn't fit");
+
+    struct slab_allocator_t {
+        block_allocator_t blocks;
+        u32               class_count;
+        slab_class_t      classes       [SLD_SLAB_CLASS_COUNT_MAX];
+        u8                small_classes [SLAB_SMALL_LOOKUP_COUNT];
+    };
+
+    SLD_API_INLINE          void    slab_allocator_reserve_os_memory (slab_allocator_t* alctr, const u32 size_total, const u32 size_slab, const u32* class_sizes = NULL, const u32 class_count = 0);
+    SLD_API_INLINE          void    slab_allocator_release_os_memory (slab_allocator_t* alctr);
+    SLD_API_INLINE          bool    slab_allocator_is_valid          (const slab_allocator_t* alctr);
+    SLD_API_INLINE          void    slab_allocator_assert_valid      (const slab_allocator_t* alctr);
+    SLD_API_INLINE          u32     slab_allocator_get_class_index   (const slab_allocator_t* alctr, const u32 size);
+    SLD_API_INLINE          slab_t* slab_allocator_get_slab          (const slab_allocator_t* alctr, const void* object);
+    SLD_API_INLINE          void*   slab_allocator_alloc             (slab_allocator_t* alctr, const u32 size);
+    SLD_API_INLINE_TEMPLATE type*   slab_allocator_alloc_struct      (slab_allocator_t* alctr);
+    SLD_API_INLINE          void    slab_allocator_free              (slab_allocator_t* alctr, void* object);
+
+    //-------------------------------------------------------------------
+    // INLINE METHODS
+    //-------------------------------------------------------------------
+
+    SLD_API_INLINE void
+    slab_allocator_reserve_os_memory(
+        slab_allocator_t* alctr,
+        const u32         size_total,
+        const u32         size_slab,
+        const u32*        class_sizes,
+        const u32         class_count) {
+
+        // default to power of two classes
+        const u32* sizes = class_sizes;
+        u32        count = class_count;
+        if (sizes == NULL) {
+            sizes = SLAB_DEFAULT_CLASS_SIZES;
+            count = sizeof(SLAB_DEFAULT_CLASS_SIZES) / sizeof(u32);
+        }
+
+        // check args
+        bool can_acquire = true;
+        can_acquire &= (alctr != NULL);
+        can_acquire &= (count != 0);
+        can_acquire &= (count <= SLD_SLAB_CLASS_COUNT_MAX);
+        can_acquire &= (count <  SLAB_CLASS_INDEX_INVALID);
+        assert(can_acquire);
+
+        const bool did_reserve = block_allocator_reserve_os_memory(&alctr->blocks, size_total, size_slab);
+        assert(did_reserve);
+        const u32 size_objects = (alctr->blocks.block_size - SLAB_HEADER_SIZE);
+
+        // classes have to be sorted and at least one object has to fit
+        alctr->class_count = count;
+        for (
+            u32 class_index = 0;
+                class_index < count;
+              ++class_index) {
+
+            const u32 object_size = (u32)size_align_pow_2(sizes[class_index], SLAB_OBJECT_ALIGNMENT);
+
+            bool is_class_valid = true;
+            is_class_valid &= (object_size != 0);
+            is_class_valid &= (object_size <= size_objects);
+            is_class_valid &= (class_index == 0 || object_size > alctr->classes[class_index - 1].object_size);
+            assert(is_class_valid);
+
+            slab_class_t& slab_class = alctr->classes[class_index];
+            slab_class.object_size   = object_size;
+            slab_class.object_count  = (size_objects / object_size);
+            slab_class.slab_count    = 0;
+            slab_class.partial_count = 0;
+            slab_class.partial       = NULL;
+        }
+
+        // small sizes map straight to their class
+        u32 class_index = 0;
+        for (
+            u32 small_index = 0;
+                small_index < SLAB_SMALL_LOOKUP_COUNT;
+              ++small_index) {
+
+            const u32 size = (small_index * SLAB_OBJECT_ALIGNMENT);
+            while (class_index < count && alctr->classes[class_index].object_size < size) {
+                ++class_index;
+            }
+            alctr->small_classes[small_index] = (class_index < count)
+                ? (u8)class_index
+                : (u8)SLAB_CLASS_INDEX_INVALID;
+        }
+
+        slab_allocator_assert_valid(alctr);
+    }
+
+    SLD_API_INLINE void
+    slab_allocator_release_os_memory(
+        slab_allocator_t* alctr) {
+
+        slab_allocator_assert_valid(alctr);
+        block_allocator_release_os_memory(&alctr->blocks);
+        alctr->class_count = 0;
+    }
+
+    SLD_API_INLINE bool
+    slab_allocator_is_valid(
+        const slab_allocator_t* alctr) {
+
+        bool is_valid = (alctr != NULL);
+        if (is_valid) {
+
+            is_valid &= block_allocator_is_valid(&alctr->blocks);
+            is_valid &= (alctr->class_count != 0);
+            is_valid &= (alctr->class_count <= SLD_SLAB_CLASS_COUNT_MAX);
+        }
+        return(is_valid);
+    }
+
+    SLD_API_INLINE void
+    slab_allocator_assert_valid(
+        const slab_allocator_t* alctr) {
+
+        assert(slab_allocator_is_valid(alctr));
+    }
+
+    SLD_API_INLINE u32
+    slab_allocator_get_class_index(
+        const slab_allocator_t* alctr,
+        const u32               size) {
+
+        // small objects take the lookup, everything else scans the classes
+        if (size <= SLAB_SMALL_SIZE_MAX) {
+            const u32 small_index = (size + SLAB_OBJECT_ALIGNMENT - 1) / SLAB_OBJECT_ALIGNMENT;
+            return(alctr->small_classes[small_index]);
+        }
+
+        u32 class_index = SLAB_CLASS_INDEX_INVALID;
+        for (
+            u32 index = 0;
+                index < alctr->class_count;
+              ++index) {
+
+            if (alctr->classes[index].object_size >= size) {
+                class_index = index;
+                break;
+            }
+        }
+        return(class_index);
+    }
+
+    SLD_API_INLINE slab_t*
+    slab_allocator_get_slab(
+        const slab_allocator_t* alctr,
+        const void*             object) {
+
+        const block_allocator_t* blocks      = &alctr->blocks;
+        const u32                block_index = block_allocator_get_block_index(blocks, object);
+        slab_t*                  slab        = (slab_t*)(blocks->memory.addr + ((u64)block_index * blocks->block_size));
+        return(slab);
+    }
+
+    SLD_API_INLINE void*
+    slab_allocator_alloc(
+        slab_allocator_t* alctr,
+        const u32         size) {
+
+        slab_allocator_assert_valid(alctr);
+
+        const u32 class_index = slab_allocator_get_class_index(alctr, size);
+        if (class_index == SLAB_CLASS_INDEX_INVALID) return(NULL);
+        slab_class_t& slab_class = alctr->classes[class_index];
+
+        // start a new slab if every slab of this class is full
+        slab_t* slab = slab_class.partial;
+        if (slab == NULL) {
+
+            slab = (slab_t*)block_allocator_commit(&alctr->blocks);
+            if (slab == NULL) return(NULL);
+
+            slab->next         = NULL;
+            slab->prev         = NULL;
+            slab->free_head    = NULL;
+            slab->class_index  = class_index;
+            slab->object_count = slab_class.object_count;
+            slab->used_count   = 0;
+            slab->bump_index   = 0;
+
+            slab_class.partial = slab;
+            ++slab_class.partial_count;
+            ++slab_class.slab_count;
+        }
+
+        // reuse a freed object before touching new ones
+        void* object = slab->free_head;
+        if (object != NULL) {
+            slab->free_head = *(void**)object;
+        }
+        else {
+            assert(slab->bump_index < slab->object_count);
+            object = (void*)((addr)slab + SLAB_HEADER_SIZE + ((u64)slab->bump_index * slab_class.object_size));
+            ++slab->bump_index;
+        }
+        ++slab->used_count;
+
+        // full slabs leave the partial list until something is freed
+        if (slab->used_count == slab->object_count) {
+            slab_class.partial = slab->next;
+            if (slab->next) slab->next->prev = NULL;
+            slab->next = NULL;
+            --slab_class.partial_count;
+        }
+
+        return(object);
+    }
+
+    SLD_API_INLINE_TEMPLATE type*
+    slab_allocator_alloc_struct(
+        slab_allocator_t* alctr) {
+
+        static_assert(alignof(type) <= SLAB_OBJECT_ALIGNMENT, "slab objects are only 8 byte aligned");
+        type* ptr = (type*)slab_allocator_alloc(alctr, sizeof(type));
+        return(ptr);
+    }
+
+    SLD_API_INLINE void
+    slab_allocator_free(
+        slab_allocator_t* alctr,
+        void*             object) {
+
+        slab_allocator_assert_valid(alctr);
+
+        bool can_free = (object != NULL);
+        can_free &= ((addr)object >= alctr->blocks.memory.addr);
+        can_free &= ((addr)object <  (alctr->blocks.memory.addr + (addr)alctr->blocks.memory.size));
+        assert(can_free);
+
+        slab_t*       slab       = slab_allocator_get_slab(alctr, object);
+        slab_class_t& slab_class = alctr->classes[slab->class_index];
+
+        // make sure the object is on a boundary of this slab
+        const u64 object_offset = ((addr)object - ((addr)slab + SLAB_HEADER_SIZE));
+        can_free &= ((addr)object >= ((addr)slab + SLAB_HEADER_SIZE));
+        can_free &= ((object_offset % slab_class.object_size) == 0);
+        can_free &= (slab->used_count != 0);
+        assert(can_free);
+
+        // a full slab has space again
+        const bool was_full = (slab->used_count == slab->object_count);
+        if (was_full) {
+            slab->prev = NULL;
+            slab->next = slab_class.partial;
+            if (slab_class.partial) slab_class.partial->prev = slab;
+            slab_class.partial = slab;
+            ++slab_class.partial_count;
+        }
+
+        *(void**)object = slab->free_head;
+        slab->free_head = object;
+        --slab->used_count;
+
+        // give empty slabs back, but keep one around so a class that
+        // hovers at a slab boundary doesn't commit and decommit every call
+        const bool can_release = (slab->used_count == 0 && slab_class.partial_count > 1);
+        if (can_release) {
+
+            if (slab->prev) slab->prev->next  = slab->next;
+            else            slab_class.partial = slab->next;
+            if (slab->next) slab->next->prev  = slab->prev;
+            --slab_class.partial_count;
+            --slab_class.slab_count;
+
+            block_allocator_decommit(&alctr->blocks, slab);
+        }
+    }
+};
+
+#endif //SLD_SLAB_ALLOCATOR_HPP
\ No newline at end of file
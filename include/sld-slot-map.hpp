@@ -0,0 +1,403 @@
+#ifndef SLD_SLOT_MAP_HPP
+#define SLD_SLOT_MAP_HPP
+
+#include <new>
+#include "sld.hpp"
+#include "sld-memory.hpp"
+#include "sld-arena.hpp"
+
+#define SLD_SLOT_MAP_IMPL_INLINE template<typename t> inline auto slot_map_t<t>::
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // SLOT MAP
+    //-------------------------------------------------------------------
+
+    // values are packed at the front of a dense array so iterating is a
+    // linear walk. handles point at a slot instead, and the slot knows
+    // where its value lives, so removing swaps the last value into the
+    // hole and only that value's slot has to change. the generation
+    // goes up on every insert and remove, so it is odd while the slot is
+    // live and a handle to a removed value never matches again
+
+    constexpr u32 SLOT_MAP_INDEX_INVALID = 0xFFFFFFFF;
+
+    struct slot_map_handle_t {
+        u32 index;
+        u32 generation;
+    };
+
+    struct slot_map_slot_t {
+        u32 dense_index;
+        u32 generation;
+    };
+
+    constexpr slot_map_handle_t SLOT_MAP_HANDLE_INVALID = { SLOT_MAP_INDEX_INVALID, 0 };
+
+    template<typename t>
+    struct slot_map_t {
+
+        t*               data;
+        u32*             dense_slots;
+        slot_map_slot_t* slots;
+        u32              capacity;
+        u32              count;
+        u32              slot_count;
+        u32              free_head;
+        struct {
+            arena_t*     data;
+            arena_t*     dense_slots;
+            arena_t*     slots;
+        } arenas;
+
+        inline static u64            memory_size            (const u32 capacity);
+        inline static slot_map_t<t>* init_from_memory       (const memory_t& memory);
+        inline bool                  init_reserve_os_memory (const u32 capacity_max);
+        inline void                  release_os_memory      (void);
+        inline void                  reset                  (void);
+        inline slot_map_handle_t     insert                 (const t& value);
+        inline t*                    insert_default         (slot_map_handle_t& handle);
+        inline bool                  remove                 (const slot_map_handle_t handle);
+        inline t*                    get                    (const slot_map_handle_t handle);
+        inline slot_map_handle_t     get_handle_at          (const u32 dense_index);
+        inline bool                  is_handle_valid        (const slot_map_handle_t handle);
+        inline bool                  is_reserve_backed      (void);
+        inline void                  assert_valid           (void);
+        inline bool                  is_valid               (void);
+        inline bool                  is_empty               (void);
+        inline bool                  is_full                (void);
+        inline t*                    begin                  (void);
+        inline t*                    end                    (void);
+
+        inline t&       operator[] (u32 dense_index);
+        inline const t& operator[] (u32 dense_index) const;
+
+    private:
+        inline u32                   acquire_slot           (void);
+    };
+
+    //-------------------------------------------------------------------
+    // INLINE METHODS
+    //-------------------------------------------------------------------
+
+    SLD_SLOT_MAP_IMPL_INLINE
+    memory_size(
+        const u32 capacity) -> u64 {
+
+        const u64 size_header      = size_align_pow_2(sizeof(slot_map_t<t>),             alignof(t));
+        const u64 size_data        = size_align_pow_2((u64)capacity * sizeof(t),          alignof(slot_map_slot_t));
+        const u64 size_dense_slots = size_align_pow_2((u64)capacity * sizeof(u32),        alignof(slot_map_slot_t));
+        const u64 size_slots       = ((u64)capacity * sizeof(slot_map_slot_t));
+        const u64 size_total       = (size_header + size_data + size_dense_slots + size_slots);
+        return(size_total);
+    }
+
+    SLD_SLOT_MAP_IMPL_INLINE
+    init_from_memory(
+        const memory_t& memory) -> slot_map_t<t>* {
+
+        memory_assert_valid(memory);
+
+        // find the biggest capacity that fits, every value needs its
+        // data, its dense slot and its slot
+        const u64 size_element = (sizeof(t) + sizeof(u32) + sizeof(slot_map_slot_t));
+        u32       capacity     = (u32)(memory.size / size_element);
+        while (capacity != 0 && memory_size(capacity) > memory.size) {
+            --capacity;
+        }
+        if (capacity == 0) return(NULL);
+
+        const u64 size_header      = size_align_pow_2(sizeof(slot_map_t<t>),    alignof(t));
+        const u64 size_data        = size_align_pow_2((u64)capacity * sizeof(t),   alignof(slot_map_slot_t));
+        const u64 size_dense_slots = size_align_pow_2((u64)capacity * sizeof(u32), alignof(slot_map_slot_t));
+
+        slot_map_t<t>* slot_map      = (slot_map_t<t>*)memory.ptr;
+        slot_map->data               = (t*)              (memory.addr + size_header);
+        slot_map->dense_slots        = (u32*)            (memory.addr + size_header + size_data);
+        slot_map->slots              = (slot_map_slot_t*)(memory.addr + size_header + size_data + size_dense_slots);
+        slot_map->capacity           = capacity;
+        slot_map->arenas.data        = NULL;
+        slot_map->arenas.dense_slots = NULL;
+        slot_map->arenas.slots       = NULL;
+        slot_map->reset();
+        return(slot_map);
+    }
+
+    SLD_SLOT_MAP_IMPL_INLINE
+    init_reserve_os_memory(
+        const u32 capacity_max) -> bool {
+
+        if (capacity_max == 0) return(false);
+
+        // each array gets its own virtual arena so it can grow in place,
+        // values never move and nothing is committed until it's used.
+        // the extra chunk keeps the arena from ever being exactly full
+        const u64 size_chunk       = ARENA_COMMIT_CHUNK_DEFAULT;
+        const u64 size_data        = size_align_pow_2((u64)capacity_max * sizeof(t),               size_chunk) + size_chunk;
+        const u64 size_dense_slots = size_align_pow_2((u64)capacity_max * sizeof(u32),             size_chunk) + size_chunk;
+        const u64 size_slots       = size_align_pow_2((u64)capacity_max * sizeof(slot_map_slot_t), size_chunk) + size_chunk;
+        arenas.data        = arena_reserve_os_memory(size_data);
+        arenas.dense_slots = arena_reserve_os_memory(size_dense_slots);
+        arenas.slots       = arena_reserve_os_memory(size_slots);
+
+        bool did_reserve = true;
+        did_reserve &= (arenas.data        != NULL);
+        did_reserve &= (arenas.dense_slots != NULL);
+        did_reserve &= (arenas.slots       != NULL);
+        if (!did_reserve) {
+            if (arenas.data        != NULL) arena_release_os_memory(arenas.data);
+            if (arenas.dense_slots != NULL) arena_release_os_memory(arenas.dense_slots);
+            if (arenas.slots       != NULL) arena_release_os_memory(arenas.slots);
+            arenas.data        = NULL;
+            arenas.dense_slots = NULL;
+            arenas.slots       = NULL;
+            return(false);
+        }
+
+        data        = (t*)              arena_get_position(arenas.data);
+        dense_slots = (u32*)            arena_get_position(arenas.dense_slots);
+        slots       = (slot_map_slot_t*)arena_get_position(arenas.slots);
+        capacity    = capacity_max;
+        reset();
+        return(true);
+    }
+
+    SLD_SLOT_MAP_IMPL_INLINE
+    release_os_memory(
+        void) -> void {
+
+        assert(is_reserve_backed());
+        arena_release_os_memory(arenas.data);
+        arena_release_os_memory(arenas.dense_slots);
+        arena_release_os_memory(arenas.slots);
+        arenas.data        = NULL;
+        arenas.dense_slots = NULL;
+        arenas.slots       = NULL;
+        data               = NULL;
+        dense_slots        = NULL;
+        slots              = NULL;
+        capacity           = 0;
+        count              = 0;
+        slot_count         = 0;
+        free_head          = SLOT_MAP_INDEX_INVALID;
+    }
+
+    SLD_SLOT_MAP_IMPL_INLINE
+    reset(
+        void) -> void {
+
+        // slots are created lazily, so a reset only forgets them. their
+        // generations restart, which is fine since a reset is a new map
+        count      = 0;
+        slot_count = 0;
+        free_head  = SLOT_MAP_INDEX_INVALID;
+
+        if (is_reserve_backed()) {
+            arena_reset(arenas.data);
+            arena_reset(arenas.dense_slots);
+            arena_reset(arenas.slots);
+        }
+    }
+
+    SLD_SLOT_MAP_IMPL_INLINE
+    acquire_slot(
+        void) -> u32 {
+
+        // reuse a removed slot first
+        if (free_head != SLOT_MAP_INDEX_INVALID) {
+            const u32 slot_index = free_head;
+            free_head = slots[slot_index].dense_index;
+            return(slot_index);
+        }
+
+        if (slot_count == capacity) return(SLOT_MAP_INDEX_INVALID);
+
+        // every array grows by one element with the slots, the arenas
+        // commit whole chunks so this is a bump most of the time
+        if (is_reserve_backed()) {
+
+            bool did_grow = true;
+            did_grow &= (arena_push_struct<t>               (arenas.data)        != NULL);
+            did_grow &= (arena_push_struct<u32>             (arenas.dense_slots) != NULL);
+            did_grow &= (arena_push_struct<slot_map_slot_t> (arenas.slots)       != NULL);
+            if (!did_grow) return(SLOT_MAP_INDEX_INVALID);
+        }
+
+        const u32 slot_index = slot_count++;
+        slots[slot_index].generation = 0;
+        return(slot_index);
+    }
+
+    SLD_SLOT_MAP_IMPL_INLINE
+    insert_default(
+        slot_map_handle_t& handle) -> t* {
+
+        assert_valid();
+        handle = SLOT_MAP_HANDLE_INVALID;
+
+        const u32 slot_index = acquire_slot();
+        if (slot_index == SLOT_MAP_INDEX_INVALID) return(NULL);
+
+        // the value goes at the end of the dense array
+        const u32        dense_index = count++;
+        slot_map_slot_t& slot        = slots[slot_index];
+        slot.dense_index             = dense_index;
+        slot.generation             += 1;
+        dense_slots[dense_index]     = slot_index;
+
+        handle.index      = slot_index;
+        handle.generation = slot.generation;
+
+        t* value = new (&data[dense_index]) t();
+        return(value);
+    }
+
+    SLD_SLOT_MAP_IMPL_INLINE
+    insert(
+        const t& value) -> slot_map_handle_t {
+
+        slot_map_handle_t handle;
+        t* value_ptr = insert_default(handle);
+        if (value_ptr) *value_ptr = value;
+        return(handle);
+    }
+
+    SLD_SLOT_MAP_IMPL_INLINE
+    remove(
+        const slot_map_handle_t handle) -> bool {
+
+        assert_valid();
+        if (!is_handle_valid(handle)) return(false);
+
+        slot_map_slot_t& slot       = slots[handle.index];
+        const u32        dense_hole = slot.dense_index;
+        const u32        dense_last = (count - 1);
+
+        // swap the last value into the hole and point its slot there
+        data[dense_hole].~t();
+        if (dense_hole != dense_last) {
+
+            const u32 slot_last = dense_slots[dense_last];
+            new (&data[dense_hole]) t(data[dense_last]);
+            data[dense_last].~t();
+            dense_slots[dense_hole]       = slot_last;
+            slots[slot_last].dense_index  = dense_hole;
+        }
+        --count;
+
+        // the slot goes on the free list, linked through its dense index
+        slot.generation  += 1;
+        slot.dense_index  = free_head;
+        free_head         = handle.index;
+        return(true);
+    }
+
+    SLD_SLOT_MAP_IMPL_INLINE
+    get(
+        const slot_map_handle_t handle) -> t* {
+
+        t* value = is_handle_valid(handle)
+            ? &data[slots[handle.index].dense_index]
+            : NULL;
+        return(value);
+    }
+
+    SLD_SLOT_MAP_IMPL_INLINE
+    get_handle_at(
+        const u32 dense_index) -> slot_map_handle_t {
+
+        slot_map_handle_t handle = SLOT_MAP_HANDLE_INVALID;
+        if (dense_index < count) {
+            handle.index      = dense_slots[dense_index];
+            handle.generation = slots[handle.index].generation;
+        }
+        return(handle);
+    }
+
+    SLD_SLOT_MAP_IMPL_INLINE
+    is_handle_valid(
+        const slot_map_handle_t handle) -> bool {
+
+        bool is_valid = (handle.index < slot_count);
+        if (is_valid) {
+            is_valid &= (slots[handle.index].generation == handle.generation);
+            is_valid &= ((handle.generation & 1) != 0);
+        }
+        return(is_valid);
+    }
+
+    SLD_SLOT_MAP_IMPL_INLINE
+    is_reserve_backed(
+        void) -> bool {
+
+        return(arenas.slots != NULL);
+    }
+
+    SLD_SLOT_MAP_IMPL_INLINE
+    assert_valid(
+        void) -> void {
+
+        assert(is_valid());
+    }
+
+    SLD_SLOT_MAP_IMPL_INLINE
+    is_valid(
+        void) -> bool {
+
+        bool is_valid = true;
+        is_valid &= (data        != NULL);
+        is_valid &= (dense_slots != NULL);
+        is_valid &= (slots       != NULL);
+        is_valid &= (capacity    != 0);
+        is_valid &= (count       <= slot_count);
+        is_valid &= (slot_count  <= capacity);
+        return(is_valid);
+    }
+
+    SLD_SLOT_MAP_IMPL_INLINE
+    is_empty(
+        void) -> bool {
+
+        return(count == 0);
+    }
+
+    SLD_SLOT_MAP_IMPL_INLINE
+    is_full(
+        void) -> bool {
+
+        return(count == capacity);
+    }
+
+    SLD_SLOT_MAP_IMPL_INLINE
+    begin(
+        void) -> t* {
+
+        return(data);
+    }
+
+    SLD_SLOT_MAP_IMPL_INLINE
+    end(
+        void) -> t* {
+
+        return(data + count);
+    }
+
+    template<typename t> inline t&
+    slot_map_t<t>::operator[](
+        u32 dense_index) {
+
+        assert(dense_index < count);
+        return(data[dense_index]);
+    }
+
+    template<typename t> inline const t&
+    slot_map_t<t>::operator[](
+        u32 dense_index) const {
+
+        assert(dense_index < count);
+        return(data[dense_index]);
+    }
+};
+
+#endif //SLD_SLOT_MAP_HPP
\ No newline at end of file
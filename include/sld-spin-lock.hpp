@@ -0,0 +1,64 @@
+#ifndef SLD_SPIN_LOCK_HPP
+#define SLD_SPIN_LOCK_HPP
+
+#include <atomic>
+#include "sld.hpp"
+#include "sld-simd.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // API
+    //-------------------------------------------------------------------
+
+    // for short critical sections shared between worker threads, where
+    // parking the thread in the os would cost more than the wait
+    struct spin_lock_t {
+        std::atomic<u32> locked;
+    };
+
+    SLD_API_INLINE void spin_lock_init    (spin_lock_t& lock);
+    SLD_API_INLINE bool spin_lock_try     (spin_lock_t& lock);
+    SLD_API_INLINE void spin_lock_acquire (spin_lock_t& lock);
+    SLD_API_INLINE void spin_lock_release (spin_lock_t& lock);
+
+    //-------------------------------------------------------------------
+    // INLINE METHODS
+    //-------------------------------------------------------------------
+
+    SLD_API_INLINE void
+    spin_lock_init(
+        spin_lock_t& lock) {
+
+        lock.locked.store(0, std::memory_order_relaxed);
+    }
+
+    SLD_API_INLINE bool
+    spin_lock_try(
+        spin_lock_t& lock) {
+
+        const bool did_lock = (lock.locked.exchange(1, std::memory_order_acquire) == 0);
+        return(did_lock);
+    }
+
+    SLD_API_INLINE void
+    spin_lock_acquire(
+        spin_lock_t& lock) {
+
+        // spin on a plain load so waiters don't bounce the cache line
+        while (!spin_lock_try(lock)) {
+            while (lock.locked.load(std::memory_order_relaxed) != 0) {
+                _mm_pause();
+            }
+        }
+    }
+
+    SLD_API_INLINE void
+    spin_lock_release(
+        spin_lock_t& lock) {
+
+        lock.locked.store(0, std::memory_order_release);
+    }
+};
+
+#endif //SLD_SPIN_LOCK_HPP
\ No newline at end of file
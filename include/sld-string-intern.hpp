@@ -0,0 +1,51 @@
+#ifndef SLD_STRING_INTERN_HPP
+#define SLD_STRING_INTERN_HPP
+
+#include "sld.hpp"
+#include "sld-cstr.hpp"
+#include "sld-arena.hpp"
+#include "sld-arena-allocator.hpp"
+#include "sld-hash-table.hpp"
+
+namespace sld {
+
+    struct string_intern_t;
+    struct string_intern_entry_t;
+
+    SLD_API bool         string_intern_reserve_os_memory (string_intern_t&       intern, const u32 symbol_max, const u64 size_chars);
+    SLD_API void         string_intern_release_os_memory (string_intern_t&       intern);
+    SLD_API bool         string_intern_is_valid          (const string_intern_t& intern);
+    SLD_API u32          string_intern_chars             (string_intern_t&       intern, const cchar* chars, const u32 length);
+    SLD_API u32          string_intern_cstr              (string_intern_t&       intern, const cstr_t* cstr);
+    SLD_API u32          string_intern_find              (const string_intern_t& intern, const cchar* chars, const u32 length);
+    SLD_API u32          string_intern_get_count         (const string_intern_t& intern);
+    SLD_API const cchar* string_intern_get_chars         (const string_intern_t& intern, const u32 symbol);
+    SLD_API u32          string_intern_get_length        (const string_intern_t& intern, const u32 symbol);
+    SLD_API cstr_t       string_intern_get_cstr          (const string_intern_t& intern, const u32 symbol);
+
+    // every distinct string is stored once and named by a u32 symbol, so
+    // comparing two interned strings is comparing two integers and the
+    // symbol can be a hash table key on its own. strings are identified
+    // by their hash128, the same way hash_table_t identifies keys.
+    // the characters live null terminated in a virtual arena and never
+    // move, the symbol indexes an entry that points at them. the lookup
+    // table grows through its own arena allocator. not thread safe
+    struct string_intern_entry_t {
+        const cchar* chars;
+        u32          length;
+    };
+
+    struct string_intern_t {
+        arena_t*          chars;
+        arena_t*          entries;
+        arena_allocator_t table_allocator;
+        hash_table_t      table;
+        u32               count;
+        u32               symbol_max;
+    };
+
+    constexpr u32 STRING_INTERN_SYMBOL_INVALID     = 0xFFFFFFFF;
+    constexpr u32 STRING_INTERN_TABLE_CAPACITY_MIN = 256;
+};
+
+#endif //SLD_STRING_INTERN_HPP
\ No newline at end of file
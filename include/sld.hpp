@@ -1,13 +1,21 @@
 #ifndef SLD_HPP
 #define SLD_HPP
 
-#include <Windows.h>
+#if defined(_WIN32)
+#   include <Windows.h>
+#endif
 
 #include <cstdint>
+#include <cstring>
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#endif
 #include <imgui.h>
 #include <imgui_impl_opengl3.h>
-#include <imgui_impl_win32.h>
-#include <imgui_impl_dx12.h>
+#if defined(_WIN32)
+#   include <imgui_impl_win32.h>
+#   include <imgui_impl_dx12.h>
+#endif
 
 #include <GL/glew.h>
 #include <GL/gl.h>
@@ -140,6 +148,33 @@ namespace sld {
     SLD_UTILITY void bit_mask_and  (u32& value,      const u32 mask)                   { (value |=  mask);                                   }
     SLD_UTILITY void bit_mask_or   (u32& value,      const u32 mask)                   { (value &= ~mask);                                   }
 
+    // index of the lowest and highest set bit, the value can't be 0
+    SLD_INLINE u32
+    bit_scan_forward(
+        const u64 value) {
+
+#   if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return((u32)index);
+#   else
+        return((u32)__builtin_ctzll(value));
+#   endif
+    }
+
+    SLD_INLINE u32
+    bit_scan_reverse(
+        const u64 value) {
+
+#   if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return((u32)index);
+#   else
+        return((u32)(63 - __builtin_clzll(value)));
+#   endif
+    }
+
     //-------------------------------------------------------------------
     // MEMORY
     //-------------------------------------------------------------------
@@ -0,0 +1,38 @@
+#!/bin/sh
+
+# builds every tests/*.cpp as its own program and runs it. tests always
+# run and fail the script through their exit code, benchmarks only run
+# when "bench" is passed. the dependencies come from vcpkg like the
+# library build, SLD_VCPKG_INCLUDE and SLD_TEST_LIBS point elsewhere
+
+cd "$(dirname "$0")/.." || exit 1
+
+dir_bin=build/tests/bin
+
+cxx=${CXX:-g++}
+cxx_include="-Iexternal -Iinclude -Isrc -Isrc/core -Isrc/hash -Isrc/memory -Isrc/string -Isrc/linux -Itests -I${SLD_VCPKG_INCLUDE:-vcpkg_installed/x64-linux/include}"
+cxx_flags="-std=c++17 -O2 -g -pthread -maes -msse4.2 -fno-exceptions -fpermissive"
+cxx_libs="${SLD_TEST_LIBS:--lz-ng}"
+
+mkdir -p "$dir_bin"
+
+failed=0
+for kind in test bench; do
+
+    if [ "$kind" = "bench" ] && [ "$1" != "bench" ]; then continue; fi
+
+    for src in tests/sld-$kind-*.cpp; do
+
+        [ -e "$src" ] || continue
+        name=$(basename "$src" .cpp)
+        echo "== $name"
+
+        if ! $cxx $cxx_flags $cxx_include "$src" -o "$dir_bin/$name" $cxx_libs; then
+            failed=$((failed + 1))
+            continue
+        fi
+        "./$dir_bin/$name" || failed=$((failed + 1))
+    done
+done
+
+exit $failed
\ No newline at end of file
@@ -0,0 +1,476 @@
+#pragma once
+
+#include "sld-chunk-store.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // DECLARATIONS
+    //-------------------------------------------------------------------
+
+    // one random word per byte value. the gear hash shifts left once per
+    // byte, so a byte has left the high bits 64 bytes after it went in
+    // and the hash is a rolling one without ever subtracting it back out
+    struct chunk_gear_table_t {
+        u64 values[256];
+    };
+
+    constexpr u64 CHUNK_GEAR_SEED = 0x5D1C2B3A49687F0E;
+
+    SLD_UTILITY         chunk_gear_table_t         chunk_gear_table_build (void);
+    SLD_INTERNAL        const chunk_gear_table_t&  chunk_gear_table_get   (void);
+    SLD_UTILITY         u64                        chunk_mask_high_bits   (const u32 bit_count);
+    SLD_INTERNAL_INLINE hash128_t                  chunk_hash             (const byte* data, const u32 length);
+    SLD_INTERNAL_INLINE const chunk_store_entry_t* chunk_store_get_entry  (const chunk_store_t& store, const u32 id);
+
+    //-------------------------------------------------------------------
+    // API
+    //-------------------------------------------------------------------
+
+    SLD_API bool
+    chunk_params_init(
+        chunk_params_t& params,
+        const u32       size_avg) {
+
+        bool can_init = true;
+        can_init &= size_is_pow_2(size_avg);
+        can_init &= (size_avg >= CHUNK_SIZE_AVG_MIN);
+        can_init &= (size_avg <= CHUNK_SIZE_AVG_MAX);
+        if (!can_init) return(false);
+
+        // the small mask has more bits than the average would need and the
+        // large one fewer, by CHUNK_NORMALIZATION each way
+        const u32 bit_count = bit_scan_forward(size_avg);
+        params.size_min     = (size_avg / 4);
+        params.size_avg     = size_avg;
+        params.size_max     = (size_avg * 8);
+        params.mask_small   = chunk_mask_high_bits(bit_count + CHUNK_NORMALIZATION);
+        params.mask_large   = chunk_mask_high_bits(bit_count - CHUNK_NORMALIZATION);
+
+        return(chunk_params_is_valid(params));
+    }
+
+    SLD_API bool
+    chunk_params_is_valid(
+        const chunk_params_t& params) {
+
+        bool is_valid = true;
+        is_valid &= (params.size_min   != 0);
+        is_valid &= (params.size_min   <  params.size_avg);
+        is_valid &= (params.size_avg   <  params.size_max);
+        is_valid &= (params.mask_small != 0);
+        is_valid &= (params.mask_large != 0);
+        return(is_valid);
+    }
+
+    SLD_API u32
+    chunk_find_cut(
+        const chunk_params_t& params,
+        const byte*           data,
+        const u32             length,
+        const bool            is_end) {
+
+        // returns the length of the chunk at the start of data. 0 means the
+        // chunk might still end past length and the caller needs to come
+        // back with more data, which can't happen once is_end is set
+        const u32 length_max = (length < params.size_max) ? length : params.size_max;
+        if (length_max <= params.size_min) {
+            const bool is_cut = (is_end || length >= params.size_max);
+            return(is_cut ? length_max : 0);
+        }
+
+        const chunk_gear_table_t& gear = chunk_gear_table_get();
+
+        const u32 length_avg  = (length_max < params.size_avg) ? length_max : params.size_avg;
+        u64       fingerprint = 0;
+        u32       index       = params.size_min;
+
+        for (
+            ;
+            index < length_avg;
+            ++index) {
+
+            fingerprint = (fingerprint << 1) + gear.values[data[index]];
+            if ((fingerprint & params.mask_small) == 0) return(index + 1);
+        }
+
+        for (
+            ;
+            index < length_max;
+            ++index) {
+
+            fingerprint = (fingerprint << 1) + gear.values[data[index]];
+            if ((fingerprint & params.mask_large) == 0) return(index + 1);
+        }
+
+        const bool is_cut = (is_end || length >= params.size_max);
+        return(is_cut ? length_max : 0);
+    }
+
+    SLD_API u32
+    chunk_buffer(
+        const chunk_params_t& params,
+        const buffer_t*       buffer,
+        const bool            is_end,
+        chunk_t*              chunks,
+        const u32             chunk_max) {
+
+        bool can_chunk = true;
+        can_chunk &= chunk_params_is_valid(params);
+        can_chunk &= buffer_is_valid(buffer);
+        can_chunk &= (chunks    != NULL);
+        can_chunk &= (chunk_max != 0);
+        if (!can_chunk) return(0);
+
+        // the chunks cover the buffer from the start with no gaps, the
+        // bytes past the last one are a chunk that isn't finished yet or
+        // more chunks than chunk_max
+        u32 chunk_count = 0;
+        u32 offset      = 0;
+        while (chunk_count < chunk_max && offset < buffer->length) {
+
+            const byte* data   = &buffer->data[offset];
+            const u32   length = chunk_find_cut(params, data, buffer->length - offset, is_end);
+            if (length == 0) break;
+
+            chunks[chunk_count].hash   = chunk_hash(data, length);
+            chunks[chunk_count].offset = offset;
+            chunks[chunk_count].length = length;
+            offset += length;
+            ++chunk_count;
+        }
+        return(chunk_count);
+    }
+
+    SLD_API bool
+    chunk_store_reserve_os_memory(
+        chunk_store_t& store,
+        const u32      chunk_max,
+        const u64      size_data) {
+
+        bool can_reserve = true;
+        can_reserve &= (chunk_max != 0);
+        can_reserve &= (chunk_max <  CHUNK_STORE_ID_INVALID);
+        can_reserve &= (size_data != 0);
+        if (!can_reserve) return(false);
+
+        store.table          = {};
+        store.table.capacity = CHUNK_STORE_TABLE_CAPACITY_MIN;
+        store.table.stride   = sizeof(u32);
+        const bool did_reserve = hash_table_allocator_reserve(store.table, &store.table_allocator, chunk_max);
+        if (!did_reserve) return(false);
+
+        const u64 size_entries = ((u64)chunk_max * sizeof(chunk_store_entry_t));
+        store.data        = arena_reserve_os_memory(size_data);
+        store.entries     = arena_reserve_os_memory(size_entries + ARENA_COMMIT_CHUNK_DEFAULT);
+        store.count       = 0;
+        store.chunk_max   = chunk_max;
+        store.size_stored = 0;
+        store.size_added  = 0;
+
+        const bool is_valid = chunk_store_is_valid(store);
+        if (!is_valid) chunk_store_release_os_memory(store);
+        return(is_valid);
+    }
+
+    SLD_API void
+    chunk_store_release_os_memory(
+        chunk_store_t& store) {
+
+        hash_table_allocator_release(store.table);
+        arena_allocator_release_os_memory(&store.table_allocator);
+        if (store.data    != NULL) arena_release_os_memory(store.data);
+        if (store.entries != NULL) arena_release_os_memory(store.entries);
+
+        store.data        = NULL;
+        store.entries     = NULL;
+        store.count       = 0;
+        store.chunk_max   = 0;
+        store.size_stored = 0;
+        store.size_added  = 0;
+    }
+
+    SLD_API bool
+    chunk_store_is_valid(
+        const chunk_store_t& store) {
+
+        bool is_valid = true;
+        is_valid &= (store.data    != NULL);
+        is_valid &= (store.entries != NULL);
+        is_valid &= (store.count   <= store.chunk_max);
+        is_valid &= hash_table_validate(store.table);
+        return(is_valid);
+    }
+
+    SLD_API u32
+    chunk_store_add(
+        chunk_store_t& store,
+        const byte*    data,
+        const u32      length) {
+
+        if (data == NULL) return(CHUNK_STORE_ID_INVALID);
+
+        const hash128_t hash = chunk_hash           (data, length);
+        const u32       id   = chunk_store_add_hash (store, data, length, hash);
+        return(id);
+    }
+
+    SLD_API u32
+    chunk_store_add_hash(
+        chunk_store_t&   store,
+        const byte*      data,
+        const u32        length,
+        const hash128_t& hash) {
+
+        bool can_add = true;
+        can_add &= chunk_store_is_valid(store);
+        can_add &= (data   != NULL);
+        can_add &= (length != 0);
+        if (!can_add) return(CHUNK_STORE_ID_INVALID);
+
+        // the same bytes have the same hash, hand back the id they already have
+        hash_table_value_t value;
+        const bool         is_found = hash_table_search_hash(store.table, hash, value);
+        if (is_found) {
+            const u32 id = *(const u32*)value.data;
+            assert(chunk_store_get_length(store, id) == length);
+            store.size_added += length;
+            return(id);
+        }
+
+        if (store.count == store.chunk_max) return(CHUNK_STORE_ID_INVALID);
+
+        // the id is the entry index, so a push or an insert that fails
+        // rolls both arenas back and the next id still lines up
+        arena_scope_t scope_data    = arena_scope_begin(store.data);
+        arena_scope_t scope_entries = arena_scope_begin(store.entries);
+
+        byte*                data_copy = (byte*)arena_push_bytes(store.data, length);
+        chunk_store_entry_t* entry     = arena_push_struct<chunk_store_entry_t>(store.entries);
+
+        const u32  id         = store.count;
+        const bool did_push   = (data_copy != NULL && entry != NULL);
+        const bool did_insert = did_push && hash_table_insert_hash(store.table, (const byte*)&id, hash, value);
+        if (!did_insert) {
+            arena_scope_end(scope_entries);
+            arena_scope_end(scope_data);
+            return(CHUNK_STORE_ID_INVALID);
+        }
+
+        (void)memcpy(data_copy, data, length);
+        entry->hash   = hash;
+        entry->data   = data_copy;
+        entry->length = length;
+
+        ++store.count;
+        store.size_stored += length;
+        store.size_added  += length;
+        return(id);
+    }
+
+    SLD_API u32
+    chunk_store_add_buffer(
+        chunk_store_t&        store,
+        const chunk_params_t& params,
+        buffer_t*             buffer,
+        const bool            is_end,
+        u32*                  ids,
+        const u32             id_max) {
+
+        bool can_add = true;
+        can_add &= chunk_store_is_valid(store);
+        can_add &= buffer_is_valid(buffer);
+        can_add &= (ids    != NULL);
+        can_add &= (id_max != 0);
+        if (!can_add) return(0);
+
+        // the buffer is chunked a batch at a time through a view past what
+        // is already done, and every batch is looked up at once so the
+        // probes overlap. the chunks that were added are consumed from the
+        // buffer, what's left is the start of the next chunk, or a chunk
+        // the store had no room for
+        chunk_t            chunks    [CHUNK_BATCH_SIZE];
+        hash128_t          hashes    [CHUNK_BATCH_SIZE];
+        hash_table_value_t values    [CHUNK_BATCH_SIZE];
+        u32                found_ids [CHUNK_BATCH_SIZE];
+
+        u32  id_count  = 0;
+        u32  offset    = 0;
+        bool did_stall = false;
+        while (!did_stall && id_count < id_max) {
+
+            buffer_t view;
+            view.data   = &buffer->data[offset];
+            view.size   = (buffer->size   - offset);
+            view.length = (buffer->length - offset);
+            if (view.length == 0) break;
+
+            const u32 batch_max   = ((id_max - id_count) < CHUNK_BATCH_SIZE) ? (id_max - id_count) : CHUNK_BATCH_SIZE;
+            const u32 batch_count = chunk_buffer(params, &view, is_end, chunks, batch_max);
+            if (batch_count == 0) break;
+
+            for (
+                u32 chunk = 0;
+                    chunk < batch_count;
+                  ++chunk) {
+
+                hashes[chunk] = chunks[chunk].hash;
+            }
+            (void)hash_table_search_batch_hash(store.table, batch_count, hashes, values);
+
+            // the values point into the table, and an add below can grow it
+            // and release the old arrays, so the ids are copied out first
+            for (
+                u32 chunk = 0;
+                    chunk < batch_count;
+                  ++chunk) {
+
+                found_ids[chunk] = (values[chunk].data != NULL)
+                    ? *(const u32*)values[chunk].data
+                    : CHUNK_STORE_ID_INVALID;
+            }
+
+            for (
+                u32 chunk = 0;
+                    chunk < batch_count;
+                  ++chunk) {
+
+                // a chunk that was found is only counted, one that wasn't
+                // might have been added earlier in this batch, so adding
+                // it looks it up again
+                u32 id = found_ids[chunk];
+                if (id != CHUNK_STORE_ID_INVALID) {
+                    store.size_added += chunks[chunk].length;
+                }
+                else {
+                    id = chunk_store_add_hash(store, &view.data[chunks[chunk].offset], chunks[chunk].length, chunks[chunk].hash);
+                }
+
+                if (id == CHUNK_STORE_ID_INVALID) { did_stall = true; break; }
+
+                ids[id_count] = id;
+                offset       += chunks[chunk].length;
+                ++id_count;
+            }
+        }
+
+        (void)buffer_consume(buffer, offset);
+        return(id_count);
+    }
+
+    SLD_API u32
+    chunk_store_find(
+        const chunk_store_t& store,
+        const hash128_t&     hash) {
+
+        hash_table_value_t value;
+        const bool         is_found = hash_table_search_hash(store.table, hash, value);
+        const u32          id       = is_found ? *(const u32*)value.data : CHUNK_STORE_ID_INVALID;
+        return(id);
+    }
+
+    SLD_API u32
+    chunk_store_get_count(
+        const chunk_store_t& store) {
+
+        return(store.count);
+    }
+
+    SLD_API const byte*
+    chunk_store_get_data(
+        const chunk_store_t& store,
+        const u32            id) {
+
+        const chunk_store_entry_t* entry = chunk_store_get_entry(store, id);
+        const byte*                data  = (entry != NULL) ? entry->data : NULL;
+        return(data);
+    }
+
+    SLD_API u32
+    chunk_store_get_length(
+        const chunk_store_t& store,
+        const u32            id) {
+
+        const chunk_store_entry_t* entry  = chunk_store_get_entry(store, id);
+        const u32                  length = (entry != NULL) ? entry->length : 0;
+        return(length);
+    }
+
+    SLD_API bool
+    chunk_store_get_hash(
+        const chunk_store_t& store,
+        const u32            id,
+        hash128_t&           hash) {
+
+        const chunk_store_entry_t* entry = chunk_store_get_entry(store, id);
+        if (entry == NULL) return(false);
+
+        hash = entry->hash;
+        return(true);
+    }
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_UTILITY chunk_gear_table_t
+    chunk_gear_table_build(
+        void) {
+
+        // splitmix64, the table only has to be fixed and well mixed
+        chunk_gear_table_t table = {};
+        u64                state = CHUNK_GEAR_SEED;
+        for (
+            u32 value = 0;
+                value < 256;
+              ++value) {
+
+            state += 0x9E3779B97F4A7C15;
+            u64 mixed = state;
+            mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9;
+            mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EB;
+            table.values[value] = (mixed ^ (mixed >> 31));
+        }
+        return(table);
+    }
+
+    SLD_INTERNAL const chunk_gear_table_t&
+    chunk_gear_table_get(
+        void) {
+
+        static constexpr chunk_gear_table_t table = chunk_gear_table_build();
+        return(table);
+    }
+
+    SLD_UTILITY u64
+    chunk_mask_high_bits(
+        const u32 bit_count) {
+
+        // the high bits have seen the most bytes, so the test uses them
+        const u64 mask = (bit_count == 0) ? 0 : (~0ULL << (64 - bit_count));
+        return(mask);
+    }
+
+    SLD_INTERNAL_INLINE hash128_t
+    chunk_hash(
+        const byte* data,
+        const u32   length) {
+
+        hash_table_key_t key;
+        key.data   = (byte*)data;
+        key.length = length;
+
+        const hash128_t hash = hash_table_hash_key(key);
+        return(hash);
+    }
+
+    SLD_INTERNAL_INLINE const chunk_store_entry_t*
+    chunk_store_get_entry(
+        const chunk_store_t& store,
+        const u32            id) {
+
+        const chunk_store_entry_t* entries = (const chunk_store_entry_t*)arena_get_start(store.entries);
+        const chunk_store_entry_t* entry   = (id < store.count) ? &entries[id] : NULL;
+        return(entry);
+    }
+};
\ No newline at end of file
@@ -0,0 +1,386 @@
+#pragma once
+
+#include "sld-concurrent-hash-table.hpp"
+#include "sld-simd.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_INTERNAL_INLINE const concurrent_hash_table_shard_t&
+    concurrent_hash_table_get_shard(
+        const concurrent_hash_table_t& table,
+        const hash128_t&               hash) {
+
+        // the table only uses the low bits of the first word, so the top
+        // bits pick the shard without skewing the probes inside it
+        const u32 shard_index = (u32)(hash.val.as_u64[0] >> (64 - CONCURRENT_HASH_TABLE_SHARD_COUNT_LOG2));
+        return(table.shards[shard_index]);
+    }
+
+    SLD_INTERNAL_INLINE concurrent_hash_table_shard_t&
+    concurrent_hash_table_get_shard(
+        concurrent_hash_table_t& table,
+        const hash128_t&         hash) {
+
+        const u32 shard_index = (u32)(hash.val.as_u64[0] >> (64 - CONCURRENT_HASH_TABLE_SHARD_COUNT_LOG2));
+        return(table.shards[shard_index]);
+    }
+
+    SLD_INTERNAL concurrent_hash_table_array_t*
+    concurrent_hash_table_array_alloc(
+        const u32 capacity,
+        const u32 stride) {
+
+        hash_table_t table = {};
+        table.capacity     = capacity;
+        table.stride       = stride;
+
+        // one reservation, the header and then the table arrays. running
+        // out of address space leaves the shard as it is, the insert or
+        // init that wanted it fails instead
+        const u64 size_header = size_align_pow_2(sizeof(concurrent_hash_table_array_t), 64);
+        memory_t  memory;
+        memory.addr = 0;
+        memory.size = size_header + hash_table_memory_size(table);
+        if (memory_os_reserve(memory) == 0) return(NULL);
+
+        // committed by hand, memory_os_commit asserts
+        void* committed = os_memory_commit(memory.ptr, memory.size);
+        if (committed != memory.ptr) {
+            memory_os_release(memory);
+            return(NULL);
+        }
+
+        memory_t memory_table;
+        memory_table.addr = memory.addr + size_header;
+        memory_table.size = memory.size - size_header;
+
+        concurrent_hash_table_array_t* array = (concurrent_hash_table_array_t*)memory.ptr;
+        array->memory = memory;
+        array->table  = table;
+        const bool did_init = hash_table_memory_init(array->table, memory_table);
+        if (!did_init) {
+            memory_os_release(memory);
+            return(NULL);
+        }
+        return(array);
+    }
+
+    SLD_INTERNAL void
+    concurrent_hash_table_array_free(
+        void* data) {
+
+        concurrent_hash_table_array_t* array  = (concurrent_hash_table_array_t*)data;
+        memory_t                       memory = array->memory;
+        memory_os_release(memory);
+    }
+
+    SLD_INTERNAL_INLINE void
+    concurrent_hash_table_write_begin(
+        concurrent_hash_table_shard_t& shard) {
+
+        // odd until the write ends, readers that overlap it retry
+        const u32 sequence = shard.sequence.load(std::memory_order_relaxed);
+        shard.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    SLD_INTERNAL_INLINE void
+    concurrent_hash_table_write_end(
+        concurrent_hash_table_shard_t& shard) {
+
+        const u32 sequence = shard.sequence.load(std::memory_order_relaxed);
+        shard.sequence.store(sequence + 1, std::memory_order_release);
+    }
+
+    SLD_INTERNAL concurrent_hash_table_array_t*
+    concurrent_hash_table_array_rebuild(
+        const concurrent_hash_table_array_t* array) {
+
+        // double when the live entries filled it, otherwise rebuilding
+        // at the same size is enough to drop the tombstones
+        const hash_table_t& table_old    = array->table;
+        const bool          should_grow  = (table_old.count >= (table_old.capacity / 2));
+        const u32           capacity_new = should_grow ? (table_old.capacity * 2) : table_old.capacity;
+        if (capacity_new < table_old.capacity) return(NULL);
+
+        concurrent_hash_table_array_t* array_new = concurrent_hash_table_array_alloc(capacity_new, table_old.stride);
+        if (array_new == NULL) return(NULL);
+
+        for (
+            u32 index = 0;
+                index < table_old.capacity;
+              ++index) {
+
+            if (!hash_table_is_full(table_old.array.control[index])) continue;
+
+            hash_table_value_t result;
+            const bool did_insert = hash_table_insert_hash(
+                array_new->table,
+                hash_table_value_at(table_old, index),
+                table_old.array.hash[index],
+                result);
+            if (!did_insert) {
+                concurrent_hash_table_array_free(array_new);
+                return(NULL);
+            }
+        }
+
+        return(array_new);
+    }
+
+    //-------------------------------------------------------------------
+    // API
+    //-------------------------------------------------------------------
+
+    SLD_API bool
+    concurrent_hash_table_init(
+        concurrent_hash_table_t& table,
+        epoch_domain_t*          epoch,
+        const u32                stride,
+        const u32                capacity) {
+
+        bool can_init = true;
+        can_init &= (epoch  != NULL);
+        can_init &= (stride != 0);
+        if (!can_init) return(false);
+
+        u32 shard_capacity = size_round_up_pow2(capacity / CONCURRENT_HASH_TABLE_SHARD_COUNT);
+        if (shard_capacity < HASH_TABLE_CAPACITY_MIN) {
+            shard_capacity = HASH_TABLE_CAPACITY_MIN;
+        }
+
+        table.epoch  = epoch;
+        table.stride = stride;
+
+        for (
+            u32 index = 0;
+                index < CONCURRENT_HASH_TABLE_SHARD_COUNT;
+              ++index) {
+
+            concurrent_hash_table_shard_t& shard = table.shards[index];
+            shard.sequence.store (0,    std::memory_order_relaxed);
+            shard.count.store    (0,    std::memory_order_relaxed);
+            shard.array.store    (NULL, std::memory_order_relaxed);
+            spin_lock_init       (shard.lock);
+        }
+
+        for (
+            u32 index = 0;
+                index < CONCURRENT_HASH_TABLE_SHARD_COUNT;
+              ++index) {
+
+            concurrent_hash_table_array_t* array = concurrent_hash_table_array_alloc(shard_capacity, stride);
+            if (array == NULL) {
+                concurrent_hash_table_release(table);
+                return(false);
+            }
+            table.shards[index].array.store(array, std::memory_order_release);
+        }
+
+        return(true);
+    }
+
+    SLD_API void
+    concurrent_hash_table_release(
+        concurrent_hash_table_t& table) {
+
+        // no readers left, retired arrays belong to the epoch domain
+        for (
+            u32 index = 0;
+                index < CONCURRENT_HASH_TABLE_SHARD_COUNT;
+              ++index) {
+
+            concurrent_hash_table_shard_t& shard = table.shards[index];
+            concurrent_hash_table_array_t* array = shard.array.load(std::memory_order_acquire);
+            if (array != NULL) {
+                concurrent_hash_table_array_free(array);
+            }
+            shard.array.store (NULL, std::memory_order_release);
+            shard.count.store (0,    std::memory_order_relaxed);
+        }
+
+        table.epoch  = NULL;
+        table.stride = 0;
+    }
+
+    SLD_API bool
+    concurrent_hash_table_search_hash(
+        const concurrent_hash_table_t& table,
+        const u32                      participant,
+        const hash128_t&               hash,
+        byte*                          value) {
+
+        const concurrent_hash_table_shard_t& shard = concurrent_hash_table_get_shard(table, hash);
+
+        epoch_enter(*table.epoch, participant);
+
+        bool is_found = false;
+        for (;;) {
+
+            const u32 sequence_begin = shard.sequence.load(std::memory_order_acquire);
+            if ((sequence_begin & 1) != 0) {
+                _mm_pause();
+                continue;
+            }
+
+            // the probe and the copy may see a write in progress, the
+            // sequence check below throws those results away
+            const concurrent_hash_table_array_t* array = shard.array.load(std::memory_order_acquire);
+            const u32 index = hash_table_find_index(array->table, hash);
+            is_found = (index != HASH_TABLE_INDEX_INVALID);
+            if (is_found && value != NULL) {
+                (void)memcpy(value, hash_table_value_at(array->table, index), table.stride);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const u32 sequence_end = shard.sequence.load(std::memory_order_relaxed);
+            if (sequence_end == sequence_begin) break;
+        }
+
+        epoch_exit(*table.epoch, participant);
+        return(is_found);
+    }
+
+    SLD_API bool
+    concurrent_hash_table_search(
+        const concurrent_hash_table_t& table,
+        const u32                      participant,
+        const hash_table_key_t&        key,
+        byte*                          value) {
+
+        bool can_search = true;
+        can_search &= (key.data   != NULL);
+        can_search &= (key.length != 0);
+        if (!can_search) return(false);
+
+        const hash128_t hash     = hash_table_hash_key               (key);
+        const bool      is_found = concurrent_hash_table_search_hash (table, participant, hash, value);
+        return(is_found);
+    }
+
+    SLD_API bool
+    concurrent_hash_table_insert_hash(
+        concurrent_hash_table_t& table,
+        const hash128_t&         hash,
+        const byte*              value) {
+
+        concurrent_hash_table_shard_t& shard = concurrent_hash_table_get_shard(table, hash);
+        spin_lock_acquire(shard.lock);
+
+        // writers are serialized, nobody else touches this pointer now
+        concurrent_hash_table_array_t* array     = shard.array.load(std::memory_order_relaxed);
+        concurrent_hash_table_array_t* array_old = NULL;
+
+        // rebuild before the table has to drop tombstones in place,
+        // readers keep probing the old array while we copy
+        const bool is_new_key = (hash_table_find_index(array->table, hash) == HASH_TABLE_INDEX_INVALID);
+        const u32  max_load   = hash_table_max_load(array->table.capacity);
+        const bool is_full    = ((array->table.count + array->table.tombstone_count) >= max_load);
+        if (is_new_key && is_full) {
+
+            concurrent_hash_table_array_t* array_new = concurrent_hash_table_array_rebuild(array);
+            if (array_new == NULL) {
+                spin_lock_release(shard.lock);
+                return(false);
+            }
+            array_old = array;
+            array     = array_new;
+        }
+
+        concurrent_hash_table_write_begin(shard);
+
+        hash_table_value_t result;
+        const bool did_insert = hash_table_insert_hash(array->table, value, hash, result);
+        if (array_old != NULL) {
+            shard.array.store(array, std::memory_order_release);
+        }
+        if (did_insert && is_new_key) {
+            shard.count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        concurrent_hash_table_write_end(shard);
+        spin_lock_release(shard.lock);
+
+        if (array_old != NULL) {
+            epoch_retire(*table.epoch, array_old, concurrent_hash_table_array_free);
+        }
+        return(did_insert);
+    }
+
+    SLD_API bool
+    concurrent_hash_table_insert(
+        concurrent_hash_table_t& table,
+        const hash_table_key_t&  key,
+        const byte*              value) {
+
+        bool can_insert = true;
+        can_insert &= (key.data   != NULL);
+        can_insert &= (key.length != 0);
+        if (!can_insert) return(false);
+
+        const hash128_t hash       = hash_table_hash_key               (key);
+        const bool      did_insert = concurrent_hash_table_insert_hash (table, hash, value);
+        return(did_insert);
+    }
+
+    SLD_API bool
+    concurrent_hash_table_remove_hash(
+        concurrent_hash_table_t& table,
+        const hash128_t&         hash) {
+
+        concurrent_hash_table_shard_t& shard = concurrent_hash_table_get_shard(table, hash);
+        spin_lock_acquire(shard.lock);
+
+        concurrent_hash_table_array_t* array = shard.array.load(std::memory_order_relaxed);
+        const u32 index = hash_table_find_index(array->table, hash);
+
+        bool did_remove = false;
+        if (index != HASH_TABLE_INDEX_INVALID) {
+
+            concurrent_hash_table_write_begin(shard);
+            did_remove = hash_table_remove_at(array->table, index);
+            if (did_remove) {
+                shard.count.fetch_sub(1, std::memory_order_relaxed);
+            }
+            concurrent_hash_table_write_end(shard);
+        }
+
+        spin_lock_release(shard.lock);
+        return(did_remove);
+    }
+
+    SLD_API bool
+    concurrent_hash_table_remove(
+        concurrent_hash_table_t& table,
+        const hash_table_key_t&  key) {
+
+        bool can_remove = true;
+        can_remove &= (key.data   != NULL);
+        can_remove &= (key.length != 0);
+        if (!can_remove) return(false);
+
+        const hash128_t hash       = hash_table_hash_key               (key);
+        const bool      did_remove = concurrent_hash_table_remove_hash (table, hash);
+        return(did_remove);
+    }
+
+    SLD_API u32
+    concurrent_hash_table_get_count(
+        const concurrent_hash_table_t& table) {
+
+        // a snapshot, writers may be moving it while we add
+        u32 count = 0;
+        for (
+            u32 index = 0;
+                index < CONCURRENT_HASH_TABLE_SHARD_COUNT;
+              ++index) {
+
+            count += table.shards[index].count.load(std::memory_order_relaxed);
+        }
+        return(count);
+    }
+};
\ No newline at end of file
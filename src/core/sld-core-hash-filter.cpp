@@ -0,0 +1,629 @@
+#pragma once
+
+#include "sld-hash-filter.hpp"
+#include "sld-simd.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // DECLARATIONS
+    //-------------------------------------------------------------------
+
+    using bloom_filter_test_f = bool (*) (const bloom_filter_block_t& block, const hash128_t& hash);
+    using bloom_filter_set_f  = void (*) (bloom_filter_block_t&       block, const hash128_t& hash);
+
+    // the swar form of a 16 bit compare, the high bit of every slot is set
+    // where the slot matched. only the lowest set bit is exact, a borrow
+    // can flag the slots above a match, so that's the one to use
+    constexpr u64 CUCKOO_FILTER_SLOT_LOW_BITS  = 0x0001000100010001;
+    constexpr u64 CUCKOO_FILTER_SLOT_HIGH_BITS = 0x8000800080008000;
+    constexpr u32 CUCKOO_FILTER_ALT_MULTIPLIER = 0x5BD1E995;
+
+    SLD_INTERNAL_INLINE u32                 bloom_filter_block_index    (const bloom_filter_t& filter, const hash128_t& hash);
+    SLD_INTERNAL_INLINE u32                 bloom_filter_bit            (const hash128_t& hash, const u32 word);
+    SLD_INTERNAL        bloom_filter_test_f bloom_filter_test_get       (void);
+    SLD_INTERNAL        bloom_filter_set_f  bloom_filter_set_get        (void);
+    SLD_INTERNAL        bool                bloom_filter_test_software  (const bloom_filter_block_t& block, const hash128_t& hash);
+    SLD_INTERNAL        void                bloom_filter_set_software   (bloom_filter_block_t&       block, const hash128_t& hash);
+    SLD_INTERNAL_INLINE void                bloom_filter_masks_avx2     (const hash128_t& hash, __m256i& mask_low, __m256i& mask_high);
+    SLD_INTERNAL        bool                bloom_filter_test_avx2      (const bloom_filter_block_t& block, const hash128_t& hash);
+    SLD_INTERNAL        void                bloom_filter_set_avx2       (bloom_filter_block_t&       block, const hash128_t& hash);
+
+    SLD_INTERNAL_INLINE u16                 cuckoo_filter_fingerprint   (const hash128_t& hash);
+    SLD_INTERNAL_INLINE u32                 cuckoo_filter_index         (const cuckoo_filter_t& filter, const hash128_t& hash);
+    SLD_INTERNAL_INLINE u32                 cuckoo_filter_index_alt     (const cuckoo_filter_t& filter, const u32 index, const u16 fingerprint);
+    SLD_INTERNAL_INLINE u64                 cuckoo_filter_match         (const u64 bucket, const u16 fingerprint);
+    SLD_INTERNAL_INLINE bool                cuckoo_filter_bucket_put    (cuckoo_filter_t& filter, const u32 index, const u16 fingerprint);
+    SLD_INTERNAL_INLINE bool                cuckoo_filter_bucket_take   (cuckoo_filter_t& filter, const u32 index, const u16 fingerprint);
+    SLD_INTERNAL        void                cuckoo_filter_kick          (cuckoo_filter_t& filter, u32 index, u16 fingerprint, u32 kick_state);
+
+    //-------------------------------------------------------------------
+    // BLOOM FILTER
+    //-------------------------------------------------------------------
+
+    SLD_API u32
+    bloom_filter_block_count(
+        const u32 key_count,
+        const u32 bits_per_key) {
+
+        const u64 bits        = ((u64)key_count * bits_per_key);
+        const u64 block_count = ((bits + BLOOM_FILTER_BLOCK_BITS - 1) / BLOOM_FILTER_BLOCK_BITS);
+        return((block_count == 0) ? 1 : (u32)block_count);
+    }
+
+    SLD_API u64
+    bloom_filter_memory_size(
+        const bloom_filter_t& filter) {
+
+        const u64 size_total = ((u64)filter.block_count * sizeof(bloom_filter_block_t));
+        return(size_total);
+    }
+
+    SLD_API bool
+    bloom_filter_memory_init(
+        bloom_filter_t& filter,
+        const memory_t& memory) {
+
+        const u64 size_needed = bloom_filter_memory_size(filter);
+
+        bool can_init = true;
+        can_init &= (filter.block_count != 0);
+        can_init &= (memory.size        >= size_needed);
+        can_init &= (memory.addr        != 0);
+        can_init &= ((memory.addr & (alignof(bloom_filter_block_t) - 1)) == 0);
+        if (!can_init) return(can_init);
+
+        filter.blocks = (bloom_filter_block_t*)memory.addr;
+
+        const bool did_reset = bloom_filter_reset(filter);
+        return(did_reset);
+    }
+
+    SLD_API bool
+    bloom_filter_validate(
+        const bloom_filter_t& filter) {
+
+        bool is_valid = true;
+        is_valid &= (filter.block_count != 0);
+        is_valid &= (filter.blocks      != NULL);
+        return(is_valid);
+    }
+
+    SLD_API bool
+    bloom_filter_reset(
+        bloom_filter_t& filter) {
+
+        const bool is_valid = bloom_filter_validate(filter);
+        if (is_valid) {
+            (void)memset(filter.blocks, 0, bloom_filter_memory_size(filter));
+            filter.count = 0;
+        }
+        return(is_valid);
+    }
+
+    SLD_API bool
+    bloom_filter_insert(
+        bloom_filter_t&  filter,
+        const hash128_t& hash) {
+
+        static const bloom_filter_set_f set = bloom_filter_set_get();
+
+        const bool is_valid = bloom_filter_validate(filter);
+        if (!is_valid) return(false);
+
+        const u32 block = bloom_filter_block_index(filter, hash);
+        set(filter.blocks[block], hash);
+        ++filter.count;
+        return(true);
+    }
+
+    SLD_API bool
+    bloom_filter_contains(
+        const bloom_filter_t& filter,
+        const hash128_t&      hash) {
+
+        static const bloom_filter_test_f test = bloom_filter_test_get();
+
+        const bool is_valid = bloom_filter_validate(filter);
+        if (!is_valid) return(false);
+
+        const u32  block        = bloom_filter_block_index(filter, hash);
+        const bool is_contained = test(filter.blocks[block], hash);
+        return(is_contained);
+    }
+
+    SLD_API u32
+    bloom_filter_contains_batch(
+        const bloom_filter_t& filter,
+        const u32             count,
+        const hash128_t*      hashes,
+        bool*                 results) {
+
+        static const bloom_filter_test_f test = bloom_filter_test_get();
+
+        bool can_test = true;
+        can_test &= bloom_filter_validate(filter);
+        can_test &= (hashes  != NULL);
+        can_test &= (results != NULL);
+        if (!can_test) return(0);
+
+        // every block of a batch is requested before the first test, so
+        // the misses overlap instead of stalling one key after another
+        u32 contained_count = 0;
+        for (
+            u32 batch_start = 0;
+                batch_start < count;
+                batch_start += HASH_FILTER_BATCH_SIZE) {
+
+            const u32 batch_count = ((count - batch_start) < HASH_FILTER_BATCH_SIZE)
+                ? (count - batch_start)
+                : HASH_FILTER_BATCH_SIZE;
+
+            u32 blocks[HASH_FILTER_BATCH_SIZE];
+            for (
+                u32 index = 0;
+                    index < batch_count;
+                  ++index) {
+
+                blocks[index] = bloom_filter_block_index(filter, hashes[batch_start + index]);
+                _mm_prefetch((const char*)&filter.blocks[blocks[index]], _MM_HINT_T0);
+            }
+
+            for (
+                u32 index = 0;
+                    index < batch_count;
+                  ++index) {
+
+                const bool is_contained = test(filter.blocks[blocks[index]], hashes[batch_start + index]);
+                results[batch_start + index] = is_contained;
+                contained_count += is_contained ? 1 : 0;
+            }
+        }
+
+        return(contained_count);
+    }
+
+    //-------------------------------------------------------------------
+    // CUCKOO FILTER
+    //-------------------------------------------------------------------
+
+    SLD_API u32
+    cuckoo_filter_bucket_count(
+        const u32 key_count) {
+
+        // enough slots to stay under the load the kicks can still reach
+        const u64 slot_count   = (((u64)key_count * 100) + CUCKOO_FILTER_LOAD_PERCENT - 1) / CUCKOO_FILTER_LOAD_PERCENT;
+        const u64 bucket_count = size_round_up_pow2((slot_count + CUCKOO_FILTER_SLOT_COUNT - 1) / CUCKOO_FILTER_SLOT_COUNT);
+        return((bucket_count < CUCKOO_FILTER_BUCKET_COUNT_MIN) ? CUCKOO_FILTER_BUCKET_COUNT_MIN : (u32)bucket_count);
+    }
+
+    SLD_API u64
+    cuckoo_filter_memory_size(
+        const cuckoo_filter_t& filter) {
+
+        const u64 size_total = ((u64)filter.bucket_count * sizeof(u64));
+        return(size_total);
+    }
+
+    SLD_API bool
+    cuckoo_filter_memory_init(
+        cuckoo_filter_t& filter,
+        const memory_t&  memory) {
+
+        const u64 size_needed = cuckoo_filter_memory_size(filter);
+
+        bool can_init = true;
+        can_init &= (filter.bucket_count >= CUCKOO_FILTER_BUCKET_COUNT_MIN);
+        can_init &= size_is_pow_2(filter.bucket_count);
+        can_init &= (memory.size         >= size_needed);
+        can_init &= (memory.addr         != 0);
+        can_init &= ((memory.addr & (alignof(u64) - 1)) == 0);
+        if (!can_init) return(can_init);
+
+        filter.buckets = (u64*)memory.addr;
+
+        const bool did_reset = cuckoo_filter_reset(filter);
+        return(did_reset);
+    }
+
+    SLD_API bool
+    cuckoo_filter_validate(
+        const cuckoo_filter_t& filter) {
+
+        bool is_valid = true;
+        is_valid &= (filter.bucket_count >= CUCKOO_FILTER_BUCKET_COUNT_MIN);
+        is_valid &= size_is_pow_2(filter.bucket_count);
+        is_valid &= (filter.count        <= (filter.bucket_count * CUCKOO_FILTER_SLOT_COUNT) + 1);
+        is_valid &= (filter.buckets      != NULL);
+        return(is_valid);
+    }
+
+    SLD_API bool
+    cuckoo_filter_reset(
+        cuckoo_filter_t& filter) {
+
+        filter.count = 0;
+
+        const bool is_valid = cuckoo_filter_validate(filter);
+        if (is_valid) {
+            (void)memset(filter.buckets, 0, cuckoo_filter_memory_size(filter));
+            filter.victim = {};
+        }
+        return(is_valid);
+    }
+
+    SLD_API bool
+    cuckoo_filter_insert(
+        cuckoo_filter_t& filter,
+        const hash128_t& hash) {
+
+        bool can_insert = true;
+        can_insert &= cuckoo_filter_validate(filter);
+        can_insert &= !filter.victim.is_used;
+        if (!can_insert) return(false);
+
+        const u16 fingerprint = cuckoo_filter_fingerprint (hash);
+        const u32 index       = cuckoo_filter_index       (filter, hash);
+        const u32 index_alt   = cuckoo_filter_index_alt   (filter, index, fingerprint);
+
+        const bool did_put =
+            cuckoo_filter_bucket_put(filter, index,     fingerprint) ||
+            cuckoo_filter_bucket_put(filter, index_alt, fingerprint);
+
+        if (!did_put) {
+            const u32 kick_state = (hash.val.as_u32[2] | 1);
+            const u32 kick_index = (kick_state & 2) ? index_alt : index;
+            cuckoo_filter_kick(filter, kick_index, fingerprint, kick_state);
+        }
+
+        ++filter.count;
+        return(true);
+    }
+
+    SLD_API bool
+    cuckoo_filter_remove(
+        cuckoo_filter_t& filter,
+        const hash128_t& hash) {
+
+        const bool is_valid = cuckoo_filter_validate(filter);
+        if (!is_valid) return(false);
+
+        const u16 fingerprint = cuckoo_filter_fingerprint (hash);
+        const u32 index       = cuckoo_filter_index       (filter, hash);
+        const u32 index_alt   = cuckoo_filter_index_alt   (filter, index, fingerprint);
+
+        bool is_victim = true;
+        is_victim &= filter.victim.is_used;
+        is_victim &= (filter.victim.fingerprint == fingerprint);
+        is_victim &= (filter.victim.index == index || filter.victim.index == index_alt);
+        if (is_victim) {
+            filter.victim = {};
+            --filter.count;
+            return(true);
+        }
+
+        const bool did_take =
+            cuckoo_filter_bucket_take(filter, index,     fingerprint) ||
+            cuckoo_filter_bucket_take(filter, index_alt, fingerprint);
+        if (!did_take) return(false);
+
+        --filter.count;
+
+        // the slot that just opened up might be the one the victim needs
+        if (filter.victim.is_used) {
+            const u32 victim_index       = filter.victim.index;
+            const u16 victim_fingerprint = filter.victim.fingerprint;
+            const u32 victim_index_alt   = cuckoo_filter_index_alt(filter, victim_index, victim_fingerprint);
+            filter.victim = {};
+
+            const bool did_put =
+                cuckoo_filter_bucket_put(filter, victim_index,     victim_fingerprint) ||
+                cuckoo_filter_bucket_put(filter, victim_index_alt, victim_fingerprint);
+
+            if (!did_put) cuckoo_filter_kick(filter, victim_index, victim_fingerprint, (hash.val.as_u32[2] | 1));
+        }
+        return(true);
+    }
+
+    SLD_API bool
+    cuckoo_filter_contains(
+        const cuckoo_filter_t& filter,
+        const hash128_t&       hash) {
+
+        const bool is_valid = cuckoo_filter_validate(filter);
+        if (!is_valid) return(false);
+
+        const u16 fingerprint = cuckoo_filter_fingerprint (hash);
+        const u32 index       = cuckoo_filter_index       (filter, hash);
+        const u32 index_alt   = cuckoo_filter_index_alt   (filter, index, fingerprint);
+
+        const u64 match =
+            cuckoo_filter_match(filter.buckets[index],     fingerprint) |
+            cuckoo_filter_match(filter.buckets[index_alt], fingerprint);
+
+        bool is_victim = true;
+        is_victim &= filter.victim.is_used;
+        is_victim &= (filter.victim.fingerprint == fingerprint);
+        is_victim &= (filter.victim.index == index || filter.victim.index == index_alt);
+
+        const bool is_contained = (match != 0) || is_victim;
+        return(is_contained);
+    }
+
+    SLD_API u32
+    cuckoo_filter_contains_batch(
+        const cuckoo_filter_t& filter,
+        const u32              count,
+        const hash128_t*       hashes,
+        bool*                  results) {
+
+        bool can_test = true;
+        can_test &= cuckoo_filter_validate(filter);
+        can_test &= (hashes  != NULL);
+        can_test &= (results != NULL);
+        if (!can_test) return(0);
+
+        // both buckets of every key in a batch are requested before the
+        // first test, so the misses overlap
+        u32 contained_count = 0;
+        for (
+            u32 batch_start = 0;
+                batch_start < count;
+                batch_start += HASH_FILTER_BATCH_SIZE) {
+
+            const u32 batch_count = ((count - batch_start) < HASH_FILTER_BATCH_SIZE)
+                ? (count - batch_start)
+                : HASH_FILTER_BATCH_SIZE;
+
+            for (
+                u32 index = 0;
+                    index < batch_count;
+                  ++index) {
+
+                const hash128_t& hash        = hashes[batch_start + index];
+                const u16        fingerprint = cuckoo_filter_fingerprint (hash);
+                const u32        bucket      = cuckoo_filter_index       (filter, hash);
+                const u32        bucket_alt  = cuckoo_filter_index_alt   (filter, bucket, fingerprint);
+                _mm_prefetch((const char*)&filter.buckets[bucket],     _MM_HINT_T0);
+                _mm_prefetch((const char*)&filter.buckets[bucket_alt], _MM_HINT_T0);
+            }
+
+            for (
+                u32 index = 0;
+                    index < batch_count;
+                  ++index) {
+
+                const bool is_contained = cuckoo_filter_contains(filter, hashes[batch_start + index]);
+                results[batch_start + index] = is_contained;
+                contained_count += is_contained ? 1 : 0;
+            }
+        }
+
+        return(contained_count);
+    }
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_INTERNAL_INLINE u32
+    bloom_filter_block_index(
+        const bloom_filter_t& filter,
+        const hash128_t&      hash) {
+
+        // lane 0 scaled onto the block count, no modulo and no power of two
+        const u32 block = (u32)(((u64)hash.val.as_u32[0] * filter.block_count) >> 32);
+        return(block);
+    }
+
+    SLD_INTERNAL_INLINE u32
+    bloom_filter_bit(
+        const hash128_t& hash,
+        const u32        word) {
+
+        const u32 lane = (word < 4) ? hash.val.as_u32[1] : hash.val.as_u32[2];
+        const u32 bit  = ((lane * BLOOM_FILTER_SALT[word]) >> 26);
+        return(bit);
+    }
+
+    SLD_INTERNAL bloom_filter_test_f
+    bloom_filter_test_get(
+        void) {
+
+        const bloom_filter_test_f test = (simd_get_level() >= simd_level_e_avx2)
+            ? bloom_filter_test_avx2
+            : bloom_filter_test_software;
+
+        return(test);
+    }
+
+    SLD_INTERNAL bloom_filter_set_f
+    bloom_filter_set_get(
+        void) {
+
+        const bloom_filter_set_f set = (simd_get_level() >= simd_level_e_avx2)
+            ? bloom_filter_set_avx2
+            : bloom_filter_set_software;
+
+        return(set);
+    }
+
+    SLD_INTERNAL bool
+    bloom_filter_test_software(
+        const bloom_filter_block_t& block,
+        const hash128_t&            hash) {
+
+        u64 missing = 0;
+        for (
+            u32 word = 0;
+                word < 8;
+              ++word) {
+
+            const u64 mask = (1ULL << bloom_filter_bit(hash, word));
+            missing |= (mask & ~block.words[word]);
+        }
+        return(missing == 0);
+    }
+
+    SLD_INTERNAL void
+    bloom_filter_set_software(
+        bloom_filter_block_t& block,
+        const hash128_t&      hash) {
+
+        for (
+            u32 word = 0;
+                word < 8;
+              ++word) {
+
+            block.words[word] |= (1ULL << bloom_filter_bit(hash, word));
+        }
+    }
+
+    SLD_INTERNAL_INLINE SLD_SIMD_TARGET("avx2") void
+    bloom_filter_masks_avx2(
+        const hash128_t& hash,
+        __m256i&         mask_low,
+        __m256i&         mask_high) {
+
+        // the 8 multiplies in one go, then each 6 bit result becomes a bit
+        // in its own u64 word
+        const u32     lane_1 = hash.val.as_u32[1];
+        const u32     lane_2 = hash.val.as_u32[2];
+        const __m256i lanes  = _mm256_setr_epi32((int)lane_1, (int)lane_1, (int)lane_1, (int)lane_1, (int)lane_2, (int)lane_2, (int)lane_2, (int)lane_2);
+        const __m256i salt   = _mm256_loadu_si256((const __m256i*)BLOOM_FILTER_SALT);
+        const __m256i bits   = _mm256_srli_epi32(_mm256_mullo_epi32(lanes, salt), 26);
+        const __m256i one    = _mm256_set1_epi64x(1);
+
+        mask_low  = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(bits)));
+        mask_high = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(bits, 1)));
+    }
+
+    SLD_INTERNAL SLD_SIMD_TARGET("avx2") bool
+    bloom_filter_test_avx2(
+        const bloom_filter_block_t& block,
+        const hash128_t&            hash) {
+
+        __m256i mask_low, mask_high;
+        bloom_filter_masks_avx2(hash, mask_low, mask_high);
+
+        // testc is set when every bit of the mask is set in the block
+        const __m256i block_low  = _mm256_load_si256((const __m256i*)&block.words[0]);
+        const __m256i block_high = _mm256_load_si256((const __m256i*)&block.words[4]);
+        const bool    is_set     = (_mm256_testc_si256(block_low, mask_low) & _mm256_testc_si256(block_high, mask_high)) != 0;
+        return(is_set);
+    }
+
+    SLD_INTERNAL SLD_SIMD_TARGET("avx2") void
+    bloom_filter_set_avx2(
+        bloom_filter_block_t& block,
+        const hash128_t&      hash) {
+
+        __m256i mask_low, mask_high;
+        bloom_filter_masks_avx2(hash, mask_low, mask_high);
+
+        __m256i* words = (__m256i*)block.words;
+        _mm256_store_si256(&words[0], _mm256_or_si256(_mm256_load_si256(&words[0]), mask_low));
+        _mm256_store_si256(&words[1], _mm256_or_si256(_mm256_load_si256(&words[1]), mask_high));
+    }
+
+    SLD_INTERNAL_INLINE u16
+    cuckoo_filter_fingerprint(
+        const hash128_t& hash) {
+
+        // 0 marks an empty slot, so it can't be a fingerprint
+        const u16 fingerprint = (u16)hash.val.as_u32[3];
+        return((fingerprint == 0) ? 1 : fingerprint);
+    }
+
+    SLD_INTERNAL_INLINE u32
+    cuckoo_filter_index(
+        const cuckoo_filter_t& filter,
+        const hash128_t&       hash) {
+
+        const u32 index = (hash.val.as_u32[0] & (filter.bucket_count - 1));
+        return(index);
+    }
+
+    SLD_INTERNAL_INLINE u32
+    cuckoo_filter_index_alt(
+        const cuckoo_filter_t& filter,
+        const u32              index,
+        const u16              fingerprint) {
+
+        // an xor, so the alternate of the alternate is where we started
+        const u32 index_alt = ((index ^ (fingerprint * CUCKOO_FILTER_ALT_MULTIPLIER)) & (filter.bucket_count - 1));
+        return(index_alt);
+    }
+
+    SLD_INTERNAL_INLINE u64
+    cuckoo_filter_match(
+        const u64 bucket,
+        const u16 fingerprint) {
+
+        const u64 diff  = bucket ^ (CUCKOO_FILTER_SLOT_LOW_BITS * fingerprint);
+        const u64 match = (diff - CUCKOO_FILTER_SLOT_LOW_BITS) & ~diff & CUCKOO_FILTER_SLOT_HIGH_BITS;
+        return(match);
+    }
+
+    SLD_INTERNAL_INLINE bool
+    cuckoo_filter_bucket_put(
+        cuckoo_filter_t& filter,
+        const u32        index,
+        const u16        fingerprint) {
+
+        const u64 empty = cuckoo_filter_match(filter.buckets[index], 0);
+        if (empty == 0) return(false);
+
+        const u32 shift = (bit_scan_forward(empty) & ~15u);
+        filter.buckets[index] |= ((u64)fingerprint << shift);
+        return(true);
+    }
+
+    SLD_INTERNAL_INLINE bool
+    cuckoo_filter_bucket_take(
+        cuckoo_filter_t& filter,
+        const u32        index,
+        const u16        fingerprint) {
+
+        const u64 match = cuckoo_filter_match(filter.buckets[index], fingerprint);
+        if (match == 0) return(false);
+
+        const u32 shift = (bit_scan_forward(match) & ~15u);
+        filter.buckets[index] &= ~(0xFFFFULL << shift);
+        return(true);
+    }
+
+    SLD_INTERNAL void
+    cuckoo_filter_kick(
+        cuckoo_filter_t& filter,
+        u32              index,
+        u16              fingerprint,
+        u32              kick_state) {
+
+        // swap with a slot picked by the state, then try to put what came
+        // out in its other bucket. the state is a xorshift, so it never
+        // lands on 0 as long as it didn't start there
+        for (
+            u32 kick = 0;
+                kick < CUCKOO_FILTER_KICK_MAX;
+              ++kick) {
+
+            const u32 shift   = ((kick_state & (CUCKOO_FILTER_SLOT_COUNT - 1)) * 16);
+            const u16 evicted = (u16)(filter.buckets[index] >> shift);
+            filter.buckets[index] &= ~(0xFFFFULL << shift);
+            filter.buckets[index] |=  ((u64)fingerprint << shift);
+
+            fingerprint = evicted;
+            index       = cuckoo_filter_index_alt(filter, index, fingerprint);
+            if (cuckoo_filter_bucket_put(filter, index, fingerprint)) return;
+
+            kick_state ^= (kick_state << 13);
+            kick_state ^= (kick_state >> 17);
+            kick_state ^= (kick_state << 5);
+        }
+
+        filter.victim.index       = index;
+        filter.victim.fingerprint = fingerprint;
+        filter.victim.is_used     = true;
+    }
+};
\ No newline at end of file
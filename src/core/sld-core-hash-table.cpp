@@ -1,223 +1,1126 @@
 #pragma once
 
 #include "sld-hash-table.hpp"
+#include "sld-simd.hpp"
 
 namespace sld {
 
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_INTERNAL_INLINE u32  hash_table_h1          (const hash128_t& hash)                         { return((u32)hash.val.as_u64[0]);                                                 }
+    SLD_INTERNAL_INLINE u8   hash_table_h2          (const hash128_t& hash)                         { return((u8)(hash.val.as_u64[1] & 0x7F));                                          }
+    SLD_INTERNAL_INLINE bool hash_table_is_full     (const u8 control)                              { return((control & 0x80) == 0);                                                    }
+    SLD_INTERNAL_INLINE u32  hash_table_max_load    (const u32 capacity)                            { return(capacity - (capacity / 8));                                                }
+    SLD_INTERNAL_INLINE bool hash_table_hash_equal  (const hash128_t& a, const hash128_t& b)        { return((a.val.as_u64[0] == b.val.as_u64[0]) && (a.val.as_u64[1] == b.val.as_u64[1])); }
+
+    SLD_INTERNAL_INLINE __m128i hash_table_group_load              (const hash_table_t& hash_table, const u32 index) { return(_mm_loadu_si128((const __m128i*)&hash_table.array.control[index]));                             }
+    SLD_INTERNAL_INLINE u32     hash_table_group_match_tag         (const __m128i group, const u8 tag)                { return((u32)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)tag))));                      }
+    SLD_INTERNAL_INLINE u32     hash_table_group_match_empty       (const __m128i group)                              { return((u32)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)HASH_TABLE_CONTROL_EMPTY)))); }
+    SLD_INTERNAL_INLINE u32     hash_table_group_match_non_full    (const __m128i group)                              { return((u32)_mm_movemask_epi8(group));                                                               }
+
+    SLD_INTERNAL_INLINE void
+    hash_table_set_control(
+        hash_table_t& hash_table,
+        const u32     index,
+        const u8      control) {
+
+        // keep the mirrored first group in sync
+        hash_table.array.control[index] = control;
+        if (index < HASH_TABLE_GROUP_WIDTH) {
+            hash_table.array.control[hash_table.capacity + index] = control;
+        }
+    }
+
+    SLD_INTERNAL_INLINE byte*
+    hash_table_value_at(
+        const hash_table_t& hash_table,
+        const u32           index) {
+
+        byte* value = &hash_table.array.value[(u64)index * hash_table.stride];
+        return(value);
+    }
+
+    SLD_INTERNAL u32
+    hash_table_find_index(
+        const hash_table_t& hash_table,
+        const hash128_t&    hash) {
+
+        // groups are probed at triangular offsets, which visits every
+        // group once when the group count is a power of two
+        const u32 mask        = (hash_table.capacity - 1);
+        const u32 group_count = (hash_table.capacity / HASH_TABLE_GROUP_WIDTH);
+        const u8  tag         = hash_table_h2(hash);
+        u32       position    = (hash_table_h1(hash) & mask);
+        u32       stride      = 0;
+
+        for (
+            u32 probe = 0;
+                probe < group_count;
+              ++probe) {
+
+            const __m128i group = hash_table_group_load(hash_table, position);
+
+            u32 match = hash_table_group_match_tag(group, tag);
+            while (match != 0) {
+
+                const u32 index = (position + bit_scan_forward(match)) & mask;
+                if (hash_table_hash_equal(hash_table.array.hash[index], hash)) {
+                    return(index);
+                }
+                match &= (match - 1);
+            }
+
+            // an empty slot ends every probe sequence that passed it
+            if (hash_table_group_match_empty(group) != 0) break;
+
+            stride   += HASH_TABLE_GROUP_WIDTH;
+            position  = (position + stride) & mask;
+        }
+
+        return(HASH_TABLE_INDEX_INVALID);
+    }
+
+    SLD_INTERNAL u32
+    hash_table_find_first_non_full(
+        const hash_table_t& hash_table,
+        const hash128_t&    hash) {
+
+        const u32 mask     = (hash_table.capacity - 1);
+        u32       position = (hash_table_h1(hash) & mask);
+        u32       stride   = 0;
+
+        for (;;) {
+
+            const __m128i group = hash_table_group_load(hash_table, position);
+            const u32     match = hash_table_group_match_non_full(group);
+            if (match != 0) {
+                const u32 index = (position + bit_scan_forward(match)) & mask;
+                return(index);
+            }
+
+            stride   += HASH_TABLE_GROUP_WIDTH;
+            position  = (position + stride) & mask;
+        }
+    }
+
+    SLD_INTERNAL_INLINE bool
+    hash_table_was_never_full(
+        const hash_table_t& hash_table,
+        const u32           index) {
+
+        // if no window of 16 slots around this one was ever full, no probe
+        // sequence went past it and it can go straight back to empty
+        const u32 mask         = (hash_table.capacity - 1);
+        const u32 index_before = (index - HASH_TABLE_GROUP_WIDTH) & mask;
+        const u32 empty_after  = hash_table_group_match_empty(hash_table_group_load(hash_table, index));
+        const u32 empty_before = hash_table_group_match_empty(hash_table_group_load(hash_table, index_before));
+        if (empty_before == 0 || empty_after == 0) return(false);
+
+        const u32 leading_zeros  = (HASH_TABLE_GROUP_WIDTH - 1) - bit_scan_reverse(empty_before);
+        const u32 trailing_zeros = bit_scan_forward(empty_after);
+        return((leading_zeros + trailing_zeros) < HASH_TABLE_GROUP_WIDTH);
+    }
+
+    SLD_INTERNAL void
+    hash_table_swap_slots(
+        hash_table_t& hash_table,
+        const u32     index_a,
+        const u32     index_b) {
+
+        const hash128_t hash_tmp = hash_table.array.hash[index_a];
+        hash_table.array.hash[index_a] = hash_table.array.hash[index_b];
+        hash_table.array.hash[index_b] = hash_tmp;
+
+        byte* value_a = hash_table_value_at(hash_table, index_a);
+        byte* value_b = hash_table_value_at(hash_table, index_b);
+        byte  chunk[64];
+        for (
+            u32 offset = 0;
+                offset < hash_table.stride;
+                offset += sizeof(chunk)) {
+
+            const u32 size = ((hash_table.stride - offset) < sizeof(chunk))
+                ? (hash_table.stride - offset)
+                : sizeof(chunk);
+
+            (void)memcpy(chunk,            &value_a[offset], size);
+            (void)memcpy(&value_a[offset], &value_b[offset], size);
+            (void)memcpy(&value_b[offset], chunk,            size);
+        }
+    }
+
+    SLD_INTERNAL void
+    hash_table_drop_tombstones(
+        hash_table_t& hash_table) {
+
+        // rehash in place. full slots are marked deleted and empty ones
+        // stay empty, then every marked slot moves to the first free slot
+        // of its own probe sequence
+        const u32 mask = (hash_table.capacity - 1);
+        for (
+            u32 index = 0;
+                index < hash_table.capacity;
+              ++index) {
+
+            const u8 control = hash_table.array.control[index];
+            hash_table_set_control(hash_table, index, hash_table_is_full(control)
+                ? HASH_TABLE_CONTROL_DELETED
+                : HASH_TABLE_CONTROL_EMPTY);
+        }
+
+        for (
+            u32 index = 0;
+                index < hash_table.capacity;
+              ++index) {
+
+            if (hash_table.array.control[index] != HASH_TABLE_CONTROL_DELETED) continue;
+
+            const hash128_t hash   = hash_table.array.hash[index];
+            const u8        tag    = hash_table_h2(hash);
+            const u32       start  = (hash_table_h1(hash) & mask);
+            const u32       target = hash_table_find_first_non_full(hash_table, hash);
+
+            // already in the right group, leave it there
+            const u32 group_current = ((index  - start) & mask) / HASH_TABLE_GROUP_WIDTH;
+            const u32 group_target  = ((target - start) & mask) / HASH_TABLE_GROUP_WIDTH;
+            if (group_current == group_target) {
+                hash_table_set_control(hash_table, index, tag);
+                continue;
+            }
+
+            if (hash_table.array.control[target] == HASH_TABLE_CONTROL_EMPTY) {
+
+                // move it and free the old slot
+                hash_table.array.hash[target] = hash;
+                (void)memcpy(
+                    hash_table_value_at(hash_table, target),
+                    hash_table_value_at(hash_table, index),
+                    hash_table.stride);
+                hash_table_set_control(hash_table, target, tag);
+                hash_table_set_control(hash_table, index,  HASH_TABLE_CONTROL_EMPTY);
+            }
+            else {
+
+                // the target still holds a slot we haven't placed, swap
+                // and place whatever landed here next
+                hash_table_set_control (hash_table, target, tag);
+                hash_table_swap_slots  (hash_table, index,  target);
+                --index;
+            }
+        }
+
+        hash_table.tombstone_count = 0;
+    }
+
+    SLD_INTERNAL_INLINE void
+    hash_table_prefetch(
+        const hash_table_t& hash_table,
+        const hash128_t&    hash) {
+
+        // the control group decides the probe, the hash and value at the
+        // home slot are where a hit usually lands
+        const u32 index = (hash_table_h1(hash) & (hash_table.capacity - 1));
+        _mm_prefetch((const char*)&hash_table.array.control[index], _MM_HINT_T0);
+        _mm_prefetch((const char*)&hash_table.array.hash[index],    _MM_HINT_T0);
+        _mm_prefetch((const char*)hash_table_value_at(hash_table, index), _MM_HINT_T0);
+    }
+
+    SLD_INTERNAL_INLINE hash_table_t
+    hash_table_old_view(
+        const hash_table_t& hash_table) {
+
+        // the table being drained, dressed up so the probe helpers work on it
+        hash_table_t view  = {};
+        view.capacity      = hash_table.old.capacity;
+        view.stride        = hash_table.stride;
+        view.count         = hash_table.old.count;
+        view.array.control = hash_table.old.control;
+        view.array.hash    = hash_table.old.hash;
+        view.array.value   = hash_table.old.value;
+        return(view);
+    }
+
     SLD_INTERNAL bool
+    hash_table_find(
+        const hash_table_t& hash_table,
+        const hash128_t&    hash,
+        hash_table_value_t& value) {
+
+        const u32 index = hash_table_find_index(hash_table, hash);
+        if (index != HASH_TABLE_INDEX_INVALID) {
+            value.index = index;
+            value.data  = hash_table_value_at(hash_table, index);
+            return(true);
+        }
+
+        if (!hash_table_is_resizing(hash_table)) return(false);
+
+        // not migrated yet. the data is good until the next insert or
+        // remove, but there is no index in the current table to give out
+        const hash_table_t old_view  = hash_table_old_view   (hash_table);
+        const u32          old_index = hash_table_find_index (old_view, hash);
+        if (old_index == HASH_TABLE_INDEX_INVALID) return(false);
+
+        value.index = HASH_TABLE_INDEX_INVALID;
+        value.data  = hash_table_value_at(old_view, old_index);
+        return(true);
+    }
+
+    SLD_INTERNAL void
+    hash_table_old_remove_at(
+        hash_table_t& hash_table,
+        const u32     old_index) {
+
+        // always a tombstone, the old table only shrinks from here
+        hash_table_t old_view = hash_table_old_view(hash_table);
+        hash_table_set_control(old_view, old_index, HASH_TABLE_CONTROL_DELETED);
+        --hash_table.old.count;
+    }
+
+    SLD_INTERNAL u32
+    hash_table_migrate_slot(
+        hash_table_t& hash_table,
+        const u32     old_index) {
+
+        const hash128_t& hash  = hash_table.old.hash[old_index];
+        const u32        index = hash_table_find_first_non_full(hash_table, hash);
+        if (hash_table.array.control[index] == HASH_TABLE_CONTROL_DELETED) {
+            --hash_table.tombstone_count;
+        }
+
+        hash_table_set_control(hash_table, index, hash_table_h2(hash));
+        hash_table.array.hash[index] = hash;
+        (void)memcpy(
+            hash_table_value_at(hash_table, index),
+            &hash_table.old.value[(u64)old_index * hash_table.stride],
+            hash_table.stride);
+        ++hash_table.count;
+
+        hash_table_old_remove_at(hash_table, old_index);
+        return(index);
+    }
+
+    SLD_INTERNAL void
+    hash_table_old_release(
+        hash_table_t& hash_table) {
+
+        if (hash_table.old.arena != NULL) {
+            arena_allocator_decommit(hash_table.allocator, hash_table.old.arena);
+        }
+        hash_table.old = {};
+    }
+
+    SLD_INTERNAL bool
+    hash_table_resize_begin(
+        hash_table_t& hash_table) {
+
+        if (hash_table.allocator == NULL) return(false);
+
+        // only one migration at a time
+        hash_table_resize_finish(hash_table);
+
+        // double when the live entries are what filled it. when it is
+        // mostly tombstones, migrating into a table of the same size
+        // clears them without a stop the world rehash
+        const bool should_grow  = (hash_table.count >= (hash_table.capacity / 2));
+        hash_table_t new_table  = {};
+        new_table.capacity      = should_grow ? (hash_table.capacity * 2) : hash_table.capacity;
+        new_table.stride        = hash_table.stride;
+        if (new_table.capacity < hash_table.capacity) return(false);
+
+        const u64 size_new = hash_table_memory_size(new_table);
+        arena_t*  arena    = arena_allocator_commit(hash_table.allocator);
+        if (arena == NULL) return(false);
+
+        memory_t memory;
+        memory.size = size_new;
+        memory.ptr  = arena_push_bytes(arena, size_new, alignof(hash128_t));
+        if (memory.ptr == NULL) {
+            arena_allocator_decommit(hash_table.allocator, arena);
+            return(false);
+        }
+
+        const u64 size_hash  = ((u64)new_table.capacity * sizeof(hash128_t));
+        const u64 size_value = ((u64)new_table.capacity * new_table.stride);
+
+        hash_table.old.arena    = hash_table.arena;
+        hash_table.old.capacity = hash_table.capacity;
+        hash_table.old.count    = hash_table.count;
+        hash_table.old.position = 0;
+        hash_table.old.control  = hash_table.array.control;
+        hash_table.old.hash     = hash_table.array.hash;
+        hash_table.old.value    = hash_table.array.value;
+
+        hash_table.arena           = arena;
+        hash_table.capacity        = new_table.capacity;
+        hash_table.count           = 0;
+        hash_table.tombstone_count = 0;
+        hash_table.array.hash      = (hash128_t*)(memory.addr);
+        hash_table.array.value     =      (byte*)(memory.addr + size_hash);
+        hash_table.array.control   =        (u8*)(memory.addr + size_hash + size_value);
+        (void)memset(
+            hash_table.array.control,
+            HASH_TABLE_CONTROL_EMPTY,
+            hash_table.capacity + HASH_TABLE_GROUP_WIDTH);
+
+        return(true);
+    }
+
+    SLD_INTERNAL_INLINE void
+    hash_table_snapshot_layout(
+        const hash_table_t&           hash_table,
+        hash_table_snapshot_header_t& header) {
+
+        const u64 size_hash    = ((u64)hash_table.capacity * sizeof(hash128_t));
+        const u64 size_value   = ((u64)hash_table.capacity * hash_table.stride);
+        const u64 size_control = ((u64)hash_table.capacity + HASH_TABLE_GROUP_WIDTH);
+
+        header.magic           = HASH_TABLE_SNAPSHOT_MAGIC;
+        header.version         = HASH_TABLE_SNAPSHOT_VERSION;
+        header.capacity        = hash_table.capacity;
+        header.stride          = hash_table.stride;
+        header.count           = hash_table.count;
+        header.tombstone_count = hash_table.tombstone_count;
+        header.offset_hash     = size_align_pow_2(sizeof(hash_table_snapshot_header_t), HASH_TABLE_SNAPSHOT_ALIGNMENT);
+        header.offset_value    = header.offset_hash  + size_hash;
+        header.offset_control  = header.offset_value + size_value;
+        header.size            = header.offset_control + size_control;
+    }
+
+    //-------------------------------------------------------------------
+    // API
+    //-------------------------------------------------------------------
+
+    SLD_API bool
     hash_table_validate(
         const hash_table_t& hash_table) {
 
         bool is_valid = true;
 
-        is_valid &= (hash_table.capacity    != 0);
-        is_valid &= (hash_table.stride      != 0);
-        is_valid &= (hash_table.count       <= hash_table.capacity);
-        is_valid &= (hash_table.array.hash  != NULL);
-        is_valid &= (hash_table.array.value != NULL);
+        is_valid &= (hash_table.capacity      >= HASH_TABLE_CAPACITY_MIN);
+        is_valid &= size_is_pow_2(hash_table.capacity);
+        is_valid &= (hash_table.stride        != 0);
+        is_valid &= (hash_table.count         <= hash_table_max_load(hash_table.capacity));
+        is_valid &= (hash_table.array.control != NULL);
+        is_valid &= (hash_table.array.hash    != NULL);
+        is_valid &= (hash_table.array.value   != NULL);
 
         return(is_valid);
     }
 
-    SLD_INTERNAL bool
+    SLD_API bool
     hash_table_validate_key(
-        const hash_table_t&     hash_table,
         const hash_table_key_t& key) {
 
+        // keys are hashed with a u32 length
         bool is_valid = true;
-        
+
         is_valid &= (key.data   != NULL);
         is_valid &= (key.length != 0);
-        
+        is_valid &= (key.length <= 0xFFFFFFFF);
+
         return(is_valid);
     }
 
-    SLD_INTERNAL bool
+    SLD_API bool
     hash_table_validate_value(
-        const hash_table_t&         hash_table,
-        const hash_table_value_t&   value) {
-
-        const u32  size_hash  = (hash_table.capacity  * sizeof(hash_t));
-        const u32  size_value = (hash_table.capacity  * hash_table.stride);
-        const u32  size_total = (size_hash + size_value);
-        const addr data_start = (addr)hash_table.array.hash + size_hash;
-        const addr data_end   = (addr)hash_table.array.hash + size_total;
+        const hash_table_t&       hash_table,
+        const hash_table_value_t& value) {
+
+        const u64  size_value = ((u64)hash_table.capacity * hash_table.stride);
+        const addr data_start = (addr)hash_table.array.value;
+        const addr data_end   = (addr)hash_table.array.value + size_value;
         const addr data_value = (addr)value.data;
 
         bool is_valid = true;
-        
-        is_valid &= (value.index < hash_table.count);
+
+        is_valid &= (value.index < hash_table.capacity);
         is_valid &= (data_value >= data_start);
         is_valid &= (data_value  < data_end);
-        
+        if (is_valid) {
+            is_valid &= (data_value == (addr)hash_table_value_at(hash_table, (u32)value.index));
+            is_valid &= hash_table_is_full(hash_table.array.control[value.index]);
+        }
+
         return(is_valid);
     }
 
-    SLD_INTERNAL const u32
+    SLD_API u64
     hash_table_memory_size(
         const hash_table_t& hash_table) {
 
-        const u32 size_hash  = (hash_table.capacity  * sizeof(hash_t));
-        const u32 size_value = (hash_table.capacity  * hash_table.stride);
-        const u32 size_total = (size_hash + size_value);
+        // in u64, a big table with a wide stride doesn't fit in 32 bits
+        const u64 size_hash    = ((u64)hash_table.capacity * sizeof(hash128_t));
+        const u64 size_value   = ((u64)hash_table.capacity * hash_table.stride);
+        const u64 size_control = ((u64)hash_table.capacity + HASH_TABLE_GROUP_WIDTH);
+        const u64 size_total   = (size_hash + size_value + size_control);
 
         return(size_total);
     }
-    
-    SLD_INTERNAL bool
+
+    SLD_API bool
     hash_table_memory_init(
         hash_table_t&   hash_table,
         const memory_t& memory) {
 
-        const u32 size_hash  = (hash_table.capacity  * sizeof(hash_t));
-        const u32 size_value = (hash_table.capacity  * hash_table.stride);
-        const u32 size_total = (size_hash + size_value);
+        const u64 size_hash   = ((u64)hash_table.capacity * sizeof(hash128_t));
+        const u64 size_value  = ((u64)hash_table.capacity * hash_table.stride);
+        const u64 size_needed = hash_table_memory_size(hash_table);
 
         bool can_init = true;
-        can_init &= (memory.size  >= size_needed);
-        can_init &= (memory.start != 0);
-        if (!can_init) return(can_init);
+        can_init &= (hash_table.capacity >= HASH_TABLE_CAPACITY_MIN);
+        can_init &= size_is_pow_2(hash_table.capacity);
+        can_init &= (hash_table.stride   != 0);
+        can_init &= (memory.size         >= size_needed);
+        can_init &= (memory.addr         != 0);
+        can_init &= ((memory.addr & (alignof(hash128_t) - 1)) == 0);
+        if (!can_init) {
+            hash_table.error.val = hash_table_error_e_not_enough_memory;
+            return(can_init);
+        }
+
+        // hashes first so they keep the memory's alignment
+        hash_table.array.hash    = (hash128_t*)(memory.addr);
+        hash_table.array.value   =      (byte*)(memory.addr + size_hash);
+        hash_table.array.control =        (u8*)(memory.addr + size_hash + size_value);
+        hash_table.allocator     = NULL;
+        hash_table.arena         = NULL;
+        hash_table.old           = {};
 
-        hash_table.count       = 0;
-        hash_table.array.hash  = (hash_t*)(memory.start);
-        hash_table.array.value =   (byte*)(memory.start + size_hash);
+        const bool did_reset = hash_table_reset(hash_table);
+        return(did_reset);
     }
-    
-    SLD_INTERNAL bool
+
+    SLD_API bool
     hash_table_reset(
         hash_table_t& hash_table) {
 
         const bool is_valid = hash_table_validate(hash_table);
-        
+
         if (is_valid) {
-            hash_table.count = 0;
+            if (hash_table_is_resizing(hash_table)) {
+                hash_table_old_release(hash_table);
+            }
+            hash_table.count           = 0;
+            hash_table.tombstone_count = 0;
+            hash_table.error.val       = hash_table_error_e_success;
+            (void)memset(
+                hash_table.array.control,
+                HASH_TABLE_CONTROL_EMPTY,
+                hash_table.capacity + HASH_TABLE_GROUP_WIDTH);
         }
 
         return(is_valid);
     }
-    
-    SLD_INTERNAL bool
-    hash_table_remove(
+
+    SLD_API hash128_t
+    hash_table_hash_key(
+        const hash_table_key_t& key) {
+
+        const hash128_seed_t& seed = *(const hash128_seed_t*)MeowDefaultSeed;
+        const hash128_t       hash = hash_data(seed, key.data, (u32)key.length);
+        return(hash);
+    }
+
+    SLD_API bool
+    hash_table_insert_hash(
+        hash_table_t&       hash_table,
+        const byte*         value,
+        const hash128_t&    hash,
+        hash_table_value_t& result) {
+
+        const bool valid_table = hash_table_validate(hash_table);
+        if (!valid_table) { hash_table.error.val = hash_table_error_e_invalid_table; return(false); }
+
+        (void)hash_table_resize_step(hash_table, HASH_TABLE_MIGRATE_STEP);
+
+        // an existing key just gets its value replaced. if it is still
+        // waiting in the old table, move it now so it only lives in one
+        u32 index = hash_table_find_index(hash_table, hash);
+        if (index == HASH_TABLE_INDEX_INVALID && hash_table_is_resizing(hash_table)) {
+            const u32 old_index = hash_table_find_index(hash_table_old_view(hash_table), hash);
+            if (old_index != HASH_TABLE_INDEX_INVALID) {
+                index = hash_table_migrate_slot(hash_table, old_index);
+            }
+        }
+
+        if (index == HASH_TABLE_INDEX_INVALID) {
+
+            // tombstones count against the load so probes always end on
+            // an empty slot. a table with an allocator starts migrating to
+            // a new table, otherwise clear them in place before giving up
+            u32 max_load = hash_table_max_load(hash_table.capacity);
+            if ((hash_table.count + hash_table.tombstone_count) >= max_load) {
+                const bool did_resize = hash_table_resize_begin(hash_table);
+                if (did_resize) {
+                    max_load = hash_table_max_load(hash_table.capacity);
+                }
+                else if (hash_table.tombstone_count != 0) {
+                    hash_table_drop_tombstones(hash_table);
+                }
+            }
+
+            const bool valid_count = ((hash_table.count + hash_table.tombstone_count) < max_load);
+            if (!valid_count) { hash_table.error.val = hash_table_error_e_max_count; return(false); }
+
+            index = hash_table_find_first_non_full(hash_table, hash);
+            if (hash_table.array.control[index] == HASH_TABLE_CONTROL_DELETED) {
+                --hash_table.tombstone_count;
+            }
+
+            hash_table_set_control(hash_table, index, hash_table_h2(hash));
+            hash_table.array.hash[index] = hash;
+            ++hash_table.count;
+        }
+
+        byte* slot_value = hash_table_value_at(hash_table, index);
+        if (value != NULL) (void)memcpy(slot_value, value, hash_table.stride);
+        else               (void)memset(slot_value, 0,     hash_table.stride);
+
+        result.data          = slot_value;
+        result.index         = index;
+        hash_table.error.val = hash_table_error_e_success;
+        return(true);
+    }
+
+    SLD_API bool
+    hash_table_insert(
         hash_table_t&           hash_table,
+        const byte*             value,
         const hash_table_key_t& key) {
 
+        const bool valid_key = hash_table_validate_key(key);
+        if (!valid_key) { hash_table.error.val = hash_table_error_e_invalid_key; return(false); }
+
+        hash_table_value_t result;
+        const hash128_t    hash      = hash_table_hash_key    (key);
+        const bool         did_insert = hash_table_insert_hash (hash_table, value, hash, result);
+        return(did_insert);
     }
-    
-    SLD_INTERNAL bool
+
+    SLD_API bool
     hash_table_remove_at(
         hash_table_t& hash_table,
         const u32     index) {
 
+        const bool valid_table = hash_table_validate(hash_table);
+        const bool valid_index = valid_table && (index < hash_table.capacity) && hash_table_is_full(hash_table.array.control[index]);
+        if (!valid_table) { hash_table.error.val = hash_table_error_e_invalid_table;       return(false); }
+        if (!valid_index) { hash_table.error.val = hash_table_error_e_index_out_of_bounds; return(false); }
+
+        const bool never_full = hash_table_was_never_full(hash_table, index);
+        hash_table_set_control(hash_table, index, never_full
+            ? HASH_TABLE_CONTROL_EMPTY
+            : HASH_TABLE_CONTROL_DELETED);
+
+        if (!never_full) ++hash_table.tombstone_count;
+        --hash_table.count;
+        hash_table.error.val = hash_table_error_e_success;
+        return(true);
     }
-    
-    SLD_INTERNAL byte*
-    hash_table_insert(
-        hash_table_t&     hash_table,
-        hash_table_key_t& key) {
-
-        byte*      value       = NULL;
-        const u32  index       = hash_table.count; 
-        const bool valid_table = hash_table_validate     (hash_table);
-        const bool valid_key   = hash_table_validate_key (hash_table, key);
-        const bool valid_count = (hash_table.count < hash_table.capacity); 
-        const bool valid_hash  = hash_data(key.data, key.length, hash_table.array.hash[index]);
-        
-        if (!valid_table) { hash_table.error.val = hash_table_error_e_invalid_table; return(value); }
-        if (!valid_key)   { hash_table.error.val = hash_table_error_e_invalid_key;   return(value); }
-        if (!valid_count) { hash_table.error.val = hash_table_error_e_max_count;     return(value); }
-        if (!valid_hash)  { hash_table.error.val = hash_table_error_e_hash_failed;   return(value); }
 
-        ++hash_table.count;
-        const u32 offset =  hash_table.stride * index;
-        value            = &hash_table.array.value[offset];
-        return(value);
+    SLD_API bool
+    hash_table_remove(
+        hash_table_t&           hash_table,
+        const hash_table_key_t& key) {
+
+        bool is_valid = true;
+        is_valid &= hash_table_validate     (hash_table);
+        is_valid &= hash_table_validate_key (key);
+        if (!is_valid) { hash_table.error.val = hash_table_error_e_invalid_key; return(false); }
+
+        (void)hash_table_resize_step(hash_table, HASH_TABLE_MIGRATE_STEP);
+
+        const hash128_t hash  = hash_table_hash_key   (key);
+        const u32       index = hash_table_find_index (hash_table, hash);
+        if (index != HASH_TABLE_INDEX_INVALID) {
+            const bool did_remove = hash_table_remove_at(hash_table, index);
+            return(did_remove);
+        }
+
+        if (!hash_table_is_resizing(hash_table)) return(false);
+
+        const u32 old_index = hash_table_find_index(hash_table_old_view(hash_table), hash);
+        if (old_index == HASH_TABLE_INDEX_INVALID) return(false);
+
+        hash_table_old_remove_at(hash_table, old_index);
+        hash_table.error.val = hash_table_error_e_success;
+        return(true);
     }
-    
-    SLD_INTERNAL byte*
-    hash_table_insert_at(
-        hash_table_t&     hash_table,
-        hash_table_key_t& key,
-        const u32         index) {
-
-        byte*      value       = NULL;
-        const bool valid_table = hash_table_validate     (hash_table);
-        const bool valid_key   = hash_table_validate_key (hash_table, key);
-        const bool valid_count = (hash_table.count < hash_table.capacity); 
-        const bool valid_hash  = hash_data(key.data, key.length, hash_table.array.hash[index]);
-        const bool valid_index = (index <= hash_table.count);
-
-        if (!valid_table) { hash_table.error.val = hash_table_error_e_invalid_table;       return(value); }
-        if (!valid_key)   { hash_table.error.val = hash_table_error_e_invalid_key;         return(value); }
-        if (!valid_count) { hash_table.error.val = hash_table_error_e_max_count;           return(value); }
-        if (!valid_hash)  { hash_table.error.val = hash_table_error_e_hash_failed;         return(value); }
-        if (!valid_index) { hash_table.error.val = hash_table_error_e_index_out_of_bounds; return(value); }
 
-        ++hash_table.count;
-        
-        const u32 offset_src =  hash_table.stride * index;
-        const u32 offset_dst =  hash_table.stride + offset_src;
-        const u32 copy_size  =  hash_table.count  - index;  
-        const byte*      src = &hash_table.array.value[offset_src];
-        byte*            dst = &hash_table.array.value[offset_dst];
+    SLD_API bool
+    hash_table_search_hash(
+        const hash_table_t& hash_table,
+        const hash128_t&    hash,
+        hash_table_value_t& value) {
 
-        (void)memory_copy(dst, src, copy_size);
+        const bool is_valid = hash_table_validate(hash_table);
+        if (!is_valid) return(is_valid);
 
-        return(src);
+        const bool is_found = hash_table_find(hash_table, hash, value);
+        return(is_found);
     }
-    
-    SLD_INTERNAL bool
+
+    SLD_API bool
     hash_table_search(
         const hash_table_t&     hash_table,
         const hash_table_key_t& key,
-        u32&                    index) {
+        hash_table_value_t&     value) {
 
-        bool is_valid = true; 
+        bool is_valid = true;
         is_valid &= hash_table_validate     (hash_table);
-        is_valid &= hash_table_validate_key (hash_table, key);
+        is_valid &= hash_table_validate_key (key);
         if (!is_valid) return(is_valid);
 
-        const hash_t key_hash = hash_data(key.data, key.length);
-        const bool is_found   = hash_search(
-            hash_table.count,      // number of values
-            key_hash,              // hashed key
-            hash_table.array.hash, // stored hashes
-            value.index);          // result index
-
+        const hash128_t hash     = hash_table_hash_key    (key);
+        const bool      is_found = hash_table_search_hash (hash_table, hash, value);
         return(is_found);
     }
-    
-    SLD_INTERNAL bool
+
+    SLD_API bool
     hash_table_get_hash_at(
         const hash_table_t& hash_table,
         const u32           index,
-        hash_t&             hash) {
+        hash128_t&          hash) {
 
-        bool is_valid = true; 
+        bool is_valid = true;
         is_valid &= hash_table_validate(hash_table);
-        is_valid &= (index < hash_table.count); 
-        
+        is_valid &= (index < hash_table.capacity);
+        is_valid  = is_valid && hash_table_is_full(hash_table.array.control[index]);
+
         if (is_valid) {
             hash = hash_table.array.hash[index];
         }
 
         return(is_valid);
     }
-    
-    SLD_INTERNAL bool
+
+    SLD_API bool
     hash_table_get_value_at(
         const hash_table_t& hash_table,
+        const u32           index,
         hash_table_value_t& value) {
 
-        bool is_valid = true; 
+        bool is_valid = true;
         is_valid &= hash_table_validate(hash_table);
-        is_valid &= (value.index < hash_table.count); 
-        
-        if (is_valid) {
+        is_valid &= (index < hash_table.capacity);
+        is_valid  = is_valid && hash_table_is_full(hash_table.array.control[index]);
 
-            const u32 offset =  hash_table.stride * value.index; 
-            value.data       = &hash_table.array.value[offset];
+        if (is_valid) {
+            value.index = index;
+            value.data  = hash_table_value_at(hash_table, index);
         }
 
         return(is_valid);
     }
+
+    SLD_API u32
+    hash_table_search_batch_hash(
+        const hash_table_t& hash_table,
+        const u32           count,
+        const hash128_t*    hashes,
+        hash_table_value_t* values) {
+
+        bool can_search = true;
+        can_search &= hash_table_validate(hash_table);
+        can_search &= (hashes != NULL);
+        can_search &= (values != NULL);
+        if (!can_search) return(0);
+
+        // every load is issued before the first probe, so the misses
+        // overlap instead of stalling one lookup after another
+        for (
+            u32 index = 0;
+                index < count;
+              ++index) {
+
+            hash_table_prefetch(hash_table, hashes[index]);
+        }
+
+        u32 found_count = 0;
+        for (
+            u32 index = 0;
+                index < count;
+              ++index) {
+
+            if (hash_table_find(hash_table, hashes[index], values[index])) {
+                ++found_count;
+            }
+            else {
+                values[index].index = HASH_TABLE_INDEX_INVALID;
+                values[index].data  = NULL;
+            }
+        }
+
+        return(found_count);
+    }
+
+    SLD_API u32
+    hash_table_search_batch(
+        const hash_table_t& hash_table,
+        const u32           count,
+        const byte*         keys,
+        const u32           key_stride,
+        hash_table_value_t* values) {
+
+        bool can_search = true;
+        can_search &= (keys       != NULL);
+        can_search &= (key_stride != 0);
+        if (!can_search) return(0);
+
+        // hash a chunk at a time so the hashes stay on the stack
+        const hash128_seed_t& seed = *(const hash128_seed_t*)MeowDefaultSeed;
+        hash128_t             hashes[HASH_TABLE_BATCH_SIZE];
+        u32                   found_count = 0;
+
+        for (
+            u32 batch_start = 0;
+                batch_start < count;
+                batch_start += HASH_TABLE_BATCH_SIZE) {
+
+            const u32 batch_count = ((count - batch_start) < HASH_TABLE_BATCH_SIZE)
+                ? (count - batch_start)
+                : HASH_TABLE_BATCH_SIZE;
+
+            (void)hash_data_batch(seed, batch_count, &keys[(u64)batch_start * key_stride], key_stride, hashes);
+            found_count += hash_table_search_batch_hash(hash_table, batch_count, hashes, &values[batch_start]);
+        }
+
+        return(found_count);
+    }
+
+    SLD_API u32
+    hash_table_insert_batch_hash(
+        hash_table_t&       hash_table,
+        const u32           count,
+        const hash128_t*    hashes,
+        const byte*         values,
+        hash_table_value_t* results) {
+
+        bool can_insert = true;
+        can_insert &= hash_table_validate(hash_table);
+        can_insert &= (hashes  != NULL);
+        can_insert &= (results != NULL);
+        if (!can_insert) return(0);
+
+        for (
+            u32 index = 0;
+                index < count;
+              ++index) {
+
+            hash_table_prefetch(hash_table, hashes[index]);
+        }
+
+        // values are packed at the table stride, NULL inserts zeroed values
+        u32 insert_count = 0;
+        for (
+            u32 index = 0;
+                index < count;
+              ++index) {
+
+            const byte* value      = (values != NULL) ? &values[(u64)index * hash_table.stride] : NULL;
+            const bool  did_insert = hash_table_insert_hash(hash_table, value, hashes[index], results[index]);
+            if (did_insert) {
+                ++insert_count;
+            }
+            else {
+                results[index].index = HASH_TABLE_INDEX_INVALID;
+                results[index].data  = NULL;
+            }
+        }
+
+        return(insert_count);
+    }
+
+    SLD_API u32
+    hash_table_insert_batch(
+        hash_table_t&       hash_table,
+        const u32           count,
+        const byte*         keys,
+        const u32           key_stride,
+        const byte*         values,
+        hash_table_value_t* results) {
+
+        bool can_insert = true;
+        can_insert &= (keys       != NULL);
+        can_insert &= (key_stride != 0);
+        if (!can_insert) return(0);
+
+        const hash128_seed_t& seed = *(const hash128_seed_t*)MeowDefaultSeed;
+        hash128_t             hashes[HASH_TABLE_BATCH_SIZE];
+        u32                   insert_count = 0;
+
+        for (
+            u32 batch_start = 0;
+                batch_start < count;
+                batch_start += HASH_TABLE_BATCH_SIZE) {
+
+            const u32 batch_count = ((count - batch_start) < HASH_TABLE_BATCH_SIZE)
+                ? (count - batch_start)
+                : HASH_TABLE_BATCH_SIZE;
+
+            const byte* batch_values = (values != NULL) ? &values[(u64)batch_start * hash_table.stride] : NULL;
+            (void)hash_data_batch(seed, batch_count, &keys[(u64)batch_start * key_stride], key_stride, hashes);
+            insert_count += hash_table_insert_batch_hash(hash_table, batch_count, hashes, batch_values, &results[batch_start]);
+        }
+
+        return(insert_count);
+    }
+
+    SLD_API bool
+    hash_table_allocator_init(
+        hash_table_t&      hash_table,
+        arena_allocator_t* allocator) {
+
+        bool can_init = true;
+        can_init &= arena_allocator_is_valid(allocator);
+        can_init &= (hash_table.capacity >= HASH_TABLE_CAPACITY_MIN);
+        can_init &= size_is_pow_2(hash_table.capacity);
+        can_init &= (hash_table.stride   != 0);
+        if (!can_init) {
+            hash_table.error.val = hash_table_error_e_invalid_table;
+            return(false);
+        }
+
+        arena_t* arena = arena_allocator_commit(allocator);
+        if (arena == NULL) {
+            hash_table.error.val = hash_table_error_e_not_enough_memory;
+            return(false);
+        }
+
+        memory_t memory;
+        memory.size = hash_table_memory_size(hash_table);
+        memory.ptr  = arena_push_bytes(arena, memory.size, alignof(hash128_t));
+
+        const bool did_init = (memory.ptr != NULL) && hash_table_memory_init(hash_table, memory);
+        if (!did_init) {
+            arena_allocator_decommit(allocator, arena);
+            hash_table.error.val = hash_table_error_e_not_enough_memory;
+            return(false);
+        }
+
+        hash_table.allocator = allocator;
+        hash_table.arena     = arena;
+        return(true);
+    }
+
+    SLD_API bool
+    hash_table_allocator_reserve(
+        hash_table_t&      hash_table,
+        arena_allocator_t* allocator,
+        const u32          count_max) {
+
+        // the capacity and stride in the table are where it starts. an
+        // arena has to hold the largest table it can grow to for count_max
+        // entries, and the allocator needs room for that table and the one
+        // it drains. the allocator sizes are u32, so the sums are checked
+        // in u64 before anything is reserved
+        hash_table_t table_max = {};
+        table_max.capacity     = (u32)size_round_up_pow2((u64)count_max * 2);
+        table_max.stride       = hash_table.stride;
+
+        bool can_reserve = true;
+        can_reserve &= (allocator != NULL);
+        can_reserve &= (count_max != 0);
+        can_reserve &= (count_max <= (HASH_TABLE_INDEX_INVALID / 2));
+        can_reserve &= (table_max.capacity >= hash_table.capacity);
+        if (!can_reserve) {
+            hash_table.error.val = hash_table_error_e_invalid_table;
+            return(false);
+        }
+
+        const u64 size_arena = (hash_table_memory_size(table_max) + ARENA_HEADER_SIZE);
+        const u64 size_total = (size_arena * 3);
+        if (size_total > 0xFFFFFFFF) {
+            hash_table.error.val = hash_table_error_e_not_enough_memory;
+            return(false);
+        }
+        const bool did_reserve = arena_allocator_reserve_os_memory(allocator, (u32)size_total, (u32)size_arena);
+        if (!did_reserve) {
+            hash_table.error.val = hash_table_error_e_not_enough_memory;
+            return(false);
+        }
+
+        const bool did_init = hash_table_allocator_init(hash_table, allocator);
+        if (!did_init) arena_allocator_release_os_memory(allocator);
+        return(did_init);
+    }
+
+    SLD_API void
+    hash_table_allocator_release(
+        hash_table_t& hash_table) {
+
+        if (hash_table.allocator == NULL) return;
+
+        hash_table_old_release(hash_table);
+        if (hash_table.arena != NULL) {
+            arena_allocator_decommit(hash_table.allocator, hash_table.arena);
+        }
+
+        hash_table.count           = 0;
+        hash_table.tombstone_count = 0;
+        hash_table.array.control   = NULL;
+        hash_table.array.hash      = NULL;
+        hash_table.array.value     = NULL;
+        hash_table.allocator       = NULL;
+        hash_table.arena           = NULL;
+    }
+
+    SLD_API bool
+    hash_table_is_resizing(
+        const hash_table_t& hash_table) {
+
+        const bool is_resizing = (hash_table.old.control != NULL);
+        return(is_resizing);
+    }
+
+    SLD_API bool
+    hash_table_resize_step(
+        hash_table_t& hash_table,
+        const u32     slot_count) {
+
+        if (!hash_table_is_resizing(hash_table)) return(false);
+
+        const u32 position_end = ((hash_table.old.capacity - hash_table.old.position) < slot_count)
+            ? hash_table.old.capacity
+            : (hash_table.old.position + slot_count);
+
+        for (
+            u32 old_index = hash_table.old.position;
+                old_index < position_end && hash_table.old.count != 0;
+              ++old_index) {
+
+            if (hash_table_is_full(hash_table.old.control[old_index])) {
+                (void)hash_table_migrate_slot(hash_table, old_index);
+            }
+        }
+        hash_table.old.position = position_end;
+
+        // drained, hand the old arena back
+        const bool is_done = (hash_table.old.count == 0 || hash_table.old.position == hash_table.old.capacity);
+        if (is_done) hash_table_old_release(hash_table);
+        return(!is_done);
+    }
+
+    SLD_API void
+    hash_table_resize_finish(
+        hash_table_t& hash_table) {
+
+        while (hash_table_resize_step(hash_table, hash_table.old.capacity));
+    }
+
+    SLD_API u32
+    hash_table_get_count(
+        const hash_table_t& hash_table) {
+
+        // entries still waiting in the old table count too
+        const u32 count = (hash_table.count + hash_table.old.count);
+        return(count);
+    }
+
+    SLD_API u64
+    hash_table_snapshot_size(
+        const hash_table_t& hash_table) {
+
+        hash_table_snapshot_header_t header;
+        hash_table_snapshot_layout(hash_table, header);
+        return(header.size);
+    }
+
+    SLD_API bool
+    hash_table_snapshot_write(
+        const hash_table_t& hash_table,
+        const memory_t&     memory) {
+
+        hash_table_snapshot_header_t header;
+        hash_table_snapshot_layout(hash_table, header);
+
+        // entries waiting in an old table aren't in the arrays we write
+        bool can_write = true;
+        can_write &= hash_table_validate(hash_table);
+        can_write &= !hash_table_is_resizing(hash_table);
+        can_write &= (memory.ptr  != NULL);
+        can_write &= (memory.size >= header.size);
+        if (!can_write) return(false);
+
+        // zero the padding so the same table always writes the same bytes
+        (void)memset(memory.ptr, 0, header.offset_hash);
+        (void)memcpy(memory.ptr, &header, sizeof(header));
+        (void)memcpy((void*)(memory.addr + header.offset_hash),    hash_table.array.hash,    header.offset_value   - header.offset_hash);
+        (void)memcpy((void*)(memory.addr + header.offset_value),   hash_table.array.value,   header.offset_control - header.offset_value);
+        (void)memcpy((void*)(memory.addr + header.offset_control), hash_table.array.control, header.size           - header.offset_control);
+        return(true);
+    }
+
+    SLD_API bool
+    hash_table_snapshot_load(
+        hash_table_t& hash_table,
+        const byte*   data,
+        const u64     size) {
+
+        bool is_valid = true;
+        is_valid &= (data != NULL);
+        is_valid &= (size >= sizeof(hash_table_snapshot_header_t));
+        is_valid &= (((addr)data & (alignof(hash128_t) - 1)) == 0);
+        if (!is_valid) { hash_table.error.val = hash_table_error_e_invalid_snapshot; return(false); }
+
+        // the header has to describe exactly the layout we would write
+        const hash_table_snapshot_header_t* header = (const hash_table_snapshot_header_t*)data;
+        hash_table_t sized = {};
+        sized.capacity        = header->capacity;
+        sized.stride          = header->stride;
+        sized.count           = header->count;
+        sized.tombstone_count = header->tombstone_count;
+
+        hash_table_snapshot_header_t expected;
+        hash_table_snapshot_layout(sized, expected);
+
+        is_valid &= (header->magic          == HASH_TABLE_SNAPSHOT_MAGIC);
+        is_valid &= (header->version        == HASH_TABLE_SNAPSHOT_VERSION);
+        is_valid &= (header->capacity       >= HASH_TABLE_CAPACITY_MIN);
+        is_valid &= size_is_pow_2(header->capacity);
+        is_valid &= (header->stride         != 0);
+        is_valid &= (header->count          <= hash_table_max_load(header->capacity));
+        is_valid &= (header->offset_hash    == expected.offset_hash);
+        is_valid &= (header->offset_value   == expected.offset_value);
+        is_valid &= (header->offset_control == expected.offset_control);
+        is_valid &= (header->size           == expected.size);
+        is_valid &= (size                   >= header->size);
+        if (!is_valid) { hash_table.error.val = hash_table_error_e_invalid_snapshot; return(false); }
+
+        // point straight into the image. a mapped image is read only, so
+        // the table is too
+        hash_table.capacity        = header->capacity;
+        hash_table.stride          = header->stride;
+        hash_table.count           = header->count;
+        hash_table.tombstone_count = header->tombstone_count;
+        hash_table.array.hash      = (hash128_t*)&data[header->offset_hash];
+        hash_table.array.value     =      (byte*)&data[header->offset_value];
+        hash_table.array.control   =        (u8*)&data[header->offset_control];
+        hash_table.allocator       = NULL;
+        hash_table.arena           = NULL;
+        hash_table.old             = {};
+        hash_table.error.val       = hash_table_error_e_success;
+        return(true);
+    }
+
+    SLD_API bool
+    hash_table_snapshot_map_file(
+        hash_table_t&  hash_table,
+        const c8*      path,
+        os_file_map_t& map) {
+
+        // nothing is read here, the pages fault in as probes touch them
+        const os_file_error_t error = os_file_map_read(path, map);
+        if (error.val != os_file_error_e_success) {
+            hash_table.error.val = hash_table_error_e_invalid_snapshot;
+            return(false);
+        }
+
+        const bool did_load = hash_table_snapshot_load(hash_table, map.data, map.size);
+        if (!did_load) (void)os_file_unmap(map);
+        return(did_load);
+    }
 };
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "sld-hash.hpp"
+#include "sld-os.hpp"
+
+#ifndef    SLD_HASH_THREAD_MAX
+#   define SLD_HASH_THREAD_MAX       16
+#endif
+#ifndef    SLD_HASH_THREAD_MIN_SIZE
+#   define SLD_HASH_THREAD_MIN_SIZE  size_megabytes(1)
+#endif
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // DECLARATIONS
+    //-------------------------------------------------------------------
+
+    // a run of records for one thread of a threaded batch. the records are
+    // [start, start + count) of the whole batch, so every job shares the
+    // same data and hashes pointers
+    struct hash_batch_job_t {
+        os_thread_context_t   context;
+        os_thread_handle_t    thread;
+        const hash128_seed_t* seed_128;
+        hash32_seed_t         seed_32;
+        const byte*           data;
+        u32                   stride;
+        u32                   start;
+        u32                   count;
+        hash128_t*            hashes_128;
+        hash32_t*             hashes_32;
+    };
+
+    constexpr u32 HASH128_BATCH_LANE_COUNT      = 4;
+    constexpr u32 HASH128_BATCH_LANE_STRIDE_MAX = 256;
+
+    SLD_INTERNAL u32  hash_batch_job_split (const u32 count, const u32 stride, const u32 thread_count, hash_batch_job_t* jobs);
+    SLD_INTERNAL void hash_batch_job_run   (hash_batch_job_t* jobs, const u32 job_count, const os_thread_callback_function_f function);
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_INTERNAL u32
+    hash_batch_job_split(
+        const u32         count,
+        const u32         stride,
+        const u32         thread_count,
+        hash_batch_job_t* jobs) {
+
+        // a thread is only worth starting for a decent amount of data
+        const u64 size         = (u64)count * stride;
+        const u64 size_jobs    = (size / SLD_HASH_THREAD_MIN_SIZE);
+        u32       job_count    = (thread_count < SLD_HASH_THREAD_MAX) ? thread_count : SLD_HASH_THREAD_MAX;
+        if (job_count > size_jobs) job_count = (u32)size_jobs;
+        if (job_count > count)     job_count = count;
+        if (job_count == 0)        job_count = 1;
+
+        const u32 count_per_job = (count / job_count);
+        const u32 count_extra   = (count % job_count);
+
+        u32 start = 0;
+        for (
+            u32 job = 0;
+                job < job_count;
+              ++job) {
+
+            jobs[job]       = {};
+            jobs[job].start = start;
+            jobs[job].count = count_per_job + ((job < count_extra) ? 1 : 0);
+            start          += jobs[job].count;
+        }
+        return(job_count);
+    }
+
+    SLD_INTERNAL void
+    hash_batch_job_run(
+        hash_batch_job_t*                   jobs,
+        const u32                           job_count,
+        const os_thread_callback_function_f function) {
+
+        // the first job runs here, and so does any job whose thread
+        // couldn't be started
+        bool did_start[SLD_HASH_THREAD_MAX] = {};
+        for (
+            u32 job = 0;
+                job < job_count;
+              ++job) {
+
+            jobs[job].context.function  = function;
+            jobs[job].context.data.ptr  = (void*)&jobs[job];
+            jobs[job].context.data.size = sizeof(hash_batch_job_t);
+            if (job == 0) continue;
+
+            const os_thread_error_t error = os_thread_create(jobs[job].thread, jobs[job].context);
+            did_start[job] = (error.val == os_thread_error_e_success);
+        }
+
+        for (
+            u32 job = 0;
+                job < job_count;
+              ++job) {
+
+            if (!did_start[job]) function(jobs[job].context);
+        }
+
+        for (
+            u32 job = 1;
+                job < job_count;
+              ++job) {
+
+            if (did_start[job]) (void)os_thread_join(jobs[job].thread);
+        }
+    }
+};
\ No newline at end of file
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <atomic>
+#include "sld-hash.hpp"
+#include "sld-os.hpp"
+#include "sld-hash-batch.cpp"
+
+#ifndef    SLD_HASH_FILE_WINDOW_SIZE
+#   define SLD_HASH_FILE_WINDOW_SIZE  size_megabytes(4)
+#endif
+#ifndef    SLD_HASH_FILE_WINDOW_AHEAD
+#   define SLD_HASH_FILE_WINDOW_AHEAD 2
+#endif
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // DECLARATIONS
+    //-------------------------------------------------------------------
+
+    // the files of one batch and the next one nobody has taken yet. a
+    // worker takes one file at a time, so a few big files don't leave
+    // the other threads idle
+    struct hash_file_queue_t {
+        const hash128_seed_t* seed;
+        hash128_file_t*       files;
+        u32                   count;
+        std::atomic<u32>      next;
+        std::atomic<u32>      hashed_count;
+    };
+
+    struct hash_file_worker_t {
+        os_thread_context_t context;
+        os_thread_handle_t  thread;
+        hash_file_queue_t*  queue;
+    };
+
+    SLD_INTERNAL void hash_file_worker (os_thread_context_t& context);
+
+    //-------------------------------------------------------------------
+    // API
+    //-------------------------------------------------------------------
+
+    SLD_API bool
+    hash128_file(
+        const hash128_seed_t& seed,
+        hash128_file_t&       file) {
+
+        file.hash = {};
+        file.size = 0;
+
+        os_file_map_t map;
+        file.error = os_file_map_read(file.path, map);
+        if (file.error.val != os_file_error_e_success) return(false);
+
+        // the mapping is read a window at a time while the os reads the
+        // next few in behind it, so the disk and the hash both stay busy
+        constexpr u64 window_size  = SLD_HASH_FILE_WINDOW_SIZE;
+        constexpr u64 window_ahead = (SLD_HASH_FILE_WINDOW_SIZE * SLD_HASH_FILE_WINDOW_AHEAD);
+        (void)os_file_map_prefetch(map, 0, window_ahead);
+
+        hash128_state_t state;
+        hash128_block_begin(state, seed);
+
+        for (
+            u64 offset = 0;
+                offset < map.size;
+                offset += window_size) {
+
+            const u64 size = ((map.size - offset) < window_size) ? (map.size - offset) : window_size;
+            (void)os_file_map_prefetch(map, offset + window_ahead, window_size);
+            hash128_block_consume(state, size, &map.data[offset]);
+        }
+
+        file.hash  = hash128_block_end(state);
+        file.size  = map.size;
+        file.error = os_file_unmap(map);
+        return(true);
+    }
+
+    SLD_API u32
+    hash128_file_batch(
+        const hash128_seed_t& seed,
+        const u32             count,
+        hash128_file_t*       files,
+        const u32             thread_count) {
+
+        bool can_hash = true;
+        can_hash &= (count        != 0);
+        can_hash &= (files        != NULL);
+        can_hash &= (thread_count != 0);
+        if (!can_hash) return(0);
+
+        hash_file_queue_t queue;
+        queue.seed  = &seed;
+        queue.files = files;
+        queue.count = count;
+        queue.next.store         (0, std::memory_order_relaxed);
+        queue.hashed_count.store (0, std::memory_order_relaxed);
+
+        u32 worker_count = (thread_count < SLD_HASH_THREAD_MAX) ? thread_count : SLD_HASH_THREAD_MAX;
+        if (worker_count > count) worker_count = count;
+
+        // this thread is the first worker, the others start before it
+        // begins and it joins them when the queue is empty
+        hash_file_worker_t workers   [SLD_HASH_THREAD_MAX];
+        bool               did_start [SLD_HASH_THREAD_MAX] = {};
+        for (
+            u32 worker = 0;
+                worker < worker_count;
+              ++worker) {
+
+            workers[worker].queue             = &queue;
+            workers[worker].context.function  = hash_file_worker;
+            workers[worker].context.data.ptr  = (void*)&workers[worker];
+            workers[worker].context.data.size = sizeof(hash_file_worker_t);
+            if (worker == 0) continue;
+
+            const os_thread_error_t error = os_thread_create(workers[worker].thread, workers[worker].context);
+            did_start[worker] = (error.val == os_thread_error_e_success);
+        }
+
+        hash_file_worker(workers[0].context);
+
+        for (
+            u32 worker = 1;
+                worker < worker_count;
+              ++worker) {
+
+            if (did_start[worker]) (void)os_thread_join(workers[worker].thread);
+        }
+
+        const u32 hashed_count = queue.hashed_count.load(std::memory_order_acquire);
+        return(hashed_count);
+    }
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_INTERNAL void
+    hash_file_worker(
+        os_thread_context_t& context) {
+
+        const hash_file_worker_t* worker = (const hash_file_worker_t*)context.data.ptr;
+        hash_file_queue_t*        queue  = worker->queue;
+
+        for (;;) {
+
+            const u32 index = queue->next.fetch_add(1, std::memory_order_relaxed);
+            if (index >= queue->count) break;
+
+            const bool did_hash = hash128_file(*queue->seed, queue->files[index]);
+            if (did_hash) queue->hashed_count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+};
\ No newline at end of file
@@ -0,0 +1,284 @@
+#pragma once
+
+#include <meow-hash/meow_hash_x64_aesni.h>
+#include "sld-hash.hpp"
+
+#ifndef    SLD_HASH_SHORT_LENGTH_MAX
+#   define SLD_HASH_SHORT_LENGTH_MAX 144
+#endif
+
+// hash_data is the first step of every table lookup. the short hash is
+// inlined into it, meow sets up a frame every short key would pay for,
+// so it stays out of line behind the length check
+# if defined(_MSC_VER) && !defined(__clang__)
+#    define SLD_HASH_SHORT_INLINE static __forceinline
+#    define SLD_HASH_SHORT_COLD   static __declspec(noinline)
+# else
+#    define SLD_HASH_SHORT_INLINE static inline __attribute__((always_inline))
+#    define SLD_HASH_SHORT_COLD   static __attribute__((noinline, cold))
+# endif
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // DECLARATIONS
+    //-------------------------------------------------------------------
+
+    // short keys, in the style of wyhash. every step is a 64x64->128 bit
+    // multiply whose halves are xored back together, so a key of a few
+    // words is only a few multiplies with no setup. up to 16 bytes the
+    // key is read as two overlapping words, longer keys are folded in 16
+    // byte steps, and the 64 bit hash takes 48 at a time on three chains
+    // once the key is long enough. the 128 bit hash keeps two chains with
+    // different secrets all the way through, so its halves are independent.
+    // meow wins once the key is long enough to fill its lanes, hash_data
+    // switches over at SLD_HASH_SHORT_LENGTH_MAX
+
+    constexpr u64 HASH_SHORT_SECRET[4] = {
+        0x2D358DCCAA6C78A5, 0x8BB84B93962EACC9, 0x4B33A62ED433D4A3, 0x4D5A2DA51DE1AA47
+    };
+
+    SLD_HASH_SHORT_INLINE const hash128_t hash_short_128      (const hash128_seed_t& seed, const byte* data, const u32 length);
+    SLD_HASH_SHORT_COLD   const hash128_t hash_short_long     (const hash128_seed_t& seed, const byte* data, const u32 length);
+    SLD_INTERNAL_INLINE   void            hash_short_multiply (u64& a, u64& b);
+    SLD_INTERNAL_INLINE   u64             hash_short_mix      (u64 a, u64 b);
+    SLD_INTERNAL_INLINE   u64             hash_short_read_8   (const byte* data);
+    SLD_INTERNAL_INLINE   u64             hash_short_read_4   (const byte* data);
+    SLD_INTERNAL_INLINE   void            hash_short_read_16  (const byte* data, const u32 length, u64& a, u64& b);
+
+    //-------------------------------------------------------------------
+    // API
+    //-------------------------------------------------------------------
+
+    SLD_API const hash64_t
+    hash64_short(
+        const hash64_seed_t seed,
+        const byte*         data,
+        const u32           length) {
+
+        u64 state = seed.val ^ hash_short_mix(seed.val ^ HASH_SHORT_SECRET[0], HASH_SHORT_SECRET[1]);
+        u64 a     = 0;
+        u64 b     = 0;
+
+        if (length <= 16) {
+            hash_short_read_16(data, length, a, b);
+        }
+        else {
+            const byte* cursor    = data;
+            u32         remaining = length;
+
+            if (remaining > 48) {
+                u64 state_1 = state;
+                u64 state_2 = state;
+                do {
+                    state   = hash_short_mix(hash_short_read_8(cursor)      ^ HASH_SHORT_SECRET[1], hash_short_read_8(cursor + 8)  ^ state);
+                    state_1 = hash_short_mix(hash_short_read_8(cursor + 16) ^ HASH_SHORT_SECRET[2], hash_short_read_8(cursor + 24) ^ state_1);
+                    state_2 = hash_short_mix(hash_short_read_8(cursor + 32) ^ HASH_SHORT_SECRET[3], hash_short_read_8(cursor + 40) ^ state_2);
+                    cursor    += 48;
+                    remaining -= 48;
+                } while (remaining > 48);
+                state ^= (state_1 ^ state_2);
+            }
+
+            while (remaining > 16) {
+                state      = hash_short_mix(hash_short_read_8(cursor) ^ HASH_SHORT_SECRET[1], hash_short_read_8(cursor + 8) ^ state);
+                cursor    += 16;
+                remaining -= 16;
+            }
+
+            // the last 16 bytes, overlapping what came before
+            a = hash_short_read_8(cursor + remaining - 16);
+            b = hash_short_read_8(cursor + remaining - 8);
+        }
+
+        a ^= HASH_SHORT_SECRET[1];
+        b ^= state;
+        hash_short_multiply(a, b);
+
+        hash64_t hash;
+        hash.as_u64 = hash_short_mix(a ^ HASH_SHORT_SECRET[0] ^ length, b ^ HASH_SHORT_SECRET[1]);
+        return(hash);
+    }
+
+    SLD_API const hash128_t
+    hash128_short(
+        const hash128_seed_t& seed,
+        const byte*           data,
+        const u32             length) {
+
+        const hash128_t hash = hash_short_128(seed, data, length);
+        return(hash);
+    }
+
+    SLD_API const hash128_t
+    hash_data(
+        const hash128_seed_t& seed,
+        const byte*           data,
+        const u32             length) {
+
+        if (length > SLD_HASH_SHORT_LENGTH_MAX) {
+            return(hash_short_long(seed, data, length));
+        }
+
+        const hash128_t hash = hash_short_128(seed, data, length);
+        return(hash);
+    }
+
+    SLD_API bool
+    hash_data_batch(
+        const hash128_seed_t& seed,
+        const u32             count,
+        const byte*           data,
+        const u32             stride,
+        hash128_t*            hashes) {
+
+        bool can_hash = true;
+        can_hash &= (count  != 0);
+        can_hash &= (data   != NULL);
+        can_hash &= (stride != 0);
+        can_hash &= (hashes != NULL);
+        if (!can_hash) return(can_hash);
+
+        if (stride > SLD_HASH_SHORT_LENGTH_MAX) {
+            return(hash128_data_batch(seed, count, data, stride, hashes));
+        }
+
+        for (
+            u32 index = 0;
+                index < count;
+              ++index) {
+
+            const u64 offset = (u64)index * stride;
+            hashes[index]    = hash128_short(seed, &data[offset], stride);
+        }
+        return(can_hash);
+    }
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_HASH_SHORT_INLINE const hash128_t
+    hash_short_128(
+        const hash128_seed_t& seed,
+        const byte*           data,
+        const u32             length) {
+
+        // the two halves of the seed start the two chains
+        u64 seed_low, seed_high;
+        (void)memcpy(&seed_low,  &seed.buffer[0], 8);
+        (void)memcpy(&seed_high, &seed.buffer[8], 8);
+
+        u64 state_low  = seed_low  ^ hash_short_mix(seed_low  ^ HASH_SHORT_SECRET[0], HASH_SHORT_SECRET[1]);
+        u64 state_high = seed_high ^ hash_short_mix(seed_high ^ HASH_SHORT_SECRET[2], HASH_SHORT_SECRET[3]);
+        u64 a          = 0;
+        u64 b          = 0;
+
+        if (length <= 16) {
+            hash_short_read_16(data, length, a, b);
+        }
+        else {
+            const byte* cursor    = data;
+            u32         remaining = length;
+
+            while (remaining > 16) {
+                const u64 word_0 = hash_short_read_8(cursor);
+                const u64 word_1 = hash_short_read_8(cursor + 8);
+                state_low  = hash_short_mix(word_0 ^ HASH_SHORT_SECRET[1], word_1 ^ state_low);
+                state_high = hash_short_mix(word_1 ^ HASH_SHORT_SECRET[3], word_0 ^ state_high);
+                cursor    += 16;
+                remaining -= 16;
+            }
+
+            a = hash_short_read_8(cursor + remaining - 16);
+            b = hash_short_read_8(cursor + remaining - 8);
+        }
+
+        u64 low_a  = a ^ HASH_SHORT_SECRET[1];
+        u64 low_b  = b ^ state_low;
+        u64 high_a = b ^ HASH_SHORT_SECRET[3];
+        u64 high_b = a ^ state_high;
+        hash_short_multiply(low_a,  low_b);
+        hash_short_multiply(high_a, high_b);
+
+        hash128_t hash;
+        hash.val.as_u64[0] = hash_short_mix(low_a  ^ HASH_SHORT_SECRET[0] ^ length, low_b  ^ HASH_SHORT_SECRET[1]);
+        hash.val.as_u64[1] = hash_short_mix(high_a ^ HASH_SHORT_SECRET[2] ^ length, high_b ^ HASH_SHORT_SECRET[3]);
+        return(hash);
+    }
+
+    SLD_HASH_SHORT_COLD const hash128_t
+    hash_short_long(
+        const hash128_seed_t& seed,
+        const byte*           data,
+        const u32             length) {
+
+        const hash128_t hash = hash128_data(seed, data, length);
+        return(hash);
+    }
+
+    SLD_INTERNAL_INLINE void
+    hash_short_multiply(
+        u64& a,
+        u64& b) {
+
+    # if defined(_MSC_VER) && !defined(__clang__)
+        a = _umul128(a, b, &b);
+    # else
+        const __uint128_t product = (__uint128_t)a * b;
+        a = (u64)product;
+        b = (u64)(product >> 64);
+    # endif
+    }
+
+    SLD_INTERNAL_INLINE u64
+    hash_short_mix(
+        u64 a,
+        u64 b) {
+
+        hash_short_multiply(a, b);
+        return(a ^ b);
+    }
+
+    SLD_INTERNAL_INLINE u64
+    hash_short_read_8(
+        const byte* data) {
+
+        u64 value;
+        (void)memcpy(&value, data, 8);
+        return(value);
+    }
+
+    SLD_INTERNAL_INLINE u64
+    hash_short_read_4(
+        const byte* data) {
+
+        u32 value;
+        (void)memcpy(&value, data, 4);
+        return(value);
+    }
+
+    SLD_INTERNAL_INLINE void
+    hash_short_read_16(
+        const byte* data,
+        const u32   length,
+        u64&        a,
+        u64&        b) {
+
+        // two words that between them cover every byte, overlapping when
+        // the key is shorter than 16. under 4 bytes, first, middle and last
+        if (length >= 4) {
+            const u32 offset = ((length >> 3) << 2);
+            a = (hash_short_read_4(data)              << 32) | hash_short_read_4(data + offset);
+            b = (hash_short_read_4(data + length - 4) << 32) | hash_short_read_4(data + length - 4 - offset);
+        }
+        else if (length > 0) {
+            a = ((u64)data[0] << 16) | ((u64)data[length >> 1] << 8) | data[length - 1];
+            b = 0;
+        }
+        else {
+            a = 0;
+            b = 0;
+        }
+    }
+};
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <meow-hash/meow_hash_x64_aesni.h>
 #include "sld-hash.hpp"
 #include "sld-simd.hpp"
+#include "sld-hash-batch.cpp"
 
 namespace sld {
 
@@ -26,6 +27,210 @@ namespace sld {
         return(hash);
     }
 
+    //-------------------------------------------------------------------
+    // BATCH KERNELS
+    //-------------------------------------------------------------------
+
+    // a short record is mostly meow's fixed setup and mix down. records
+    // of one stride all take the same steps, so each 128 bit lane of a
+    // zmm register carries the same meow register for a different record
+    // and one vaes instruction runs a round for four records at once.
+    // this is meow as written, per lane, and matches MeowHash bit for bit
+
+    SLD_INTERNAL_INLINE SLD_SIMD_TARGET("avx512f,avx512bw,vaes") __m512i
+    hash128_lanes_load(
+        const byte* data,
+        const u32   stride) {
+
+        __m512i reg = _mm512_castsi128_si512(_mm_loadu_si128((const __m128i*)data));
+        reg = _mm512_inserti32x4(reg, _mm_loadu_si128((const __m128i*)(data + ((u64)stride * 1))), 1);
+        reg = _mm512_inserti32x4(reg, _mm_loadu_si128((const __m128i*)(data + ((u64)stride * 2))), 2);
+        reg = _mm512_inserti32x4(reg, _mm_loadu_si128((const __m128i*)(data + ((u64)stride * 3))), 3);
+        return(reg);
+    }
+
+    SLD_INTERNAL_INLINE SLD_SIMD_TARGET("avx512f,avx512bw,vaes") void
+    hash128_lanes_mix_reg(
+        __m512i&      r1,
+        __m512i&      r2,
+        __m512i&      r3,
+        __m512i&      r4,
+        __m512i&      r5,
+        const __m512i i1,
+        const __m512i i2,
+        const __m512i i3,
+        const __m512i i4) {
+
+        r1 = _mm512_aesdec_epi128 (r1, r2);
+        r3 = _mm512_add_epi64     (r3, i1);
+        r2 = _mm512_xor_si512     (r2, i2);
+        r2 = _mm512_aesdec_epi128 (r2, r4);
+        r5 = _mm512_add_epi64     (r5, i3);
+        r4 = _mm512_xor_si512     (r4, i4);
+    }
+
+    SLD_INTERNAL_INLINE SLD_SIMD_TARGET("avx512f,avx512bw,vaes") void
+    hash128_lanes_mix(
+        __m512i&    r1,
+        __m512i&    r2,
+        __m512i&    r3,
+        __m512i&    r4,
+        __m512i&    r5,
+        const byte* data,
+        const u32   stride) {
+
+        hash128_lanes_mix_reg(r1, r2, r3, r4, r5,
+            hash128_lanes_load(data + 15, stride),
+            hash128_lanes_load(data + 0,  stride),
+            hash128_lanes_load(data + 1,  stride),
+            hash128_lanes_load(data + 16, stride));
+    }
+
+    SLD_INTERNAL_INLINE SLD_SIMD_TARGET("avx512f,avx512bw,vaes") void
+    hash128_lanes_shuffle(
+        __m512i&       r1,
+        __m512i&       r2,
+        const __m512i& r3,
+        __m512i&       r4,
+        __m512i&       r5,
+        const __m512i& r6) {
+
+        r1 = _mm512_aesdec_epi128 (r1, r4);
+        r2 = _mm512_add_epi64     (r2, r5);
+        r4 = _mm512_xor_si512     (r4, r6);
+        r4 = _mm512_aesdec_epi128 (r4, r2);
+        r5 = _mm512_add_epi64     (r5, r6);
+        r2 = _mm512_xor_si512     (r2, r3);
+    }
+
+    SLD_INTERNAL SLD_SIMD_TARGET("avx512f,avx512bw,vaes") void
+    hash128_data_lanes(
+        const hash128_seed_t& seed,
+        const byte*           data,
+        const u32             stride,
+        hash128_t*            hashes) {
+
+        __m512i x0 = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)&seed.buffer[0x00]));
+        __m512i x1 = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)&seed.buffer[0x10]));
+        __m512i x2 = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)&seed.buffer[0x20]));
+        __m512i x3 = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)&seed.buffer[0x30]));
+        __m512i x4 = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)&seed.buffer[0x40]));
+        __m512i x5 = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)&seed.buffer[0x50]));
+        __m512i x6 = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)&seed.buffer[0x60]));
+        __m512i x7 = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)&seed.buffer[0x70]));
+
+        // full 256 byte blocks
+        const byte* block = data;
+        for (
+            u32 block_count = (stride >> 8);
+                block_count > 0;
+              --block_count) {
+
+            hash128_lanes_mix(x0, x4, x6, x1, x2, block + 0x00, stride);
+            hash128_lanes_mix(x1, x5, x7, x2, x3, block + 0x20, stride);
+            hash128_lanes_mix(x2, x6, x0, x3, x4, block + 0x40, stride);
+            hash128_lanes_mix(x3, x7, x1, x4, x5, block + 0x60, stride);
+            hash128_lanes_mix(x4, x0, x2, x5, x6, block + 0x80, stride);
+            hash128_lanes_mix(x5, x1, x3, x6, x7, block + 0xA0, stride);
+            hash128_lanes_mix(x6, x2, x4, x7, x0, block + 0xC0, stride);
+            hash128_lanes_mix(x7, x3, x5, x0, x1, block + 0xE0, stride);
+            block += 0x100;
+        }
+
+        // the residual under 32 bytes, padded the way meow pads it. the
+        // length is the same for every record, only the bytes differ
+        const u32     residual_offset = (stride & ~0xF);
+        const u32     residual_length = (stride & 0xF);
+        const __m128i zero            = _mm_setzero_si128();
+        __m512i       residual_high   = _mm512_setzero_si512();
+        __m512i       residual_low    = _mm512_setzero_si512();
+
+        for (
+            u32 lane = 0;
+                lane < HASH128_BATCH_LANE_COUNT;
+              ++lane) {
+
+            const byte* lane_data = &data[(u64)lane * stride];
+            const byte* last      = &lane_data[residual_offset];
+            __m128i     high      = zero;
+            __m128i     low       = zero;
+
+            // never read across a page the record doesn't touch
+            if (residual_length != 0) {
+
+                const __m128i mask    = _mm_loadu_si128((const __m128i*)&MeowMaskLen[0x10 - residual_length]);
+                const byte*   last_ok = (const byte*)((((u64)(lane_data + stride - 1)) | (MEOW_PAGESIZE - 1)) - 16);
+                const u32     align   = (last > last_ok) ? ((u32)(u64)last & 0xF) : 0;
+                const __m128i shift   = _mm_loadu_si128((const __m128i*)&MeowShiftAdjust[align]);
+                high = _mm_loadu_si128  ((const __m128i*)(last - align));
+                high = _mm_shuffle_epi8 (high, shift);
+                high = _mm_and_si128    (high, mask);
+            }
+
+            if (stride & 0x10) {
+                low  = high;
+                high = _mm_loadu_si128((const __m128i*)(last - 0x10));
+            }
+
+            residual_high = _mm512_mask_broadcast_i32x4(residual_high, (__mmask16)(0xF << (lane * 4)), high);
+            residual_low  = _mm512_mask_broadcast_i32x4(residual_low,  (__mmask16)(0xF << (lane * 4)), low);
+        }
+
+        // to keep the mix down pattern the residual is always mixed, then
+        // the length is appended
+        const __m512i length    = _mm512_broadcast_i32x4(_mm_set_epi64x(0, stride));
+        const __m512i length_15 = _mm512_alignr_epi8(_mm512_setzero_si512(), length, 15);
+        const __m512i length_1  = _mm512_alignr_epi8(_mm512_setzero_si512(), length, 1);
+
+        hash128_lanes_mix_reg(x0, x4, x6, x1, x2,
+            _mm512_alignr_epi8(residual_high, residual_low, 15), residual_high,
+            _mm512_alignr_epi8(residual_high, residual_low, 1),  residual_low);
+        hash128_lanes_mix_reg(x1, x5, x7, x2, x3,
+            length_15, _mm512_setzero_si512(), length_1, length);
+
+        // the remaining full 32 byte blocks
+        const u32 tail_count = (stride >> 5) & 7;
+        if (tail_count > 0) hash128_lanes_mix(x2, x6, x0, x3, x4, block + 0x00, stride);
+        if (tail_count > 1) hash128_lanes_mix(x3, x7, x1, x4, x5, block + 0x20, stride);
+        if (tail_count > 2) hash128_lanes_mix(x4, x0, x2, x5, x6, block + 0x40, stride);
+        if (tail_count > 3) hash128_lanes_mix(x5, x1, x3, x6, x7, block + 0x60, stride);
+        if (tail_count > 4) hash128_lanes_mix(x6, x2, x4, x7, x0, block + 0x80, stride);
+        if (tail_count > 5) hash128_lanes_mix(x7, x3, x5, x0, x1, block + 0xA0, stride);
+        if (tail_count > 6) hash128_lanes_mix(x0, x4, x6, x1, x2, block + 0xC0, stride);
+
+        // mix the eight registers down to one
+        hash128_lanes_shuffle(x0, x1, x2, x4, x5, x6);
+        hash128_lanes_shuffle(x1, x2, x3, x5, x6, x7);
+        hash128_lanes_shuffle(x2, x3, x4, x6, x7, x0);
+        hash128_lanes_shuffle(x3, x4, x5, x7, x0, x1);
+        hash128_lanes_shuffle(x4, x5, x6, x0, x1, x2);
+        hash128_lanes_shuffle(x5, x6, x7, x1, x2, x3);
+        hash128_lanes_shuffle(x6, x7, x0, x2, x3, x4);
+        hash128_lanes_shuffle(x7, x0, x1, x3, x4, x5);
+        hash128_lanes_shuffle(x0, x1, x2, x4, x5, x6);
+        hash128_lanes_shuffle(x1, x2, x3, x5, x6, x7);
+        hash128_lanes_shuffle(x2, x3, x4, x6, x7, x0);
+        hash128_lanes_shuffle(x3, x4, x5, x7, x0, x1);
+
+        x0 = _mm512_add_epi64 (x0, x2);
+        x1 = _mm512_add_epi64 (x1, x3);
+        x4 = _mm512_add_epi64 (x4, x6);
+        x5 = _mm512_add_epi64 (x5, x7);
+        x0 = _mm512_xor_si512 (x0, x1);
+        x4 = _mm512_xor_si512 (x4, x5);
+        x0 = _mm512_add_epi64 (x0, x4);
+        _mm512_storeu_si512((void*)hashes, x0);
+    }
+
+    SLD_INTERNAL void
+    hash128_data_batch_job(
+        os_thread_context_t& context) {
+
+        const hash_batch_job_t* job    = (const hash_batch_job_t*)context.data.ptr;
+        const u64               offset = (u64)job->start * job->stride;
+        (void)hash128_data_batch(*job->seed_128, job->count, &job->data[offset], job->stride, &job->hashes_128[job->start]);
+    }
+
     SLD_API bool
     hash128_data_batch(
         const hash128_seed_t& in_seed,
@@ -41,12 +246,26 @@ namespace sld {
         can_hash &= (out_hashes != NULL);
         
         if (can_hash) {
+
+            // long records already keep the aes unit busy on their own
+            u32 index = 0;
+            if (in_stride <= HASH128_BATCH_LANE_STRIDE_MAX && simd_has_vaes()) {
+                for (
+                    ;
+                    (index + HASH128_BATCH_LANE_COUNT) <= in_count;
+                    index += HASH128_BATCH_LANE_COUNT) {
+
+                    const u64 offset = (u64)index * in_stride;
+                    hash128_data_lanes(in_seed, &in_data[offset], in_stride, &out_hashes[index]);
+                }
+            }
+
             for (
-                u32 index = 0;
+                ;
                 index < in_count;
                 ++index) {
 
-                const u32     offset   = index * in_stride;
+                const u64     offset   = (u64)index * in_stride;
                 const __m128i hash_reg = MeowHash((void*)in_seed.buffer, in_stride, (void*)&in_data[offset]);
                 _mm_store_si128((__m128i*)&out_hashes[index], hash_reg);
             }
@@ -55,6 +274,166 @@ namespace sld {
         return(can_hash);
     }
 
+    SLD_API bool
+    hash128_data_batch_threaded(
+        const hash128_seed_t& seed,
+        const u32             count,
+        const byte*           data,
+        const u32             stride,
+        hash128_t*            hashes,
+        const u32             thread_count) {
+
+        bool can_hash = true;
+        can_hash &= (count        != 0);
+        can_hash &= (data         != NULL);
+        can_hash &= (stride       != 0);
+        can_hash &= (hashes       != NULL);
+        can_hash &= (thread_count != 0);
+        if (!can_hash) return(can_hash);
+
+        hash_batch_job_t jobs[SLD_HASH_THREAD_MAX];
+        const u32 job_count = hash_batch_job_split(count, stride, thread_count, jobs);
+
+        for (
+            u32 job = 0;
+                job < job_count;
+              ++job) {
+
+            jobs[job].seed_128   = &seed;
+            jobs[job].data       = data;
+            jobs[job].stride     = stride;
+            jobs[job].hashes_128 = hashes;
+        }
+
+        hash_batch_job_run(jobs, job_count, hash128_data_batch_job);
+        return(can_hash);
+    }
+
+    //-------------------------------------------------------------------
+    // SEARCH KERNELS
+    //-------------------------------------------------------------------
+
+    // a hash matches when all of its lanes do, so the avx kernels pack
+    // the per lane compare bits of a pass into one mask and keep the bits
+    // whose whole group is set. they return the index of the first match
+    // or count if there is none
+
+    SLD_INTERNAL u32
+    hash128_search_sse2(
+        const u32        count,
+        const hash128_t& search,
+        const hash128_t* array) {
+
+        const __m128i needle = _mm_load_si128((const __m128i*)&search);
+
+        // hashes are 16 byte aligned, so the loads fold into the
+        // compares. a miss almost never matches even one lane, so the
+        // pass ORs every compare together and only a lane that did match
+        // sends it back over the eight hashes for the one that matches
+        // whole. folding each hash down to one 64 bit or 128 bit result
+        // first costs two shuffles a hash and measures slower
+        u32 index = 0;
+        for (; (index + 8) <= count; index += 8) {
+
+            const __m128i* block = (const __m128i*)&array[index];
+            const __m128i  eq_01 = _mm_or_si128(_mm_cmpeq_epi32(_mm_load_si128(&block[0]), needle), _mm_cmpeq_epi32(_mm_load_si128(&block[1]), needle));
+            const __m128i  eq_23 = _mm_or_si128(_mm_cmpeq_epi32(_mm_load_si128(&block[2]), needle), _mm_cmpeq_epi32(_mm_load_si128(&block[3]), needle));
+            const __m128i  eq_45 = _mm_or_si128(_mm_cmpeq_epi32(_mm_load_si128(&block[4]), needle), _mm_cmpeq_epi32(_mm_load_si128(&block[5]), needle));
+            const __m128i  eq_67 = _mm_or_si128(_mm_cmpeq_epi32(_mm_load_si128(&block[6]), needle), _mm_cmpeq_epi32(_mm_load_si128(&block[7]), needle));
+            const __m128i  eq    = _mm_or_si128(_mm_or_si128(eq_01, eq_23), _mm_or_si128(eq_45, eq_67));
+            if (_mm_movemask_epi8(eq) == 0) continue;
+
+            for (
+                u32 block_index = 0;
+                    block_index < 8;
+                  ++block_index) {
+
+                const __m128i current = _mm_load_si128(&block[block_index]);
+                if (MeowHashesAreEqual(needle, current)) return(index + block_index);
+            }
+        }
+
+        for (; index < count; ++index) {
+            const __m128i current = _mm_load_si128((const __m128i*)&array[index]);
+            if (MeowHashesAreEqual(needle, current)) return(index);
+        }
+        return(count);
+    }
+
+    SLD_INTERNAL SLD_SIMD_TARGET("avx2") u32
+    hash128_search_avx2(
+        const u32        count,
+        const hash128_t& search,
+        const hash128_t* array) {
+
+        // two hashes per register, compared as two u64 lanes each
+        const __m256i needle = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)&search));
+
+        u32 index = 0;
+        for (; (index + 8) <= count; index += 8) {
+
+            const __m256i* block = (const __m256i*)&array[index];
+            const u32 mask =
+                ((u32)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_loadu_si256(&block[0]), needle))) <<  0) |
+                ((u32)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_loadu_si256(&block[1]), needle))) <<  4) |
+                ((u32)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_loadu_si256(&block[2]), needle))) <<  8) |
+                ((u32)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_loadu_si256(&block[3]), needle))) << 12);
+
+            const u32 match = mask & (mask >> 1) & 0x5555;
+            if (match != 0) return(index + (bit_scan_forward(match) / 2));
+        }
+
+        // stay in this kernel, calling back into sse code with the upper
+        // halves dirty costs a state transition
+        for (; index < count; ++index) {
+            const bool is_equal =
+                (array[index].val.as_u64[0] == search.val.as_u64[0]) &&
+                (array[index].val.as_u64[1] == search.val.as_u64[1]);
+            if (is_equal) return(index);
+        }
+        return(count);
+    }
+
+    SLD_INTERNAL SLD_SIMD_TARGET("avx512f") u32
+    hash128_search_avx512(
+        const u32        count,
+        const hash128_t& search,
+        const hash128_t* array) {
+
+        // four hashes per register
+        const __m512i needle = _mm512_broadcast_i32x4(_mm_load_si128((const __m128i*)&search));
+
+        u32 index = 0;
+        for (; (index + 16) <= count; index += 16) {
+
+            const __m512i* block = (const __m512i*)&array[index];
+            const u32 mask =
+                ((u32)_mm512_cmpeq_epi64_mask(_mm512_loadu_si512(&block[0]), needle) <<  0) |
+                ((u32)_mm512_cmpeq_epi64_mask(_mm512_loadu_si512(&block[1]), needle) <<  8) |
+                ((u32)_mm512_cmpeq_epi64_mask(_mm512_loadu_si512(&block[2]), needle) << 16) |
+                ((u32)_mm512_cmpeq_epi64_mask(_mm512_loadu_si512(&block[3]), needle) << 24);
+
+            const u32 match = mask & (mask >> 1) & 0x55555555;
+            if (match != 0) return(index + (bit_scan_forward(match) / 2));
+        }
+
+        // masked loads cover the tail without reading past the end
+        for (; index < count; index += 4) {
+
+            const u32       remaining = (count - index);
+            const __mmask8  load_mask = (remaining >= 4) ? (__mmask8)0xFF : (__mmask8)((1u << (remaining * 2)) - 1);
+            const __m512i   block     = _mm512_maskz_loadu_epi64(load_mask, &array[index]);
+            const u32       mask      = (u32)_mm512_mask_cmpeq_epi64_mask(load_mask, block, needle);
+            const u32       match     = mask & (mask >> 1) & 0x55;
+            if (match != 0) return(index + (bit_scan_forward(match) / 2));
+        }
+        return(count);
+    }
+
+    //-------------------------------------------------------------------
+    // SEARCH
+    //-------------------------------------------------------------------
+
     SLD_API bool
     hash128_search(
         const u32      in_count,
@@ -67,21 +446,13 @@ namespace sld {
         can_search &= (in_array != NULL);
         if (!can_search) return(can_search);
 
-        const meow_u128 meow_search = _mm_load_si128((meow_u128*)&in_search);
-
-        bool is_found = false;
-        for (
-            out_index = 0;
-            (
-                out_index    <  in_count &&
-                is_found == false
-            );
-            ++out_index) {
-
-            const meow_u128 meow_current = _mm_load_si128((meow_u128*)&in_array[out_index]);
-            is_found = MeowHashesAreEqual(meow_search, meow_current);
+        switch (simd_get_level()) {
+            case (simd_level_e_avx512): out_index = hash128_search_avx512 (in_count, in_search, in_array); break;
+            case (simd_level_e_avx2):   out_index = hash128_search_avx2   (in_count, in_search, in_array); break;
+            default:                    out_index = hash128_search_sse2   (in_count, in_search, in_array); break;
         }
 
+        const bool is_found = (out_index < in_count);
         return(is_found);
     }
 
@@ -3,6 +3,8 @@
 #include <zlib-ng.h>
 
 #include "sld-hash.hpp"
+#include "sld-simd.hpp"
+#include "sld-hash-batch.cpp"
 
 namespace sld {
 
@@ -40,13 +42,57 @@ namespace sld {
                 index < count;
                 ++index) {
 
-                const u32 offset     = index * stride; 
+                const u64 offset     = (u64)index * stride; 
                 hashes[index].as_u32 = zng_crc32(seed.val, &data[offset], stride);
             }
         }
         return(can_hash);
     }
 
+    SLD_INTERNAL void
+    hash32_batch_job(
+        os_thread_context_t& context) {
+
+        const hash_batch_job_t* job    = (const hash_batch_job_t*)context.data.ptr;
+        const u64               offset = (u64)job->start * job->stride;
+        (void)hash32_batch(job->seed_32, &job->data[offset], job->stride, job->count, &job->hashes_32[job->start]);
+    }
+
+    SLD_API bool
+    hash32_batch_threaded(
+        const hash32_seed_t seed,
+        const byte*         data,
+        const u32           stride,
+        const u32           count,
+        hash32_t*           hashes,
+        const u32           thread_count) {
+
+        bool can_hash = true;
+        can_hash &= (data         != NULL);
+        can_hash &= (stride       != 0);
+        can_hash &= (count        != 0);
+        can_hash &= (hashes       != NULL);
+        can_hash &= (thread_count != 0);
+        if (!can_hash) return(can_hash);
+
+        hash_batch_job_t jobs[SLD_HASH_THREAD_MAX];
+        const u32 job_count = hash_batch_job_split(count, stride, thread_count, jobs);
+
+        for (
+            u32 job = 0;
+                job < job_count;
+              ++job) {
+
+            jobs[job].seed_32   = seed;
+            jobs[job].data      = data;
+            jobs[job].stride    = stride;
+            jobs[job].hashes_32 = hashes;
+        }
+
+        hash_batch_job_run(jobs, job_count, hash32_batch_job);
+        return(can_hash);
+    }
+
     SLD_API bool
     hash32_is_equal(
         const hash32_seed_t seed,
@@ -67,6 +113,118 @@ namespace sld {
         return(is_equal);
     }
 
+    //-------------------------------------------------------------------
+    // SEARCH KERNELS
+    //-------------------------------------------------------------------
+
+    // each kernel compares four registers of hashes per pass and only
+    // branches once, then works out which lane matched. they return the
+    // index of the first match or count if there is none
+
+    SLD_INTERNAL u32
+    hash32_search_sse2(
+        const u32       count,
+        const u32       search,
+        const hash32_t* array) {
+
+        const __m128i needle = _mm_set1_epi32((int)search);
+
+        u32 index = 0;
+        for (; (index + 16) <= count; index += 16) {
+
+            const __m128i* block = (const __m128i*)&array[index];
+            const __m128i  eq_0  = _mm_cmpeq_epi32(_mm_loadu_si128(&block[0]), needle);
+            const __m128i  eq_1  = _mm_cmpeq_epi32(_mm_loadu_si128(&block[1]), needle);
+            const __m128i  eq_2  = _mm_cmpeq_epi32(_mm_loadu_si128(&block[2]), needle);
+            const __m128i  eq_3  = _mm_cmpeq_epi32(_mm_loadu_si128(&block[3]), needle);
+            const __m128i  eq    = _mm_or_si128(_mm_or_si128(eq_0, eq_1), _mm_or_si128(eq_2, eq_3));
+            if (_mm_movemask_epi8(eq) == 0) continue;
+
+            const u32 mask =
+                ((u32)_mm_movemask_ps(_mm_castsi128_ps(eq_0)) <<  0) |
+                ((u32)_mm_movemask_ps(_mm_castsi128_ps(eq_1)) <<  4) |
+                ((u32)_mm_movemask_ps(_mm_castsi128_ps(eq_2)) <<  8) |
+                ((u32)_mm_movemask_ps(_mm_castsi128_ps(eq_3)) << 12);
+            return(index + bit_scan_forward(mask));
+        }
+
+        for (; index < count; ++index) {
+            if (array[index].as_u32 == search) return(index);
+        }
+        return(count);
+    }
+
+    SLD_INTERNAL SLD_SIMD_TARGET("avx2") u32
+    hash32_search_avx2(
+        const u32       count,
+        const u32       search,
+        const hash32_t* array) {
+
+        const __m256i needle = _mm256_set1_epi32((int)search);
+
+        u32 index = 0;
+        for (; (index + 32) <= count; index += 32) {
+
+            const __m256i* block = (const __m256i*)&array[index];
+            const __m256i  eq_0  = _mm256_cmpeq_epi32(_mm256_loadu_si256(&block[0]), needle);
+            const __m256i  eq_1  = _mm256_cmpeq_epi32(_mm256_loadu_si256(&block[1]), needle);
+            const __m256i  eq_2  = _mm256_cmpeq_epi32(_mm256_loadu_si256(&block[2]), needle);
+            const __m256i  eq_3  = _mm256_cmpeq_epi32(_mm256_loadu_si256(&block[3]), needle);
+            const __m256i  eq    = _mm256_or_si256(_mm256_or_si256(eq_0, eq_1), _mm256_or_si256(eq_2, eq_3));
+            if (_mm256_testz_si256(eq, eq)) continue;
+
+            const u32 mask =
+                ((u32)_mm256_movemask_ps(_mm256_castsi256_ps(eq_0)) <<  0) |
+                ((u32)_mm256_movemask_ps(_mm256_castsi256_ps(eq_1)) <<  8) |
+                ((u32)_mm256_movemask_ps(_mm256_castsi256_ps(eq_2)) << 16) |
+                ((u32)_mm256_movemask_ps(_mm256_castsi256_ps(eq_3)) << 24);
+            return(index + bit_scan_forward(mask));
+        }
+
+        // stay in this kernel, calling back into sse code with the upper
+        // halves dirty costs a state transition
+        for (; index < count; ++index) {
+            if (array[index].as_u32 == search) return(index);
+        }
+        return(count);
+    }
+
+    SLD_INTERNAL SLD_SIMD_TARGET("avx512f") u32
+    hash32_search_avx512(
+        const u32       count,
+        const u32       search,
+        const hash32_t* array) {
+
+        const __m512i needle = _mm512_set1_epi32((int)search);
+
+        u32 index = 0;
+        for (; (index + 64) <= count; index += 64) {
+
+            const __m512i* block = (const __m512i*)&array[index];
+            const u64 mask =
+                ((u64)_mm512_cmpeq_epi32_mask(_mm512_loadu_si512(&block[0]), needle) <<  0) |
+                ((u64)_mm512_cmpeq_epi32_mask(_mm512_loadu_si512(&block[1]), needle) << 16) |
+                ((u64)_mm512_cmpeq_epi32_mask(_mm512_loadu_si512(&block[2]), needle) << 32) |
+                ((u64)_mm512_cmpeq_epi32_mask(_mm512_loadu_si512(&block[3]), needle) << 48);
+            if (mask != 0) return(index + bit_scan_forward(mask));
+        }
+
+        // masked loads cover the tail without reading past the end
+        for (; index < count; index += 16) {
+
+            const u32       remaining = (count - index);
+            const __mmask16 load_mask = (remaining >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u << remaining) - 1);
+            const __m512i   block     = _mm512_maskz_loadu_epi32(load_mask, &array[index]);
+            const __mmask16 mask      = _mm512_mask_cmpeq_epi32_mask(load_mask, block, needle);
+            if (mask != 0) return(index + bit_scan_forward(mask));
+        }
+        return(count);
+    }
+
+    //-------------------------------------------------------------------
+    // SEARCH
+    //-------------------------------------------------------------------
+
     SLD_API bool
     hash32_search(
         const u32       count,
@@ -74,22 +232,18 @@ namespace sld {
         const hash32_t* array,
         u32&            index) {
 
-        //TODO: SIMD
-
-        bool is_found   = false;
         bool can_search = true;
         can_search &= (count != 0);
         can_search &= (array != NULL);
-        if (can_search) {
-            for (
-                index = 0;
-                (index < count) && !is_found;
-                ++index) {
+        if (!can_search) return(false);
 
-                is_found = (search.as_u32 == array[index].as_u32);
-            }
+        switch (simd_get_level()) {
+            case (simd_level_e_avx512): index = hash32_search_avx512 (count, search.as_u32, array); break;
+            case (simd_level_e_avx2):   index = hash32_search_avx2   (count, search.as_u32, array); break;
+            default:                    index = hash32_search_sse2   (count, search.as_u32, array); break;
         }
 
+        const bool is_found = (index < count);
         return(is_found);
     }
 };
\ No newline at end of file
@@ -0,0 +1,368 @@
+#pragma once
+
+#include "sld-hash.hpp"
+#include "sld-simd.hpp"
+#include "sld-hash-batch.cpp"
+
+#ifndef    SLD_HASH32C_STREAM_SIZE
+#   define SLD_HASH32C_STREAM_SIZE 256
+#endif
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // DECLARATIONS
+    //-------------------------------------------------------------------
+
+    // crc32c, the castagnoli polynomial the sse4.2 crc32 instruction
+    // computes. it is not the zlib crc, so hash32 keeps that one for
+    // checksums. the kernel is picked once from the cpu, and the software
+    // kernel gives the same values where sse4.2 is missing.
+    // shift applies stream size zero bytes to a crc, it is how the three
+    // interleaved streams are joined back into one
+    struct hash32c_tables_t {
+        u32 bytes [256];
+        u32 shift [4][256];
+    };
+
+    using hash32c_kernel_f = u32 (*) (u32 crc, const byte* data, u64 length);
+
+    constexpr u32 HASH32C_POLYNOMIAL      = 0x82F63B78;
+    constexpr u32 HASH32C_LANE_COUNT      = 4;
+    constexpr u32 HASH32C_LANE_STRIDE_MAX = (SLD_HASH32C_STREAM_SIZE * 3);
+
+    SLD_UTILITY  hash32c_tables_t        hash32c_tables_build    (void);
+    SLD_INTERNAL const hash32c_tables_t& hash32c_tables_get      (void);
+    SLD_INTERNAL hash32c_kernel_f        hash32c_kernel_get      (void);
+    SLD_INTERNAL u32                     hash32c_software        (u32 crc, const byte* data, u64 length);
+    SLD_INTERNAL u32                     hash32c_sse42           (u32 crc, const byte* data, u64 length);
+    SLD_INTERNAL void                    hash32c_lanes_sse42     (const u32 crc, const byte* data, const u32 stride, hash32_t* hashes);
+    SLD_INTERNAL void                    hash32c_batch_job       (os_thread_context_t& context);
+
+    //-------------------------------------------------------------------
+    // API
+    //-------------------------------------------------------------------
+
+    SLD_API const hash32_t
+    hash32c(
+        const hash32_seed_t seed,
+        const byte*         data,
+        const u32           length) {
+
+        static const hash32c_kernel_f kernel = hash32c_kernel_get();
+
+        const hash32_t hash = {
+            ~kernel(~seed.val, data, length)
+        };
+
+        return(hash);
+    }
+
+    SLD_API bool
+    hash32c_batch(
+        const hash32_seed_t seed,
+        const byte*         data,
+        const u32           stride,
+        const u32           count,
+        hash32_t*           hashes) {
+
+        bool can_hash = true;
+        can_hash &= (data   != NULL);
+        can_hash &= (stride != 0);
+        can_hash &= (count  != 0);
+        can_hash &= (hashes != NULL);
+
+        if (can_hash) {
+
+            // short records are one dependent chain each, so run several
+            // side by side. long ones interleave within the record
+            u32 index = 0;
+            if (stride <= HASH32C_LANE_STRIDE_MAX && simd_has_sse42()) {
+                for (
+                    ;
+                    (index + HASH32C_LANE_COUNT) <= count;
+                    index += HASH32C_LANE_COUNT) {
+
+                    const u64 offset = (u64)index * stride;
+                    hash32c_lanes_sse42(~seed.val, &data[offset], stride, &hashes[index]);
+                }
+            }
+
+            for (
+                ;
+                index < count;
+                ++index) {
+
+                const u64 offset = (u64)index * stride;
+                hashes[index]    = hash32c(seed, &data[offset], stride);
+            }
+        }
+        return(can_hash);
+    }
+
+    SLD_API bool
+    hash32c_batch_threaded(
+        const hash32_seed_t seed,
+        const byte*         data,
+        const u32           stride,
+        const u32           count,
+        hash32_t*           hashes,
+        const u32           thread_count) {
+
+        bool can_hash = true;
+        can_hash &= (data         != NULL);
+        can_hash &= (stride       != 0);
+        can_hash &= (count        != 0);
+        can_hash &= (hashes       != NULL);
+        can_hash &= (thread_count != 0);
+        if (!can_hash) return(can_hash);
+
+        hash_batch_job_t jobs[SLD_HASH_THREAD_MAX];
+        const u32 job_count = hash_batch_job_split(count, stride, thread_count, jobs);
+
+        for (
+            u32 job = 0;
+                job < job_count;
+              ++job) {
+
+            jobs[job].seed_32   = seed;
+            jobs[job].data      = data;
+            jobs[job].stride    = stride;
+            jobs[job].hashes_32 = hashes;
+        }
+
+        hash_batch_job_run(jobs, job_count, hash32c_batch_job);
+        return(can_hash);
+    }
+
+    SLD_API bool
+    hash32c_is_equal(
+        const hash32_seed_t seed,
+        const byte*         data,
+        const u32           length,
+        const hash32_t      hash) {
+
+        bool is_equal = false;
+        bool can_hash = true;
+        can_hash &= (data   != NULL);
+        can_hash &= (length != 0);
+
+        if (can_hash) {
+            const hash32_t data_hash = hash32c(seed, data, length);
+            is_equal                 = (data_hash.as_u32 == hash.as_u32);
+        }
+
+        return(is_equal);
+    }
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_UTILITY hash32c_tables_t
+    hash32c_tables_build(
+        void) {
+
+        hash32c_tables_t tables = {};
+        for (
+            u32 value = 0;
+                value < 256;
+              ++value) {
+
+            u32 crc = value;
+            for (u32 bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1) ? ((crc >> 1) ^ HASH32C_POLYNOMIAL) : (crc >> 1);
+            }
+            tables.bytes[value] = crc;
+        }
+
+        // the crc is linear, so shifting any value is the xor of shifting
+        // each of its bits, and those go in byte sized tables
+        u32 basis[32] = {};
+        for (
+            u32 bit = 0;
+                bit < 32;
+              ++bit) {
+
+            u32 crc = (1u << bit);
+            for (u32 zero = 0; zero < SLD_HASH32C_STREAM_SIZE; ++zero) {
+                crc = tables.bytes[crc & 0xFF] ^ (crc >> 8);
+            }
+            basis[bit] = crc;
+        }
+
+        for (
+            u32 part = 0;
+                part < 4;
+              ++part) {
+
+            for (
+                u32 value = 0;
+                    value < 256;
+                  ++value) {
+
+                u32 crc = 0;
+                for (u32 bit = 0; bit < 8; ++bit) {
+                    if (value & (1u << bit)) crc ^= basis[(part * 8) + bit];
+                }
+                tables.shift[part][value] = crc;
+            }
+        }
+        return(tables);
+    }
+
+    SLD_INTERNAL const hash32c_tables_t&
+    hash32c_tables_get(
+        void) {
+
+        static constexpr hash32c_tables_t tables = hash32c_tables_build();
+        return(tables);
+    }
+
+    SLD_INTERNAL hash32c_kernel_f
+    hash32c_kernel_get(
+        void) {
+
+        const hash32c_kernel_f kernel = simd_has_sse42()
+            ? hash32c_sse42
+            : hash32c_software;
+
+        return(kernel);
+    }
+
+    SLD_INTERNAL u32
+    hash32c_software(
+        u32         crc,
+        const byte* data,
+        u64         length) {
+
+        const hash32c_tables_t& tables = hash32c_tables_get();
+        for (
+            u64 index = 0;
+                index < length;
+              ++index) {
+
+            crc = tables.bytes[(crc ^ data[index]) & 0xFF] ^ (crc >> 8);
+        }
+        return(crc);
+    }
+
+    SLD_INTERNAL SLD_SIMD_TARGET("sse4.2") u32
+    hash32c_sse42(
+        u32         crc,
+        const byte* data,
+        u64         length) {
+
+        const hash32c_tables_t& tables = hash32c_tables_get();
+
+        // the instruction has a latency of three and a throughput of one,
+        // so three streams of one pass run in parallel, then the first
+        // two are shifted past the ones after them and folded in
+        u64 crc_0 = crc;
+        while (length >= HASH32C_LANE_STRIDE_MAX) {
+
+            const byte* stream_1 = &data[SLD_HASH32C_STREAM_SIZE];
+            const byte* stream_2 = &data[SLD_HASH32C_STREAM_SIZE * 2];
+            u64         crc_1    = 0;
+            u64         crc_2    = 0;
+
+            for (
+                u32 offset = 0;
+                    offset < SLD_HASH32C_STREAM_SIZE;
+                    offset += 8) {
+
+                u64 block_0, block_1, block_2;
+                (void)memcpy(&block_0, &data[offset],     8);
+                (void)memcpy(&block_1, &stream_1[offset], 8);
+                (void)memcpy(&block_2, &stream_2[offset], 8);
+                crc_0 = _mm_crc32_u64(crc_0, block_0);
+                crc_1 = _mm_crc32_u64(crc_1, block_1);
+                crc_2 = _mm_crc32_u64(crc_2, block_2);
+            }
+
+            crc_0 = crc_1 ^ tables.shift[0][crc_0 & 0xFF] ^ tables.shift[1][(crc_0 >> 8)  & 0xFF]
+                          ^ tables.shift[2][(crc_0 >> 16) & 0xFF] ^ tables.shift[3][(crc_0 >> 24) & 0xFF];
+            crc_0 = crc_2 ^ tables.shift[0][crc_0 & 0xFF] ^ tables.shift[1][(crc_0 >> 8)  & 0xFF]
+                          ^ tables.shift[2][(crc_0 >> 16) & 0xFF] ^ tables.shift[3][(crc_0 >> 24) & 0xFF];
+
+            data   += HASH32C_LANE_STRIDE_MAX;
+            length -= HASH32C_LANE_STRIDE_MAX;
+        }
+
+        for (; length >= 8; length -= 8, data += 8) {
+            u64 block;
+            (void)memcpy(&block, data, 8);
+            crc_0 = _mm_crc32_u64(crc_0, block);
+        }
+
+        u32 crc_tail = (u32)crc_0;
+        for (; length > 0; --length, ++data) {
+            crc_tail = _mm_crc32_u8(crc_tail, *data);
+        }
+        return(crc_tail);
+    }
+
+    SLD_INTERNAL SLD_SIMD_TARGET("sse4.2") void
+    hash32c_lanes_sse42(
+        const u32   crc,
+        const byte* data,
+        const u32   stride,
+        hash32_t*   hashes) {
+
+        const byte* data_0 = &data[0];
+        const byte* data_1 = &data[(u64)stride * 1];
+        const byte* data_2 = &data[(u64)stride * 2];
+        const byte* data_3 = &data[(u64)stride * 3];
+
+        u64 crc_0 = crc;
+        u64 crc_1 = crc;
+        u64 crc_2 = crc;
+        u64 crc_3 = crc;
+
+        const u32 length_blocks = (stride & ~7u);
+        for (
+            u32 offset = 0;
+                offset < length_blocks;
+                offset += 8) {
+
+            u64 block_0, block_1, block_2, block_3;
+            (void)memcpy(&block_0, &data_0[offset], 8);
+            (void)memcpy(&block_1, &data_1[offset], 8);
+            (void)memcpy(&block_2, &data_2[offset], 8);
+            (void)memcpy(&block_3, &data_3[offset], 8);
+            crc_0 = _mm_crc32_u64(crc_0, block_0);
+            crc_1 = _mm_crc32_u64(crc_1, block_1);
+            crc_2 = _mm_crc32_u64(crc_2, block_2);
+            crc_3 = _mm_crc32_u64(crc_3, block_3);
+        }
+
+        u32 crc_tail_0 = (u32)crc_0;
+        u32 crc_tail_1 = (u32)crc_1;
+        u32 crc_tail_2 = (u32)crc_2;
+        u32 crc_tail_3 = (u32)crc_3;
+        for (
+            u32 offset = length_blocks;
+                offset < stride;
+              ++offset) {
+
+            crc_tail_0 = _mm_crc32_u8(crc_tail_0, data_0[offset]);
+            crc_tail_1 = _mm_crc32_u8(crc_tail_1, data_1[offset]);
+            crc_tail_2 = _mm_crc32_u8(crc_tail_2, data_2[offset]);
+            crc_tail_3 = _mm_crc32_u8(crc_tail_3, data_3[offset]);
+        }
+
+        hashes[0].as_u32 = ~crc_tail_0;
+        hashes[1].as_u32 = ~crc_tail_1;
+        hashes[2].as_u32 = ~crc_tail_2;
+        hashes[3].as_u32 = ~crc_tail_3;
+    }
+
+    SLD_INTERNAL void
+    hash32c_batch_job(
+        os_thread_context_t& context) {
+
+        const hash_batch_job_t* job    = (const hash_batch_job_t*)context.data.ptr;
+        const u64               offset = (u64)job->start * job->stride;
+        (void)hash32c_batch(job->seed_32, &job->data[offset], job->stride, job->count, &job->hashes_32[job->start]);
+    }
+};
\ No newline at end of file
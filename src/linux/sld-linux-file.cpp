@@ -0,0 +1,114 @@
+#pragma once
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include "sld-os.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // DECLARATIONS
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_INTERNAL const os_file_error_t linux_file_get_error_code (const int linux_error);
+
+    //-------------------------------------------------------------------
+    // OS API
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_FUNC const os_file_error_t
+    linux_file_map_read(
+        const c8*      path,
+        os_file_map_t& map) {
+
+        map.data = NULL;
+        map.size = 0;
+
+        const int file = open(path, O_RDONLY | O_CLOEXEC);
+        if (file < 0) return(linux_file_get_error_code(errno));
+
+        struct stat file_stat;
+        const bool did_stat = (fstat(file, &file_stat) == 0);
+        if (!did_stat || file_stat.st_size == 0) {
+            const int linux_error = did_stat ? 0 : errno;
+            (void)close(file);
+            return(linux_file_get_error_code(linux_error));
+        }
+
+        // the mapping holds its own reference to the file
+        const u64 size        = (u64)file_stat.st_size;
+        void*     view        = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+        const int linux_error = (view != MAP_FAILED) ? 0 : errno;
+        (void)close(file);
+
+        if (view != MAP_FAILED) {
+            map.data = (const byte*)view;
+            map.size = size;
+        }
+        return(linux_file_get_error_code(linux_error));
+    }
+
+    SLD_API_OS_FUNC const os_file_error_t
+    linux_file_unmap(
+        os_file_map_t& map) {
+
+        const bool is_empty    = (map.data == NULL) && (map.size == 0);
+        const bool did_unmap   = is_empty || ((map.data != NULL) && (munmap((void*)map.data, map.size) == 0));
+        const int  linux_error = did_unmap ? 0 : EINVAL;
+
+        map.data = NULL;
+        map.size = 0;
+        return(linux_file_get_error_code(linux_error));
+    }
+
+    SLD_API_OS_FUNC const os_file_error_t
+    linux_file_map_prefetch(
+        const os_file_map_t& map,
+        const u64            offset,
+        const u64            size) {
+
+        // only a hint. the range is clamped to the view and starts on a
+        // page, the view itself always does
+        if (offset >= map.size || size == 0) return(linux_file_get_error_code(0));
+
+        const u64 page_size = (u64)sysconf(_SC_PAGESIZE);
+        const u64 start     = offset & ~(page_size - 1);
+        const u64 end       = ((map.size - offset) < size) ? map.size : (offset + size);
+
+        const bool did_advise  = (madvise((void*)(map.data + start), end - start, MADV_WILLNEED) == 0);
+        const int  linux_error = did_advise ? 0 : errno;
+        return(linux_file_get_error_code(linux_error));
+    }
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_INTERNAL const os_file_error_t
+    linux_file_get_error_code(
+        const int linux_error) {
+
+        os_file_error_t error;
+
+        switch (linux_error) {
+            case (0):       { error.val = os_file_error_e_success;           return(error); }
+            case (EINVAL):  { error.val = os_file_error_e_invalid_args;      return(error); }
+            case (EBADF):   { error.val = os_file_error_e_invalid_handle;    return(error); }
+            case (ENODEV):  { error.val = os_file_error_e_invalid_device;    return(error); }
+            case (ETXTBSY): { error.val = os_file_error_e_sharing_violation; return(error); }
+            case (EEXIST):  { error.val = os_file_error_e_already_exists;    return(error); }
+            case (ENOENT):  { error.val = os_file_error_e_not_found;         return(error); }
+            case (EACCES):  { error.val = os_file_error_e_access_denied;     return(error); }
+            case (EPERM):   { error.val = os_file_error_e_access_denied;     return(error); }
+            case (EPIPE):   { error.val = os_file_error_e_broken_pipe;       return(error); }
+            case (EIO):     { error.val = os_file_error_e_disk_io_failure;   return(error); }
+            case (ENOMEM):  { error.val = os_file_error_e_out_of_memory;     return(error); }
+            default:        { error.val = os_file_error_e_unknown;           return(error); }
+        }
+
+        return(error);
+    }
+};
\ No newline at end of file
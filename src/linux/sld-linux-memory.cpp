@@ -0,0 +1,629 @@
+#pragma once
+
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "sld-os.hpp"
+
+#ifndef    SLD_LINUX_MEMORY_RESERVATION_COUNT_MIN
+#   define SLD_LINUX_MEMORY_RESERVATION_COUNT_MIN 256
+#endif
+#ifndef    MAP_HUGE_2MB
+#   define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef    MAP_HUGE_1GB
+#   define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // DECLARATIONS
+    //-------------------------------------------------------------------
+
+    // linux has no equivalent to VirtualQuery that doesn't
+    // involve parsing /proc/self/maps, so we keep our own map of every
+    // reservation with one commit bit per page. each reservation's record
+    // sits at the head of its own commit map, and the index of them is
+    // sorted by address so a lookup is a binary search.
+    // reserve/release take the lock and bump the sequence around every
+    // change to the index, lookups don't lock, they retry if the sequence
+    // moved while they searched. the index doubles when it's full, the
+    // old one is never unmapped because a lookup may still be reading it
+    struct linux_memory_reservation_t {
+        addr start;
+        u64  size;
+        u64  page_size;
+        u64* commit_map;
+        u64  commit_map_size;
+    };
+
+    struct linux_memory_reservation_entry_t {
+        addr                        start;
+        u64                         size;
+        linux_memory_reservation_t* reservation;
+    };
+
+    struct linux_memory_commit_map_t {
+        pthread_mutex_t                   mutex;
+        u32                               sequence;
+        u32                               count;
+        u32                               capacity;
+        linux_memory_reservation_entry_t* entries;
+    };
+
+    static linux_memory_commit_map_t _linux_memory_commit_map = { PTHREAD_MUTEX_INITIALIZER, 0, 0, 0, NULL };
+
+    SLD_API_OS_INTERNAL u64                         linux_memory_page_size          (void);
+    SLD_API_OS_INTERNAL bool                        linux_memory_thp_is_enabled     (void);
+    SLD_API_OS_INTERNAL void*                       linux_memory_reserve_hugetlb    (void* start, const u64 size, const u64 huge_page_size);
+    SLD_API_OS_INTERNAL void*                       linux_memory_reserve_thp        (void* start, const u64 size);
+    SLD_API_OS_INTERNAL u32                         linux_memory_reservation_search (const linux_memory_reservation_entry_t* entries, const u32 count, const addr address);
+    SLD_API_OS_INTERNAL linux_memory_reservation_t* linux_memory_reservation_find   (const addr address);
+    SLD_API_OS_INTERNAL bool                        linux_memory_reservation_add    (const addr start, const u64 size, const u64 page_size);
+    SLD_API_OS_INTERNAL bool                        linux_memory_reservation_grow   (linux_memory_commit_map_t& commit_map);
+    SLD_API_OS_INTERNAL void                        linux_memory_sequence_begin     (linux_memory_commit_map_t& commit_map);
+    SLD_API_OS_INTERNAL void                        linux_memory_sequence_end       (linux_memory_commit_map_t& commit_map);
+    SLD_API_OS_INTERNAL void                        linux_memory_commit_map_set     (linux_memory_reservation_t* reservation, const addr start, const u64 size, const bool is_committed);
+    SLD_API_OS_INTERNAL bool                        linux_memory_commit_map_test    (const linux_memory_reservation_t* reservation, const addr start);
+
+    //-------------------------------------------------------------------
+    // OS API
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_FUNC void*
+    linux_memory_reserve(
+        void*     start,
+        const u64 size) {
+
+        void* memory = mmap(
+            start,
+            size,
+            PROT_NONE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+            -1,
+            0
+        );
+        if (memory == MAP_FAILED) return(NULL);
+
+        // the address is only a hint for mmap, but reserving
+        // at a specific address has to be exact
+        bool is_valid = (start == NULL || memory == start);
+        if (is_valid) is_valid = linux_memory_reservation_add((addr)memory, size, linux_memory_page_size());
+        if (!is_valid) {
+            (void)munmap(memory, size);
+            return(NULL);
+        }
+
+        return(memory);
+    }
+
+    SLD_API_OS_FUNC void*
+    linux_memory_reserve_huge(
+        void*                         start,
+        const u64                     size,
+        const os_memory_page_policy_e page_policy,
+        u64&                          page_size) {
+
+        // each policy falls back to the next smaller one
+        const bool try_1gb = (page_policy == os_memory_page_policy_e_huge_1gb);
+        const bool try_2mb = (page_policy == os_memory_page_policy_e_huge_2mb)    || try_1gb;
+        const bool try_thp = (page_policy == os_memory_page_policy_e_transparent) || try_2mb;
+
+        void* memory = NULL;
+        page_size    = 0;
+
+        if (try_1gb && memory == NULL) {
+            memory    = linux_memory_reserve_hugetlb(start, size, OS_MEMORY_PAGE_SIZE_1GB);
+            page_size = OS_MEMORY_PAGE_SIZE_1GB;
+        }
+        if (try_2mb && memory == NULL) {
+            memory    = linux_memory_reserve_hugetlb(start, size, OS_MEMORY_PAGE_SIZE_2MB);
+            page_size = OS_MEMORY_PAGE_SIZE_2MB;
+        }
+        if (try_thp && memory == NULL) {
+            memory    = linux_memory_reserve_thp(start, size);
+            page_size = OS_MEMORY_PAGE_SIZE_2MB;
+        }
+        if (memory == NULL) {
+            memory    = linux_memory_reserve(start, size);
+            page_size = linux_memory_page_size();
+        }
+
+        if (memory == NULL) page_size = 0;
+        return(memory);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_memory_release(
+        void*     start,
+        const u64 size) {
+
+        linux_memory_commit_map_t& commit_map = _linux_memory_commit_map;
+
+        (void)pthread_mutex_lock(&commit_map.mutex);
+
+        // like VirtualFree, we release the whole reservation. the size
+        // only has to fit in it, it may have been rounded up to the pages
+        bool      result = false;
+        const u32 index  = linux_memory_reservation_search(commit_map.entries, commit_map.count, (addr)start);
+
+        bool can_release = (index < commit_map.count);
+        if (can_release) {
+            can_release &= (commit_map.entries[index].start == (addr)start);
+            can_release &= (size <= commit_map.entries[index].size);
+        }
+
+        if (can_release) {
+
+            linux_memory_reservation_t* reservation      = commit_map.entries[index].reservation;
+            const u64                   reservation_size = reservation->size;
+            const u64                   map_size         = reservation->commit_map_size;
+
+            linux_memory_sequence_begin(commit_map);
+            (void)memmove(
+                &commit_map.entries[index],
+                &commit_map.entries[index + 1],
+                (commit_map.count - index - 1) * sizeof(linux_memory_reservation_entry_t));
+            commit_map.count -= 1;
+            linux_memory_sequence_end(commit_map);
+
+            result  = (munmap(start,              reservation_size) == 0);
+            result &= (munmap((void*)reservation, map_size)         == 0);
+        }
+
+        (void)pthread_mutex_unlock(&commit_map.mutex);
+        return(result);
+    }
+
+    SLD_API_OS_FUNC void*
+    linux_memory_commit(
+        void*     start,
+        const u64 size) {
+
+        linux_memory_reservation_t* reservation = linux_memory_reservation_find((addr)start);
+        if (reservation == NULL) return(NULL);
+
+        // commit whole pages, the same way VirtualAlloc rounds the range
+        const addr page_mask    = (addr)(reservation->page_size - 1);
+        const addr commit_start = ((addr)start)                & ~page_mask;
+        const addr commit_end   = ((addr)start + size + page_mask) & ~page_mask;
+        const addr reserve_end  = reservation->start + reservation->size;
+        if (commit_end > reserve_end) return(NULL);
+
+        const int result = mprotect(
+            (void*)commit_start,
+            (commit_end - commit_start),
+            PROT_READ | PROT_WRITE
+        );
+        if (result != 0) return(NULL);
+
+        linux_memory_commit_map_set(reservation, commit_start, (commit_end - commit_start), true);
+        return(start);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_memory_decommit(
+        void*     start,
+        const u64 size) {
+
+        linux_memory_reservation_t* reservation = linux_memory_reservation_find((addr)start);
+        if (reservation == NULL) return(false);
+
+        const addr page_mask      = (addr)(reservation->page_size - 1);
+        const addr decommit_start = ((addr)start)                & ~page_mask;
+        const addr decommit_end   = ((addr)start + size + page_mask) & ~page_mask;
+        const addr reserve_end    = reservation->start + reservation->size;
+        const u64  decommit_size  = (decommit_end - decommit_start);
+        if (decommit_end > reserve_end) return(false);
+
+        // drop the physical pages first, then make the range
+        // inaccessible again so stale pointers fault like they do on win32.
+        // older kernels refuse MADV_DONTNEED on hugetlb ranges, in which
+        // case the pages stay resident but the range still decommits
+        (void)madvise((void*)decommit_start, decommit_size, MADV_DONTNEED);
+        const bool result = (mprotect((void*)decommit_start, decommit_size, PROT_NONE) == 0);
+
+        if (result) {
+            linux_memory_commit_map_set(reservation, decommit_start, decommit_size, false);
+        }
+        return(result);
+    }
+
+    SLD_API_OS_FUNC u64
+    linux_memory_align_to_page(
+        const u64 size) {
+
+        const u64 size_aligned = size_align_pow_2(size, linux_memory_page_size());
+        return(size_aligned);
+    }
+
+    SLD_API_OS_FUNC u64
+    linux_memory_align_to_granularity(
+        const u64 size) {
+
+        // mmap works on page boundaries, there is no
+        // separate allocation granularity like on win32
+        const u64 size_aligned = size_align_pow_2(size, linux_memory_page_size());
+        return(size_aligned);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_memory_is_reserved(
+        void* start) {
+
+        if (!start) return(false);
+
+        const linux_memory_reservation_t* reservation = linux_memory_reservation_find((addr)start);
+        if (reservation == NULL) return(false);
+
+        const bool is_reserved = !linux_memory_commit_map_test(reservation, (addr)start);
+        return(is_reserved);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_memory_is_committed(
+        void* start) {
+
+        if (!start) return(false);
+
+        const linux_memory_reservation_t* reservation = linux_memory_reservation_find((addr)start);
+        if (reservation == NULL) return(false);
+
+        const bool is_committed = linux_memory_commit_map_test(reservation, (addr)start);
+        return(is_committed);
+    }
+
+    SLD_API_OS_FUNC void*
+    linux_memory_map_mirrored(
+        const u64 size) {
+
+        // the size has to be whole pages so the second view lines up
+        if (size == 0 || (size & (linux_memory_page_size() - 1)) != 0) return(NULL);
+
+        // an anonymous file gives us physical pages we can map twice
+        const int fd = memfd_create("sld-mirrored", MFD_CLOEXEC);
+        if (fd < 0) return(NULL);
+
+        void* memory = MAP_FAILED;
+        if (ftruncate(fd, (off_t)size) == 0) {
+
+            // reserve both halves in one go so nothing else can land
+            // in between, then map the file over each half
+            memory = mmap(NULL, (size * 2), PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (memory != MAP_FAILED) {
+
+                void* first  = mmap(memory,                          size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+                void* second = mmap((void*)((addr)memory + size), size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+
+                const bool is_mapped = (first == memory && second == (void*)((addr)memory + size));
+                if (!is_mapped) {
+                    (void)munmap(memory, (size * 2));
+                    memory = MAP_FAILED;
+                }
+            }
+        }
+
+        // the mappings keep the file alive
+        (void)close(fd);
+        return((memory != MAP_FAILED) ? memory : NULL);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_memory_unmap_mirrored(
+        void*     start,
+        const u64 size) {
+
+        if (!start) return(false);
+        const bool result = (munmap(start, (size * 2)) == 0);
+        return(result);
+    }
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_INTERNAL u64
+    linux_memory_page_size(
+        void) {
+
+        static const u64 page_size = (u64)sysconf(_SC_PAGESIZE);
+        return(page_size);
+    }
+
+    SLD_API_OS_INTERNAL bool
+    linux_memory_thp_is_enabled(
+        void) {
+
+        c8 buffer[64] = {0};
+
+        const int file = open("/sys/kernel/mm/transparent_hugepage/enabled", O_RDONLY);
+        if (file < 0) return(false);
+
+        const ssize_t length = read(file, buffer, sizeof(buffer) - 1);
+        (void)close(file);
+
+        // the active mode is the one in brackets, e.g. "always [madvise] never"
+        const bool is_enabled = (length > 0) && (strstr(buffer, "[never]") == NULL);
+        return(is_enabled);
+    }
+
+    SLD_API_OS_INTERNAL void*
+    linux_memory_reserve_hugetlb(
+        void*     start,
+        const u64 size,
+        const u64 huge_page_size) {
+
+        const int huge_page_flag = (huge_page_size == OS_MEMORY_PAGE_SIZE_1GB)
+            ? MAP_HUGE_1GB
+            : MAP_HUGE_2MB;
+
+        // no MAP_NORESERVE here, the kernel has to claim the pages from the
+        // hugetlb pool up front. if the pool is too small we find out now
+        // instead of with a SIGBUS the first time a committed page is touched
+        const u64 size_aligned = size_align_pow_2(size, huge_page_size);
+        void*     memory       = mmap(
+            start,
+            size_aligned,
+            PROT_NONE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | huge_page_flag,
+            -1,
+            0
+        );
+        if (memory == MAP_FAILED) return(NULL);
+
+        bool is_valid = (start == NULL || memory == start);
+        if (is_valid) is_valid = linux_memory_reservation_add((addr)memory, size_aligned, huge_page_size);
+        if (!is_valid) {
+            (void)munmap(memory, size_aligned);
+            return(NULL);
+        }
+
+        return(memory);
+    }
+
+    SLD_API_OS_INTERNAL void*
+    linux_memory_reserve_thp(
+        void*     start,
+        const u64 size) {
+
+        const u64 huge_page_size = OS_MEMORY_PAGE_SIZE_2MB;
+        const u64 huge_page_mask = huge_page_size - 1;
+
+        static const bool is_enabled = linux_memory_thp_is_enabled();
+
+        bool can_reserve = true;
+        can_reserve &= is_enabled;
+        can_reserve &= (((addr)start & huge_page_mask) == 0);
+        if (!can_reserve) return(NULL);
+
+        // khugepaged only collapses aligned 2MB ranges, so without a fixed
+        // start we over-reserve by one huge page and trim both ends
+        const u64 size_aligned = size_align_pow_2(size, huge_page_size);
+        const u64 size_padded  = (start == NULL) ? (size_aligned + huge_page_size) : size_aligned;
+        void*     memory       = mmap(
+            start,
+            size_padded,
+            PROT_NONE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+            -1,
+            0
+        );
+        if (memory == MAP_FAILED) return(NULL);
+
+        const addr padded_start  = (addr)memory;
+        const addr aligned_start = (padded_start + huge_page_mask) & ~(addr)huge_page_mask;
+        const addr aligned_end   = aligned_start + size_aligned;
+        const addr padded_end    = padded_start  + size_padded;
+        if (aligned_start != padded_start) (void)munmap((void*)padded_start, aligned_start - padded_start);
+        if (aligned_end   != padded_end)   (void)munmap((void*)aligned_end,  padded_end    - aligned_end);
+
+        // the commit map stays at base page granularity, only
+        // the backing pages change once the range is touched
+        bool is_valid = (start == NULL || (void*)aligned_start == start);
+        if (is_valid) is_valid = (madvise((void*)aligned_start, size_aligned, MADV_HUGEPAGE) == 0);
+        if (is_valid) is_valid = linux_memory_reservation_add(aligned_start, size_aligned, linux_memory_page_size());
+        if (!is_valid) {
+            (void)munmap((void*)aligned_start, size_aligned);
+            return(NULL);
+        }
+
+        return((void*)aligned_start);
+    }
+
+    SLD_API_OS_INTERNAL u32
+    linux_memory_reservation_search(
+        const linux_memory_reservation_entry_t* entries,
+        const u32                               count,
+        const addr                              address) {
+
+        // the last reservation starting at or before the address
+        u32 low  = 0;
+        u32 high = count;
+        while (low < high) {
+            const u32 middle = low + ((high - low) / 2);
+            if (entries[middle].start <= address) low  = middle + 1;
+            else                                  high = middle;
+        }
+        if (low == 0) return(count);
+
+        const linux_memory_reservation_entry_t& entry = entries[low - 1];
+        const bool is_inside = (address < (entry.start + (addr)entry.size));
+        return(is_inside ? (low - 1) : count);
+    }
+
+    SLD_API_OS_INTERNAL linux_memory_reservation_t*
+    linux_memory_reservation_find(
+        const addr address) {
+
+        linux_memory_commit_map_t& commit_map = _linux_memory_commit_map;
+
+        linux_memory_reservation_t* reservation = NULL;
+        u32                         sequence    = 0;
+        do {
+            // an odd sequence means a change is in progress
+            sequence = __atomic_load_n(&commit_map.sequence, __ATOMIC_ACQUIRE);
+            if ((sequence & 1) != 0) continue;
+
+            const linux_memory_reservation_entry_t* entries = __atomic_load_n(&commit_map.entries, __ATOMIC_ACQUIRE);
+            const u32                               count   = __atomic_load_n(&commit_map.count,   __ATOMIC_ACQUIRE);
+            const u32                               index   = linux_memory_reservation_search(entries, count, address);
+            reservation = (index < count) ? entries[index].reservation : NULL;
+
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        } while (sequence != __atomic_load_n(&commit_map.sequence, __ATOMIC_RELAXED) || (sequence & 1) != 0);
+
+        return(reservation);
+    }
+
+    SLD_API_OS_INTERNAL bool
+    linux_memory_reservation_add(
+        const addr start,
+        const u64  size,
+        const u64  page_size) {
+
+        linux_memory_commit_map_t& commit_map = _linux_memory_commit_map;
+
+        // the record, then one bit per page rounded
+        // up to whole words, rounded up to whole pages
+        const u64 page_count  = (size + page_size - 1) / page_size;
+        const u64 word_count  = (page_count + 63) / 64;
+        const u64 record_size = size_align_pow_2(sizeof(linux_memory_reservation_t), sizeof(u64));
+        const u64 map_size    = size_align_pow_2(record_size + (word_count * sizeof(u64)), linux_memory_page_size());
+
+        void* map_data = mmap(
+            NULL,
+            map_size,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS,
+            -1,
+            0
+        );
+        if (map_data == MAP_FAILED) return(false);
+
+        linux_memory_reservation_t* reservation = (linux_memory_reservation_t*)map_data;
+        reservation->start           = start;
+        reservation->size            = size;
+        reservation->page_size       = page_size;
+        reservation->commit_map      = (u64*)((addr)map_data + record_size);
+        reservation->commit_map_size = map_size;
+
+        (void)pthread_mutex_lock(&commit_map.mutex);
+
+        bool is_added = (commit_map.count < commit_map.capacity);
+        if (!is_added) is_added = linux_memory_reservation_grow(commit_map);
+        if (is_added) {
+
+            // the index never holds overlapping ranges, so the
+            // insert point is after every reservation below the start
+            u32 index = commit_map.count;
+            while (index > 0 && commit_map.entries[index - 1].start > start) --index;
+
+            linux_memory_sequence_begin(commit_map);
+            (void)memmove(
+                &commit_map.entries[index + 1],
+                &commit_map.entries[index],
+                (commit_map.count - index) * sizeof(linux_memory_reservation_entry_t));
+            commit_map.entries[index].start       = start;
+            commit_map.entries[index].size        = size;
+            commit_map.entries[index].reservation = reservation;
+            commit_map.count += 1;
+            linux_memory_sequence_end(commit_map);
+        }
+
+        (void)pthread_mutex_unlock(&commit_map.mutex);
+
+        if (!is_added) (void)munmap(map_data, map_size);
+        return(is_added);
+    }
+
+    SLD_API_OS_INTERNAL bool
+    linux_memory_reservation_grow(
+        linux_memory_commit_map_t& commit_map) {
+
+        const u32 capacity = (commit_map.capacity == 0)
+            ? SLD_LINUX_MEMORY_RESERVATION_COUNT_MIN
+            : (commit_map.capacity * 2);
+        const u64 size = size_align_pow_2((u64)capacity * sizeof(linux_memory_reservation_entry_t), linux_memory_page_size());
+
+        void* entries = mmap(
+            NULL,
+            size,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS,
+            -1,
+            0
+        );
+        if (entries == MAP_FAILED) return(false);
+
+        // the old index stays mapped, a lookup that loaded it
+        // finds the sequence moved and searches this one instead
+        if (commit_map.count != 0) {
+            (void)memcpy(entries, commit_map.entries, commit_map.count * sizeof(linux_memory_reservation_entry_t));
+        }
+
+        linux_memory_sequence_begin(commit_map);
+        __atomic_store_n(&commit_map.entries, (linux_memory_reservation_entry_t*)entries, __ATOMIC_RELEASE);
+        commit_map.capacity = (u32)(size / sizeof(linux_memory_reservation_entry_t));
+        linux_memory_sequence_end(commit_map);
+        return(true);
+    }
+
+    SLD_API_OS_INTERNAL void
+    linux_memory_sequence_begin(
+        linux_memory_commit_map_t& commit_map) {
+
+        __atomic_store_n(&commit_map.sequence, commit_map.sequence + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+
+    SLD_API_OS_INTERNAL void
+    linux_memory_sequence_end(
+        linux_memory_commit_map_t& commit_map) {
+
+        __atomic_store_n(&commit_map.sequence, commit_map.sequence + 1, __ATOMIC_RELEASE);
+    }
+
+    SLD_API_OS_INTERNAL void
+    linux_memory_commit_map_set(
+        linux_memory_reservation_t* reservation,
+        const addr                  start,
+        const u64                   size,
+        const bool                  is_committed) {
+
+        const u64 page_first = (start - reservation->start) / reservation->page_size;
+        const u64 page_last  = page_first + (size / reservation->page_size);
+
+        u64 page = page_first;
+        while (page < page_last) {
+
+            // set as many bits as we can in the current word
+            const u64 word_index = (page / 64);
+            const u64 bit_first  = (page % 64);
+            const u64 bit_count  = ((page_last - page) < (64 - bit_first))
+                ? (page_last - page)
+                : (64 - bit_first);
+            const u64 bit_mask = (bit_count == 64)
+                ? ~(u64)0
+                : (((u64)1 << bit_count) - 1) << bit_first;
+
+            u64* word = &reservation->commit_map[word_index];
+            if (is_committed) (void)__atomic_fetch_or  (word,  bit_mask, __ATOMIC_RELEASE);
+            else              (void)__atomic_fetch_and (word, ~bit_mask, __ATOMIC_RELEASE);
+
+            page += bit_count;
+        }
+    }
+
+    SLD_API_OS_INTERNAL bool
+    linux_memory_commit_map_test(
+        const linux_memory_reservation_t* reservation,
+        const addr                        start) {
+
+        const u64  page         = (start - reservation->start) / reservation->page_size;
+        const u64  word         = __atomic_load_n(&reservation->commit_map[page / 64], __ATOMIC_ACQUIRE);
+        const bool is_committed = ((word >> (page % 64)) & 1);
+        return(is_committed);
+    }
+};
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <pthread.h>
+#include <errno.h>
+#include "sld-os.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // DECLARATIONS
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_INTERNAL const os_thread_error_t linux_thread_get_error_code (const int linux_error);
+    SLD_API_OS_INTERNAL void*                   linux_thread_main           (void* parameter);
+
+    //-------------------------------------------------------------------
+    // OS API
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_FUNC const os_thread_error_t
+    linux_thread_create(
+        os_thread_handle_t&  thread_handle,
+        os_thread_context_t& context) {
+
+        thread_handle.val = NULL;
+        if (context.function == NULL) return(linux_thread_get_error_code(EINVAL));
+
+        pthread_t thread;
+        const int linux_error = pthread_create(&thread, NULL, linux_thread_main, (void*)&context);
+        if (linux_error == 0) {
+            thread_handle.val = (vptr)thread;
+        }
+        return(linux_thread_get_error_code(linux_error));
+    }
+
+    SLD_API_OS_FUNC const os_thread_error_t
+    linux_thread_join(
+        const os_thread_handle_t thread_handle) {
+
+        if (thread_handle.val == NULL) return(linux_thread_get_error_code(EINVAL));
+
+        const pthread_t thread      = (pthread_t)thread_handle.val;
+        const int       linux_error = pthread_join(thread, NULL);
+        return(linux_thread_get_error_code(linux_error));
+    }
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_INTERNAL void*
+    linux_thread_main(
+        void* parameter) {
+
+        os_thread_context_t* context = (os_thread_context_t*)parameter;
+        context->function(*context);
+        return(NULL);
+    }
+
+    SLD_API_OS_INTERNAL const os_thread_error_t
+    linux_thread_get_error_code(
+        const int linux_error) {
+
+        os_thread_error_t error;
+
+        switch (linux_error) {
+            case (0):      { error.val = os_thread_error_e_success;      return(error); }
+            case (EINVAL): { error.val = os_thread_error_e_invalid_args; return(error); }
+            case (ESRCH):  { error.val = os_thread_error_e_invalid_args; return(error); }
+            default:       { error.val = os_thread_error_e_unknown;      return(error); }
+        }
+    }
+};
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "sld-os.hpp"
+
+#include "sld-linux-memory.cpp"
+#include "sld-linux-file.cpp"
+#include "sld-linux-thread.cpp"
+
+namespace sld {
+
+    //----------------
+    // memory
+    //----------------
+
+    os_memory_reserve_f              os_memory_reserve              = linux_memory_reserve;
+    os_memory_reserve_huge_f         os_memory_reserve_huge         = linux_memory_reserve_huge;
+    os_memory_release_f              os_memory_release              = linux_memory_release;
+    os_memory_commit_f               os_memory_commit               = linux_memory_commit;
+    os_memory_decommit_f             os_memory_decommit             = linux_memory_decommit;
+    os_memory_align_to_page_f        os_memory_align_to_page        = linux_memory_align_to_page;
+    os_memory_align_to_granularity_f os_memory_align_to_granularity = linux_memory_align_to_granularity;
+    os_memory_is_reserved_f          os_memory_is_reserved          = linux_memory_is_reserved;
+    os_memory_is_committed_f         os_memory_is_committed         = linux_memory_is_committed;
+    os_memory_map_mirrored_f         os_memory_map_mirrored         = linux_memory_map_mirrored;
+    os_memory_unmap_mirrored_f       os_memory_unmap_mirrored       = linux_memory_unmap_mirrored;
+
+    //----------------
+    // files
+    //----------------
+
+    os_file_map_read_f               os_file_map_read               = linux_file_map_read;
+    os_file_unmap_f                  os_file_unmap                  = linux_file_unmap;
+    os_file_map_prefetch_f           os_file_map_prefetch           = linux_file_map_prefetch;
+
+    //----------------
+    // threads
+    //----------------
+
+    os_thread_create_f               os_thread_create               = linux_thread_create;
+    os_thread_join_f                 os_thread_join                 = linux_thread_join;
+};
\ No newline at end of file
@@ -0,0 +1,524 @@
+#pragma once
+
+#include "sld-heap.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_INTERNAL_INLINE u64          heap_node_size           (const heap_node_t* node)                             { return(node->size & ~(HEAP_NODE_FLAG_FREE | HEAP_NODE_FLAG_PREV_FREE)); }
+    SLD_INTERNAL_INLINE bool         heap_node_is_free        (const heap_node_t* node)                             { return((node->size & HEAP_NODE_FLAG_FREE)      != 0);                   }
+    SLD_INTERNAL_INLINE bool         heap_node_is_prev_free   (const heap_node_t* node)                             { return((node->size & HEAP_NODE_FLAG_PREV_FREE) != 0);                   }
+    SLD_INTERNAL_INLINE bool         heap_node_is_last        (const heap_node_t* node)                             { return(heap_node_size(node) == 0);                                      }
+    SLD_INTERNAL_INLINE void         heap_node_set_size       (heap_node_t*       node, const u64 size)             { node->size = size | (node->size & (HEAP_NODE_FLAG_FREE | HEAP_NODE_FLAG_PREV_FREE)); }
+    SLD_INTERNAL_INLINE void         heap_node_set_free       (heap_node_t*       node, const bool is_free)         { node->size = (is_free) ? (node->size | HEAP_NODE_FLAG_FREE)      : (node->size & ~HEAP_NODE_FLAG_FREE);      }
+    SLD_INTERNAL_INLINE void         heap_node_set_prev_free  (heap_node_t*       node, const bool is_free)         { node->size = (is_free) ? (node->size | HEAP_NODE_FLAG_PREV_FREE) : (node->size & ~HEAP_NODE_FLAG_PREV_FREE); }
+    SLD_INTERNAL_INLINE heap_node_t* heap_node_from_offset    (const void*        ptr,  const s64 offset)           { return((heap_node_t*)((addr)ptr + offset));                             }
+
+    SLD_INTERNAL_INLINE heap_node_t*
+    heap_node_next(
+        const heap_node_t* node) {
+
+        // the next node header starts in the last word of this node's data
+        heap_node_t* next = heap_node_from_offset(
+            heap_node_get_data(node),
+            (s64)heap_node_size(node) - (s64)HEAP_NODE_OVERHEAD);
+
+        assert(!heap_node_is_last(node));
+        return(next);
+    }
+
+    SLD_INTERNAL_INLINE heap_node_t*
+    heap_node_link_next(
+        heap_node_t* node) {
+
+        heap_node_t* next   = heap_node_next(node);
+        next->prev_physical = node;
+        return(next);
+    }
+
+    SLD_INTERNAL_INLINE void
+    heap_node_mark_free(
+        heap_node_t* node) {
+
+        heap_node_t* next = heap_node_link_next(node);
+        heap_node_set_prev_free (next, true);
+        heap_node_set_free      (node, true);
+    }
+
+    SLD_INTERNAL_INLINE void
+    heap_node_mark_used(
+        heap_node_t* node) {
+
+        heap_node_t* next = heap_node_next(node);
+        heap_node_set_prev_free (next, false);
+        heap_node_set_free      (node, false);
+    }
+
+    SLD_INTERNAL_INLINE void
+    heap_mapping_insert(
+        const u64 size,
+        u32&      fl,
+        u32&      sl) {
+
+        if (size < HEAP_SMALL_NODE_SIZE) {
+
+            // small sizes share the first bin, split linearly
+            fl = 0;
+            sl = (u32)(size / (HEAP_SMALL_NODE_SIZE / HEAP_SL_INDEX_COUNT));
+        }
+        else {
+            const u32 fl_bit = bit_scan_reverse(size);
+            sl = (u32)(size >> (fl_bit - HEAP_SL_INDEX_COUNT_LOG2)) ^ HEAP_SL_INDEX_COUNT;
+            fl = (fl_bit - (HEAP_FL_INDEX_SHIFT - 1));
+        }
+    }
+
+    SLD_INTERNAL_INLINE void
+    heap_mapping_search(
+        const u64 size,
+        u32&      fl,
+        u32&      sl) {
+
+        // round up to the next bin so any node in it is big enough
+        u64 size_rounded = size;
+        if (size >= HEAP_SMALL_NODE_SIZE) {
+            const u64 round = ((u64)1 << (bit_scan_reverse(size) - HEAP_SL_INDEX_COUNT_LOG2)) - 1;
+            size_rounded += round;
+        }
+        heap_mapping_insert(size_rounded, fl, sl);
+    }
+
+    SLD_INTERNAL heap_node_t*
+    heap_root_search_suitable(
+        heap_root_t& root,
+        u32&         fl,
+        u32&         sl) {
+
+        // look for a non-empty list in this first level at or above sl
+        u32 sl_map = root.sl_bitmap[fl] & (~0U << sl);
+        if (sl_map == 0) {
+
+            // nothing left on this level, move up to the next one with space
+            const u32 fl_map = (fl + 1 < 32) ? (root.fl_bitmap & (~0U << (fl + 1))) : 0;
+            if (fl_map == 0) return(NULL);
+
+            fl     = bit_scan_forward(fl_map);
+            sl_map = root.sl_bitmap[fl];
+        }
+        assert(sl_map != 0);
+        sl = bit_scan_forward(sl_map);
+
+        return(root.free_lists[fl][sl]);
+    }
+
+    SLD_INTERNAL void
+    heap_root_remove_free(
+        heap_t*      heap,
+        heap_node_t* node,
+        const u32    fl,
+        const u32    sl) {
+
+        heap_root_t& root = heap->root;
+        heap_node_t* prev = node->prev_free;
+        heap_node_t* next = node->next_free;
+        assert(prev && next);
+        next->prev_free = prev;
+        prev->next_free = next;
+
+        // if this was the head of its list, clear the bitmaps once it empties
+        if (root.free_lists[fl][sl] == node) {
+            root.free_lists[fl][sl] = next;
+            if (next == &root.null_node) {
+                root.sl_bitmap[fl] &= ~(1U << sl);
+                if (root.sl_bitmap[fl] == 0) {
+                    root.fl_bitmap &= ~(1U << fl);
+                }
+            }
+        }
+
+        --heap->stats.node_count_free;
+        heap->stats.size_free -= heap_node_size(node);
+    }
+
+    SLD_INTERNAL void
+    heap_root_insert_free(
+        heap_t*      heap,
+        heap_node_t* node,
+        const u32    fl,
+        const u32    sl) {
+
+        heap_root_t& root    = heap->root;
+        heap_node_t* current = root.free_lists[fl][sl];
+        assert(current);
+
+        node->next_free    = current;
+        node->prev_free    = &root.null_node;
+        current->prev_free = node;
+
+        root.free_lists[fl][sl] = node;
+        root.fl_bitmap         |= (1U << fl);
+        root.sl_bitmap[fl]     |= (1U << sl);
+
+        ++heap->stats.node_count_free;
+        heap->stats.size_free += heap_node_size(node);
+    }
+
+    SLD_INTERNAL_INLINE void
+    heap_node_remove(
+        heap_t*      heap,
+        heap_node_t* node) {
+
+        u32 fl, sl;
+        heap_mapping_insert   (heap_node_size(node), fl, sl);
+        heap_root_remove_free (heap, node, fl, sl);
+    }
+
+    SLD_INTERNAL_INLINE void
+    heap_node_insert(
+        heap_t*      heap,
+        heap_node_t* node) {
+
+        u32 fl, sl;
+        heap_mapping_insert   (heap_node_size(node), fl, sl);
+        heap_root_insert_free (heap, node, fl, sl);
+    }
+
+    SLD_INTERNAL_INLINE heap_node_t*
+    heap_node_split(
+        heap_node_t* node,
+        const u64    size) {
+
+        // the remainder starts in the last word of the first part's data
+        heap_node_t* remaining      = heap_node_from_offset(heap_node_get_data(node), (s64)size - (s64)HEAP_NODE_OVERHEAD);
+        const u64    remaining_size = heap_node_size(node) - (size + HEAP_NODE_OVERHEAD);
+        assert(remaining_size >= HEAP_NODE_SIZE_MIN);
+
+        remaining->size = 0;
+        heap_node_set_size  (remaining, remaining_size);
+        heap_node_set_size  (node,      size);
+        heap_node_mark_free (remaining);
+        return(remaining);
+    }
+
+    SLD_INTERNAL_INLINE heap_node_t*
+    heap_node_absorb(
+        heap_node_t* prev,
+        heap_node_t* node) {
+
+        assert(!heap_node_is_last(prev));
+        heap_node_set_size  (prev, heap_node_size(prev) + heap_node_size(node) + HEAP_NODE_OVERHEAD);
+        heap_node_link_next (prev);
+        return(prev);
+    }
+
+    SLD_INTERNAL_INLINE heap_node_t*
+    heap_node_merge_prev(
+        heap_t*      heap,
+        heap_node_t* node) {
+
+        heap_node_t* merged = node;
+        if (heap_node_is_prev_free(node)) {
+
+            heap_node_t* prev = node->prev_physical;
+            assert(prev && heap_node_is_free(prev));
+            heap_node_remove(heap, prev);
+            merged = heap_node_absorb(prev, node);
+        }
+        return(merged);
+    }
+
+    SLD_INTERNAL_INLINE heap_node_t*
+    heap_node_merge_next(
+        heap_t*      heap,
+        heap_node_t* node) {
+
+        heap_node_t* next = heap_node_next(node);
+        if (heap_node_is_free(next)) {
+
+            assert(!heap_node_is_last(node));
+            heap_node_remove(heap, next);
+            heap_node_absorb(node, next);
+        }
+        return(node);
+    }
+
+    SLD_INTERNAL_INLINE void
+    heap_node_trim_free(
+        heap_t*      heap,
+        heap_node_t* node,
+        const u64    size) {
+
+        // give the tail back to the heap if it can hold a node of its own
+        const bool can_split = (heap_node_size(node) >= (sizeof(heap_node_t) + size));
+        if (can_split) {
+
+            heap_node_t* remaining = heap_node_split(node, size);
+            heap_node_link_next     (node);
+            heap_node_set_prev_free (remaining, true);
+            heap_node_insert        (heap, remaining);
+        }
+    }
+
+    SLD_INTERNAL_INLINE u64
+    heap_adjust_size(
+        const heap_t* heap,
+        const u64     size) {
+
+        u64 size_adjusted = 0;
+        if (size != 0) {
+
+            size_adjusted = size_align_pow_2(size, heap->granularity);
+            if (size_adjusted < HEAP_NODE_SIZE_MIN) size_adjusted = HEAP_NODE_SIZE_MIN;
+            if (size_adjusted > HEAP_NODE_SIZE_MAX) size_adjusted = 0;
+        }
+        return(size_adjusted);
+    }
+
+    SLD_INTERNAL void
+    heap_root_init(
+        heap_root_t& root) {
+
+        root.null_node.next_free = &root.null_node;
+        root.null_node.prev_free = &root.null_node;
+        root.fl_bitmap           = 0;
+
+        for (
+            u32 fl = 0;
+                fl < HEAP_FL_INDEX_COUNT;
+              ++fl) {
+
+            root.sl_bitmap[fl] = 0;
+            for (
+                u32 sl = 0;
+                    sl < HEAP_SL_INDEX_COUNT;
+                  ++sl) {
+
+                root.free_lists[fl][sl] = &root.null_node;
+            }
+        }
+    }
+
+    SLD_INTERNAL void
+    heap_pool_init(
+        heap_t* heap) {
+
+        // the first node starts one word before the pool so its prev_physical
+        // lands outside the pool, it is never read since nothing precedes it.
+        // the pool ends with a zero sized sentinel that is never free
+        const memory_t& pool      = heap->pool;
+        const u64       pool_size = (pool.size - (2 * HEAP_NODE_OVERHEAD)) & ~(u64)(heap->granularity - 1);
+
+        heap_node_t* node = heap_node_from_offset(pool.ptr, -(s64)HEAP_NODE_OVERHEAD);
+        node->size = pool_size;
+        heap_node_set_free      (node, true);
+        heap_node_set_prev_free (node, false);
+        heap_node_insert        (heap, node);
+
+        heap_node_t* sentinel = heap_node_link_next(node);
+        sentinel->size = 0;
+        heap_node_set_free      (sentinel, false);
+        heap_node_set_prev_free (sentinel, true);
+
+        heap->stats.size_pool = pool_size;
+    }
+
+    //-------------------------------------------------------------------
+    // API
+    //-------------------------------------------------------------------
+
+    SLD_API const u64
+    heap_memory_size(
+        const u64 heap_size_min) {
+
+        const u64 size_header = size_align_pow_2(sizeof(heap_t), HEAP_ALIGN_SIZE);
+        const u64 size_pool   = size_align_pow_2(heap_size_min,  HEAP_ALIGN_SIZE) + (2 * HEAP_NODE_OVERHEAD);
+        const u64 size_total  = (size_header + size_pool);
+        return(size_total);
+    }
+
+    SLD_API heap_t*
+    heap_init(
+        const memory_t& memory,
+        const u64       granularity) {
+
+        // the granularity rounds every node, it has to keep the headers aligned
+        const u64 granularity_aligned = (granularity > HEAP_ALIGN_SIZE)
+            ? size_round_up_pow2(granularity)
+            : HEAP_ALIGN_SIZE;
+
+        const addr memory_start = (addr)size_align_pow_2(memory.addr, HEAP_ALIGN_SIZE);
+        const addr memory_end   = (memory.addr + memory.size);
+        const addr pool_start   = (addr)size_align_pow_2(memory_start + sizeof(heap_t), HEAP_ALIGN_SIZE);
+
+        bool can_init = true;
+        can_init &= memory_is_valid(memory);
+        can_init &= (pool_start < memory_end);
+        can_init &= ((u64)(memory_end - pool_start) >= (HEAP_NODE_SIZE_MIN + (2 * HEAP_NODE_OVERHEAD)));
+        if (!can_init) return(NULL);
+
+        heap_t* heap = (heap_t*)memory_start;
+        heap->memory      = memory;
+        heap->granularity = granularity_aligned;
+        heap->pool.addr   = pool_start;
+        heap->pool.size   = (memory_end - pool_start);
+
+        // a single node can't span more than the largest bin
+        const u64 pool_size_max = (HEAP_NODE_SIZE_MAX + (2 * HEAP_NODE_OVERHEAD));
+        if (heap->pool.size > pool_size_max) heap->pool.size = pool_size_max;
+
+        const bool did_reset = heap_reset(heap);
+        assert(did_reset);
+        return(heap);
+    }
+
+    SLD_API bool
+    heap_reset(
+        heap_t* heap) {
+
+        bool can_reset = true;
+        can_reset &= (heap != NULL);
+        can_reset &= memory_is_valid(heap->pool);
+        if (!can_reset) return(false);
+
+        memset(&heap->stats, 0, sizeof(heap_stats_t));
+        heap_root_init (heap->root);
+        heap_pool_init (heap);
+        return(true);
+    }
+
+    SLD_API bool
+    heap_validate(
+        const heap_t* heap) {
+
+        bool is_valid = (heap != NULL);
+        if (!is_valid) return(false);
+
+        is_valid &= memory_is_valid (heap->memory);
+        is_valid &= memory_is_valid (heap->pool);
+        is_valid &= size_is_pow_2   (heap->granularity);
+        is_valid &= (heap->stats.size_used <= heap->stats.size_pool);
+        is_valid &= (heap->stats.size_free <= heap->stats.size_pool);
+
+        // every bin has to agree with its bitmap bits
+        const heap_root_t& root = heap->root;
+        for (
+            u32 fl = 0;
+                fl < HEAP_FL_INDEX_COUNT && is_valid;
+              ++fl) {
+
+            const bool fl_bit = ((root.fl_bitmap    >> fl) & 1);
+            is_valid &= (fl_bit == (root.sl_bitmap[fl] != 0));
+
+            for (
+                u32 sl = 0;
+                    sl < HEAP_SL_INDEX_COUNT && is_valid;
+                  ++sl) {
+
+                const heap_node_t* node   = root.free_lists[fl][sl];
+                const bool         sl_bit = ((root.sl_bitmap[fl] >> sl) & 1);
+                const bool         empty  = (node == &root.null_node);
+                is_valid &= (sl_bit == !empty);
+                is_valid &= (empty  || heap_node_is_free(node));
+            }
+        }
+
+        return(is_valid);
+    }
+
+    SLD_API heap_node_t*
+    heap_insert(
+        heap_t*   heap,
+        const u32 size) {
+
+        assert(heap != NULL);
+
+        const u64 size_adjusted = heap_adjust_size(heap, size);
+        if (size_adjusted == 0) return(NULL);
+
+        // find a bin big enough for any node in it
+        u32 fl, sl;
+        heap_mapping_search(size_adjusted, fl, sl);
+        if (fl >= HEAP_FL_INDEX_COUNT) return(NULL);
+
+        heap_node_t* node = heap_root_search_suitable(heap->root, fl, sl);
+        if (node == NULL || node == &heap->root.null_node) return(NULL);
+
+        // take it off the free list and give back what we don't need
+        assert(heap_node_size(node) >= size_adjusted);
+        heap_root_remove_free (heap, node, fl, sl);
+        heap_node_trim_free   (heap, node, size_adjusted);
+        heap_node_mark_used   (node);
+
+        heap_stats_t& stats = heap->stats;
+        stats.size_used += heap_node_size(node);
+        stats.node_count_used++;
+        stats.insert_count++;
+        if (stats.size_used > stats.size_used_peak) stats.size_used_peak = stats.size_used;
+
+        return(node);
+    }
+
+    SLD_API bool
+    heap_remove(
+        heap_t*      heap,
+        heap_node_t* node) {
+
+        bool can_remove = true;
+        can_remove &= (heap != NULL);
+        can_remove &= (node != NULL);
+        can_remove &= ((addr)node >= (heap->pool.addr  - (addr)HEAP_NODE_OVERHEAD));
+        can_remove &= ((addr)node <  (heap->pool.addr  + (addr)heap->pool.size));
+        if (!can_remove) return(false);
+
+        // catch double frees
+        if (heap_node_is_free(node)) return(false);
+
+        heap_stats_t& stats = heap->stats;
+        stats.size_used -= heap_node_size(node);
+        stats.node_count_used--;
+        stats.remove_count++;
+
+        // coalesce with both physical neighbours before binning
+        heap_node_mark_free(node);
+        node = heap_node_merge_prev (heap, node);
+        node = heap_node_merge_next (heap, node);
+        heap_node_insert(heap, node);
+        return(true);
+    }
+
+    SLD_API void
+    heap_get_stats(
+        const heap_t* heap,
+        heap_stats_t& stats) {
+
+        assert(heap != NULL);
+        stats = heap->stats;
+    }
+
+    SLD_API void*
+    heap_node_get_data(
+        const heap_node_t* node) {
+
+        void* data = (void*)((addr)node + HEAP_NODE_DATA_OFFSET);
+        return(data);
+    }
+
+    SLD_API u64
+    heap_node_get_size(
+        const heap_node_t* node) {
+
+        assert(node != NULL);
+        return(heap_node_size(node));
+    }
+
+    SLD_API heap_node_t*
+    heap_node_from_data(
+        const void* data) {
+
+        heap_node_t* node = (heap_node_t*)((addr)data - HEAP_NODE_DATA_OFFSET);
+        return(node);
+    }
+};
\ No newline at end of file
@@ -4,12 +4,30 @@
 #include "sld-arena.hpp"
 #include "sld-block-allocator.hpp"
 #include "sld-arena-allocator.hpp"
+#include "sld-slab-allocator.hpp"
+#include "sld-magazine-allocator.hpp"
+#include "sld-ring-buffer.hpp"
+#include "sld-heap.hpp"
+
+#include "sld-memory-heap.cpp"
 
 #include "sld-hash32.cpp"
+#include "sld-hash32c.cpp"
 #include "sld-hash128.cpp"
+#include "sld-hash-short.cpp"
+#include "sld-hash-file.cpp"
+#include "sld-core-hash-table.cpp"
+#include "sld-core-concurrent-hash-table.cpp"
+#include "sld-core-hash-filter.cpp"
 
-#include "sld-win32.cpp"
+#if defined(_WIN32)
+#   include "sld-win32.cpp"
+#elif defined(__linux__)
+#   include "sld-linux.cpp"
+#endif
 #include "sld-cstr.hpp"
+#include "sld-string-intern.cpp"
+#include "sld-core-chunk-store.cpp"
 #include "sld-wstr.hpp"
 #include "sld-single-linked-list.hpp"
 #include "sld-double-linked-list.hpp"
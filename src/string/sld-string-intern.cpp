@@ -0,0 +1,210 @@
+#pragma once
+
+#include "sld-string-intern.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_INTERNAL_INLINE const string_intern_entry_t*
+    string_intern_get_entry(
+        const string_intern_t& intern,
+        const u32              symbol) {
+
+        const string_intern_entry_t* entries = (const string_intern_entry_t*)arena_get_start(intern.entries);
+        const string_intern_entry_t* entry   = (symbol < intern.count) ? &entries[symbol] : NULL;
+        return(entry);
+    }
+
+    SLD_INTERNAL_INLINE hash128_t
+    string_intern_hash(
+        const cchar* chars,
+        const u32    length) {
+
+        hash_table_key_t key;
+        key.data   = (byte*)chars;
+        key.length = length;
+
+        const hash128_t hash = hash_table_hash_key(key);
+        return(hash);
+    }
+
+    //-------------------------------------------------------------------
+    // API
+    //-------------------------------------------------------------------
+
+    SLD_API bool
+    string_intern_reserve_os_memory(
+        string_intern_t& intern,
+        const u32        symbol_max,
+        const u64        size_chars) {
+
+        bool can_reserve = true;
+        can_reserve &= (symbol_max != 0);
+        can_reserve &= (symbol_max <  STRING_INTERN_SYMBOL_INVALID);
+        can_reserve &= (size_chars != 0);
+        if (!can_reserve) return(false);
+
+        intern.table          = {};
+        intern.table.capacity = STRING_INTERN_TABLE_CAPACITY_MIN;
+        intern.table.stride   = sizeof(u32);
+        const bool did_reserve = hash_table_allocator_reserve(intern.table, &intern.table_allocator, symbol_max);
+        if (!did_reserve) return(false);
+
+        const u64 size_entries = ((u64)symbol_max * sizeof(string_intern_entry_t));
+        intern.chars      = arena_reserve_os_memory(size_chars);
+        intern.entries    = arena_reserve_os_memory(size_entries + ARENA_COMMIT_CHUNK_DEFAULT);
+        intern.count      = 0;
+        intern.symbol_max = symbol_max;
+
+        const bool is_valid = string_intern_is_valid(intern);
+        if (!is_valid) string_intern_release_os_memory(intern);
+        return(is_valid);
+    }
+
+    SLD_API void
+    string_intern_release_os_memory(
+        string_intern_t& intern) {
+
+        hash_table_allocator_release(intern.table);
+        arena_allocator_release_os_memory(&intern.table_allocator);
+        if (intern.chars   != NULL) arena_release_os_memory(intern.chars);
+        if (intern.entries != NULL) arena_release_os_memory(intern.entries);
+
+        intern.chars      = NULL;
+        intern.entries    = NULL;
+        intern.count      = 0;
+        intern.symbol_max = 0;
+    }
+
+    SLD_API bool
+    string_intern_is_valid(
+        const string_intern_t& intern) {
+
+        bool is_valid = true;
+        is_valid &= (intern.chars   != NULL);
+        is_valid &= (intern.entries != NULL);
+        is_valid &= (intern.count   <= intern.symbol_max);
+        is_valid &= hash_table_validate(intern.table);
+        return(is_valid);
+    }
+
+    SLD_API u32
+    string_intern_find(
+        const string_intern_t& intern,
+        const cchar*           chars,
+        const u32              length) {
+
+        if (chars == NULL) return(STRING_INTERN_SYMBOL_INVALID);
+
+        hash_table_value_t value;
+        const hash128_t    hash     = string_intern_hash     (chars, length);
+        const bool         is_found = hash_table_search_hash (intern.table, hash, value);
+        const u32          symbol   = is_found ? *(const u32*)value.data : STRING_INTERN_SYMBOL_INVALID;
+        return(symbol);
+    }
+
+    SLD_API u32
+    string_intern_chars(
+        string_intern_t& intern,
+        const cchar*     chars,
+        const u32        length) {
+
+        bool can_intern = true;
+        can_intern &= string_intern_is_valid(intern);
+        can_intern &= (chars != NULL);
+        if (!can_intern) return(STRING_INTERN_SYMBOL_INVALID);
+
+        // the same string has the same hash, hand back the symbol it already has
+        hash_table_value_t value;
+        const hash128_t    hash     = string_intern_hash     (chars, length);
+        const bool         is_found = hash_table_search_hash (intern.table, hash, value);
+        if (is_found) {
+            const u32 symbol = *(const u32*)value.data;
+            assert(string_intern_get_length(intern, symbol) == length);
+            return(symbol);
+        }
+
+        if (intern.count == intern.symbol_max) return(STRING_INTERN_SYMBOL_INVALID);
+
+        // the symbol is the entry index, so a push or an insert that fails
+        // rolls both arenas back and the next symbol still lines up
+        arena_scope_t scope_chars   = arena_scope_begin(intern.chars);
+        arena_scope_t scope_entries = arena_scope_begin(intern.entries);
+
+        cchar*                 chars_copy = (cchar*)arena_push_bytes(intern.chars, (u64)length + 1);
+        string_intern_entry_t* entry      = arena_push_struct<string_intern_entry_t>(intern.entries);
+
+        const u32  symbol     = intern.count;
+        const bool did_push   = (chars_copy != NULL && entry != NULL);
+        const bool did_insert = did_push && hash_table_insert_hash(intern.table, (const byte*)&symbol, hash, value);
+        if (!did_insert) {
+            arena_scope_end(scope_entries);
+            arena_scope_end(scope_chars);
+            return(STRING_INTERN_SYMBOL_INVALID);
+        }
+
+        (void)memcpy(chars_copy, chars, length);
+        chars_copy[length] = CSTR_NULL_TERMINATOR;
+        entry->chars  = chars_copy;
+        entry->length = length;
+
+        ++intern.count;
+        return(symbol);
+    }
+
+    SLD_API u32
+    string_intern_cstr(
+        string_intern_t& intern,
+        const cstr_t*    cstr) {
+
+        if (!cstr_is_valid(cstr)) return(STRING_INTERN_SYMBOL_INVALID);
+
+        const u32 length = (u32)cstr_get_length    (cstr);
+        const u32 symbol = string_intern_chars     (intern, cstr->chars, length);
+        return(symbol);
+    }
+
+    SLD_API u32
+    string_intern_get_count(
+        const string_intern_t& intern) {
+
+        return(intern.count);
+    }
+
+    SLD_API const cchar*
+    string_intern_get_chars(
+        const string_intern_t& intern,
+        const u32              symbol) {
+
+        const string_intern_entry_t* entry = string_intern_get_entry(intern, symbol);
+        const cchar*                 chars = (entry != NULL) ? entry->chars : NULL;
+        return(chars);
+    }
+
+    SLD_API u32
+    string_intern_get_length(
+        const string_intern_t& intern,
+        const u32              symbol) {
+
+        const string_intern_entry_t* entry  = string_intern_get_entry(intern, symbol);
+        const u32                    length = (entry != NULL) ? entry->length : 0;
+        return(length);
+    }
+
+    SLD_API cstr_t
+    string_intern_get_cstr(
+        const string_intern_t& intern,
+        const u32              symbol) {
+
+        // a read only view, size counts the terminator like any cstr_t
+        const string_intern_entry_t* entry = string_intern_get_entry(intern, symbol);
+
+        cstr_t cstr;
+        cstr.chars = (entry != NULL) ? (cchar*)entry->chars   : NULL;
+        cstr.size  = (entry != NULL) ? (entry->length + 1)     : 0;
+        return(cstr);
+    }
+};
\ No newline at end of file
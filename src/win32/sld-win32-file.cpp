@@ -246,6 +246,87 @@ namespace sld {
         return(error);
     }
 
+    SLD_API_OS_FUNC const os_file_error_t
+    win32_file_map_read(
+        const c8*      path,
+        os_file_map_t& map) {
+
+        map.data = NULL;
+        map.size = 0;
+
+        const HANDLE win32_file = CreateFileA(
+            path,
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            NULL,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            NULL);
+        if (win32_file == INVALID_HANDLE_VALUE) {
+            return(win32_file_get_error_code(GetLastError()));
+        }
+
+        LARGE_INTEGER win32_size;
+        const BOOL did_size = GetFileSizeEx(win32_file, &win32_size);
+        if (!did_size || win32_size.QuadPart == 0) {
+            const DWORD win32_error = did_size ? ERROR_SUCCESS : GetLastError();
+            CloseHandle(win32_file);
+            return(win32_file_get_error_code(win32_error));
+        }
+
+        const HANDLE win32_mapping = CreateFileMappingA(win32_file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (win32_mapping == NULL) {
+            const DWORD win32_error = GetLastError();
+            CloseHandle(win32_file);
+            return(win32_file_get_error_code(win32_error));
+        }
+
+        // the view keeps the mapping and the file open on its own
+        void*       view        = MapViewOfFile(win32_mapping, FILE_MAP_READ, 0, 0, 0);
+        const DWORD win32_error = (view != NULL) ? ERROR_SUCCESS : GetLastError();
+        CloseHandle(win32_mapping);
+        CloseHandle(win32_file);
+
+        if (view != NULL) {
+            map.data = (const byte*)view;
+            map.size = (u64)win32_size.QuadPart;
+        }
+        return(win32_file_get_error_code(win32_error));
+    }
+
+    SLD_API_OS_FUNC const os_file_error_t
+    win32_file_unmap(
+        os_file_map_t& map) {
+
+        const bool  is_empty    = (map.data == NULL) && (map.size == 0);
+        const bool  did_unmap   = is_empty || ((map.data != NULL) && UnmapViewOfFile(map.data));
+        const DWORD win32_error = did_unmap ? ERROR_SUCCESS : ERROR_INVALID_PARAMETER;
+
+        map.data = NULL;
+        map.size = 0;
+        return(win32_file_get_error_code(win32_error));
+    }
+
+    SLD_API_OS_FUNC const os_file_error_t
+    win32_file_map_prefetch(
+        const os_file_map_t& map,
+        const u64            offset,
+        const u64            size) {
+
+        // only a hint, the range is clamped to the view
+        if (offset >= map.size || size == 0) return(win32_file_get_error_code(ERROR_SUCCESS));
+
+        const u64 end = ((map.size - offset) < size) ? map.size : (offset + size);
+
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = (PVOID)(map.data + offset);
+        range.NumberOfBytes  = (SIZE_T)(end - offset);
+
+        const BOOL  did_prefetch = PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+        const DWORD win32_error  = did_prefetch ? ERROR_SUCCESS : GetLastError();
+        return(win32_file_get_error_code(win32_error));
+    }
+
     //-------------------------------------------------------------------
     // INTERNAL
     //-------------------------------------------------------------------
@@ -20,6 +20,24 @@ namespace sld {
         return(memory);
     }
 
+    SLD_API_OS_FUNC void*
+    win32_memory_reserve_huge(
+        void*                         start,
+        const u64                     size,
+        const os_memory_page_policy_e page_policy,
+        u64&                          page_size) {
+
+        // MEM_LARGE_PAGES can only be used when reserving and committing
+        // in the same call, which breaks reserve-then-commit. until we
+        // have a path for that, every policy falls back to base pages
+        SYSTEM_INFO sys_info;
+        GetSystemInfo(&sys_info);
+
+        void* memory = win32_memory_reserve(start, size);
+        page_size    = (memory != NULL) ? sys_info.dwPageSize : 0;
+        return(memory);
+    }
+
     SLD_API_OS_FUNC bool
     win32_memory_release(
         void*     start,
@@ -122,4 +140,66 @@ namespace sld {
         const bool is_committed = (memory_info.State == MEM_COMMIT);
         return(is_committed); 
     }
+
+    SLD_API_OS_FUNC void*
+    win32_memory_map_mirrored(
+        const u64 size) {
+
+        // views have to start on the allocation granularity
+        SYSTEM_INFO sys_info;
+        GetSystemInfo(&sys_info);
+        if (size == 0 || (size % sys_info.dwAllocationGranularity) != 0) return(NULL);
+
+        HANDLE section = CreateFileMappingA(
+            INVALID_HANDLE_VALUE,
+            NULL,
+            PAGE_READWRITE,
+            (DWORD)(size >> 32),
+            (DWORD)(size & 0xFFFFFFFF),
+            NULL
+        );
+        if (section == NULL) return(NULL);
+
+        // find a free range big enough for both views, then map into it.
+        // another thread can take the range between the free and the
+        // map, so try again a few times before giving up
+        void* memory = NULL;
+        for (
+            u32 attempt = 0;
+                attempt < 16 && memory == NULL;
+              ++attempt) {
+
+            void* range = VirtualAlloc(NULL, (size * 2), MEM_RESERVE, PAGE_NOACCESS);
+            if (range == NULL) break;
+            (void)VirtualFree(range, 0, MEM_RELEASE);
+
+            void* first  = MapViewOfFileEx(section, FILE_MAP_ALL_ACCESS, 0, 0, size, range);
+            void* second = MapViewOfFileEx(section, FILE_MAP_ALL_ACCESS, 0, 0, size, (void*)((addr)range + size));
+
+            if (first == range && second == (void*)((addr)range + size)) {
+                memory = range;
+            }
+            else {
+                if (first)  (void)UnmapViewOfFile(first);
+                if (second) (void)UnmapViewOfFile(second);
+            }
+        }
+
+        // the views keep the section alive
+        (void)CloseHandle(section);
+        return(memory);
+    }
+
+    SLD_API_OS_FUNC bool
+    win32_memory_unmap_mirrored(
+        void*     start,
+        const u64 size) {
+
+        if (!start) return(false);
+
+        bool result = true;
+        result &= (UnmapViewOfFile(start)                          != 0);
+        result &= (UnmapViewOfFile((void*)((addr)start + size)) != 0);
+        return(result);
+    }
 };
\ No newline at end of file
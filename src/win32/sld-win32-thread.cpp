@@ -11,6 +11,7 @@ namespace sld {
 
     const os_thread_error_t  win32_thread_error_success  (void);
     const os_thread_error_t  win32_thread_error_get_last (void);
+    DWORD WINAPI             win32_thread_main           (LPVOID parameter);
 
     //-------------------------------------------------------------------
     // OS API
@@ -18,10 +19,20 @@ namespace sld {
 
     static const os_thread_error_t
     win32_thread_create(
-        os_thread_handle_t& thread_handle) {
+        os_thread_handle_t&  thread_handle,
+        os_thread_context_t& context) {
 
-        os_thread_error_t error = win32_thread_error_success();
-        return(error);
+        thread_handle.val = NULL;
+        if (context.function == NULL) {
+            static const os_thread_error_t error_invalid_args = { os_thread_error_e_invalid_args };
+            return(error_invalid_args);
+        }
+
+        HANDLE thread = CreateThread(NULL, 0, win32_thread_main, (LPVOID)&context, 0, NULL);
+        if (thread == NULL) return(win32_thread_error_get_last());
+
+        thread_handle.val = (vptr)thread;
+        return(win32_thread_error_success());
     }
 
     static const os_thread_error_t 
@@ -60,7 +71,19 @@ namespace sld {
     win32_thread_join(
         const os_thread_handle_t thread_handle) {
 
-        os_thread_error_t error = win32_thread_error_success();
+        HANDLE thread = (HANDLE)thread_handle.val;
+        if (thread == NULL) {
+            static const os_thread_error_t error_invalid_args = { os_thread_error_e_invalid_args };
+            return(error_invalid_args);
+        }
+
+        // the handle is done once the thread is, close it here
+        const bool did_wait = (WaitForSingleObject(thread, INFINITE) == WAIT_OBJECT_0);
+        const os_thread_error_t error = did_wait
+            ? win32_thread_error_success()
+            : win32_thread_error_get_last();
+
+        (void)CloseHandle(thread);
         return(error);
     }
 
@@ -156,6 +179,15 @@ namespace sld {
         return(error);
     }
 
+    DWORD WINAPI
+    win32_thread_main(
+        LPVOID parameter) {
+
+        os_thread_context_t* context = (os_thread_context_t*)parameter;
+        context->function(*context);
+        return(0);
+    }
+
     const os_thread_error_t
     win32_thread_error_get_last(
         void) {
@@ -53,6 +53,7 @@ namespace sld {
     //----------------
 
     os_memory_reserve_f              os_memory_reserve              = win32_memory_reserve;
+    os_memory_reserve_huge_f         os_memory_reserve_huge         = win32_memory_reserve_huge;
     os_memory_release_f              os_memory_release              = win32_memory_release;
     os_memory_commit_f               os_memory_commit               = win32_memory_commit;
     os_memory_decommit_f             os_memory_decommit             = win32_memory_decommit;
@@ -60,6 +61,8 @@ namespace sld {
     os_memory_align_to_granularity_f os_memory_align_to_granularity = win32_memory_align_to_granularity;
     os_memory_is_reserved_f          os_memory_is_reserved          = win32_memory_is_reserved;
     os_memory_is_committed_f         os_memory_is_committed         = win32_memory_is_committed;
+    os_memory_map_mirrored_f         os_memory_map_mirrored         = win32_memory_map_mirrored;
+    os_memory_unmap_mirrored_f       os_memory_unmap_mirrored       = win32_memory_unmap_mirrored;
     
     //----------------
     // files
@@ -71,4 +74,14 @@ namespace sld {
     os_file_write_f                  os_file_write                  = win32_file_write; 
     os_file_read_async_f             os_file_read_async             = win32_file_read_async; 
     os_file_write_async_f            os_file_write_async            = win32_file_write_async; 
+    os_file_map_read_f               os_file_map_read               = win32_file_map_read;
+    os_file_unmap_f                  os_file_unmap                  = win32_file_unmap;
+    os_file_map_prefetch_f           os_file_map_prefetch           = win32_file_map_prefetch;
+
+    //----------------
+    // threads
+    //----------------
+
+    os_thread_create_f               os_thread_create               = win32_thread_create;
+    os_thread_join_f                 os_thread_join                 = win32_thread_join;
 };
\ No newline at end of file
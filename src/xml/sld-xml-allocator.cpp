@@ -11,7 +11,8 @@ namespace sld {
         const u32 size_total, 
         const u32 size_block) {
 
-        block_allocator_reserve_os_memory(&_xml_allocator, size_total, size_block);
+        const bool did_reserve = block_allocator_reserve_os_memory(&_xml_allocator, size_total, size_block);
+        assert(did_reserve);
     }
 
     SLD_INTERNAL void
@@ -0,0 +1,148 @@
+#include <cassert>
+#include <atomic>
+#include "sld-memory.hpp"
+#include "sld-hash32.cpp"
+#include "sld-hash128.cpp"
+#include "sld-hash-short.cpp"
+#include "sld-core-hash-table.cpp"
+#include "sld-core-concurrent-hash-table.cpp"
+#if defined(_WIN32)
+#   include "sld-win32.cpp"
+#elif defined(__linux__)
+#   include "sld-linux.cpp"
+#endif
+#include "sld-test.hpp"
+
+// read mostly throughput at 90/10 and 99/1 reads to writes, from 1 to N
+// threads. the concurrent table is measured against one hash_table_t
+// behind a single spin lock, the global lock it replaces. writes are
+// half inserts and half removes over a fixed key space, values hold the
+// key and its complement so a reader that sees a torn value counts it
+
+using namespace sld;
+
+constexpr u32 TEST_KEY_COUNT      = (1 << 16);
+constexpr u32 TEST_OPS_PER_THREAD = 1000000;
+
+struct test_value_t {
+    u64 key;
+    u64 check;
+};
+
+struct test_concurrent_hash_table_t {
+    epoch_domain_t          epoch;
+    concurrent_hash_table_t table;
+    spin_lock_t             locked_lock;
+    hash_table_t            locked_table;
+    u32                     read_percent;
+    bool                    use_locked;
+    std::atomic<u64>        torn_count;
+};
+
+static void
+test_concurrent_hash_table_thread(
+    const u32 thread_index,
+    void*     data) {
+
+    test_concurrent_hash_table_t* test = (test_concurrent_hash_table_t*)data;
+
+    const u32 participant = test->use_locked ? 0 : epoch_register(test->epoch);
+    u64       random      = (0x9E3779B97F4A7C15 * (thread_index + 1));
+    u64       torn_count  = 0;
+
+    for (
+        u32 op = 0;
+            op < TEST_OPS_PER_THREAD;
+          ++op) {
+
+        const u64              bits  = test_random(random);
+        u64                    key   = (bits >> 16) % TEST_KEY_COUNT;
+        const hash_table_key_t key_v = { (const byte*)&key, sizeof(key) };
+        const bool             read  = ((bits % 100) < test->read_percent);
+        const bool             add   = ((bits & 0x100) != 0);
+
+        test_value_t value = { key, ~key };
+        if (test->use_locked) {
+
+            spin_lock_acquire(test->locked_lock);
+            if (read) {
+                hash_table_value_t found;
+                if (hash_table_search(test->locked_table, key_v, found)) {
+                    value = *(const test_value_t*)found.data;
+                }
+            }
+            else if (add) (void)hash_table_insert (test->locked_table, (const byte*)&value, key_v);
+            else          (void)hash_table_remove (test->locked_table, key_v);
+            spin_lock_release(test->locked_lock);
+        }
+        else {
+            if (read)     (void)concurrent_hash_table_search (test->table, participant, key_v, (byte*)&value);
+            else if (add) (void)concurrent_hash_table_insert (test->table, key_v, (const byte*)&value);
+            else          (void)concurrent_hash_table_remove (test->table, key_v);
+        }
+        torn_count += (value.key != key || value.check != ~key) ? 1 : 0;
+    }
+
+    if (!test->use_locked) epoch_unregister(test->epoch, participant);
+    test->torn_count.fetch_add(torn_count, std::memory_order_relaxed);
+}
+
+int main(void) {
+
+    static test_concurrent_hash_table_t test;
+    epoch_domain_init(test.epoch);
+    if (!concurrent_hash_table_init(test.table, &test.epoch, sizeof(test_value_t), TEST_KEY_COUNT / 2)) return(1);
+
+    // sized so the locked table never has to grow
+    test.locked_table.capacity = (TEST_KEY_COUNT * 4);
+    test.locked_table.stride   = sizeof(test_value_t);
+    memory_t memory;
+    memory.addr = 0;
+    memory.size = hash_table_memory_size(test.locked_table);
+    if (memory_os_reserve(memory) == 0) return(1);
+    memory_os_commit(memory);
+    if (!hash_table_memory_init(test.locked_table, memory)) return(1);
+    spin_lock_init(test.locked_lock);
+
+    const u32 read_percents[]  = { 90, 99 };
+    const u32 thread_count_max = test_thread_count_max();
+    for (const u32 read_percent : read_percents) {
+
+        (void)printf("    %u/%u reads/writes\n", read_percent, 100 - read_percent);
+        (void)printf("    %8s %18s %18s\n", "threads", "locked M ops/s", "concurrent M ops/s");
+        test.read_percent = read_percent;
+
+        for (
+            u32 thread_count = 1;
+                thread_count <= thread_count_max;
+                thread_count *= 2) {
+
+            f64 rates[2];
+            for (
+                u32 variant = 0;
+                    variant < 2;
+                  ++variant) {
+
+                test.use_locked = (variant == 0);
+                test.torn_count.store(0, std::memory_order_relaxed);
+
+                const f64 time_start = test_time_seconds();
+                test_run_threads(thread_count, test_concurrent_hash_table_thread, &test);
+                const f64 time_total = test_time_seconds() - time_start;
+
+                rates[variant] = (((f64)thread_count * TEST_OPS_PER_THREAD) / time_total) / 1000000.0;
+                if (test.torn_count.load(std::memory_order_relaxed) != 0) {
+                    (void)printf("    TORN %s: %llu\n", test.use_locked ? "locked" : "concurrent",
+                        (unsigned long long)test.torn_count.load(std::memory_order_relaxed));
+                }
+            }
+            (void)printf("    %8u %18.2f %18.2f\n", thread_count, rates[0], rates[1]);
+        }
+        (void)epoch_reclaim(test.epoch);
+    }
+
+    concurrent_hash_table_release (test.table);
+    epoch_domain_release          (test.epoch);
+    memory_os_release             (memory);
+    return(0);
+}
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include <cassert>
+#include "sld-memory.hpp"
+#include "sld-hash32.cpp"
+#include "sld-hash128.cpp"
+#include "sld-hash-short.cpp"
+#if defined(_WIN32)
+#   include "sld-win32.cpp"
+#elif defined(__linux__)
+#   include "sld-linux.cpp"
+#endif
+#include "sld-core-hash-filter.cpp"
+#include "sld-test.hpp"
+
+// false positive rate and lookup throughput of both filters, one key at
+// a time against the batch, from filters that fit in the cache to ones
+// well past the last level. the queries are keys that were never
+// inserted, the lookups a filter is there to make cheap
+
+using namespace sld;
+
+constexpr u32 TEST_KEY_COUNT_MIN = (1 << 16);
+constexpr u32 TEST_KEY_COUNT_MAX = (1 << 24);
+constexpr u32 TEST_QUERY_COUNT   = (1 << 22);
+
+struct test_result_t {
+    f64 false_rate;
+    f64 single_rate;
+    f64 batch_rate;
+};
+
+static memory_t
+test_memory_alloc(
+    const u64 size) {
+
+    memory_t memory;
+    memory.addr = 0;
+    memory.size = size;
+    const u64 page_size = memory_os_reserve(memory);
+    assert(page_size != 0);
+    memory_os_commit(memory);
+    return(memory);
+}
+
+static test_result_t
+test_bloom_filter(
+    const u32        key_count,
+    const hash128_t* keys,
+    const hash128_t* queries,
+    bool*            results) {
+
+    bloom_filter_t filter = {};
+    filter.block_count = bloom_filter_block_count(key_count, BLOOM_FILTER_BITS_PER_KEY);
+    memory_t memory = test_memory_alloc(bloom_filter_memory_size(filter));
+    (void)bloom_filter_memory_init(filter, memory);
+    for (u32 key = 0; key < key_count; ++key) (void)bloom_filter_insert(filter, keys[key]);
+
+    u32       false_count = 0;
+    const f64 time_single = test_time_seconds();
+    for (u32 query = 0; query < TEST_QUERY_COUNT; ++query) false_count += bloom_filter_contains(filter, queries[query]) ? 1 : 0;
+    const f64 time_batch  = test_time_seconds();
+    (void)bloom_filter_contains_batch(filter, TEST_QUERY_COUNT, queries, results);
+    const f64 time_end    = test_time_seconds();
+
+    test_result_t result;
+    result.false_rate  = ((f64)false_count / TEST_QUERY_COUNT);
+    result.single_rate = (TEST_QUERY_COUNT / (time_batch - time_single)) / 1000000.0;
+    result.batch_rate  = (TEST_QUERY_COUNT / (time_end   - time_batch))  / 1000000.0;
+    memory_os_release(memory);
+    return(result);
+}
+
+static test_result_t
+test_cuckoo_filter(
+    const u32        key_count,
+    const hash128_t* keys,
+    const hash128_t* queries,
+    bool*            results) {
+
+    cuckoo_filter_t filter = {};
+    filter.bucket_count = cuckoo_filter_bucket_count(key_count);
+    memory_t memory = test_memory_alloc(cuckoo_filter_memory_size(filter));
+    (void)cuckoo_filter_memory_init(filter, memory);
+    for (u32 key = 0; key < key_count; ++key) (void)cuckoo_filter_insert(filter, keys[key]);
+
+    u32       false_count = 0;
+    const f64 time_single = test_time_seconds();
+    for (u32 query = 0; query < TEST_QUERY_COUNT; ++query) false_count += cuckoo_filter_contains(filter, queries[query]) ? 1 : 0;
+    const f64 time_batch  = test_time_seconds();
+    (void)cuckoo_filter_contains_batch(filter, TEST_QUERY_COUNT, queries, results);
+    const f64 time_end    = test_time_seconds();
+
+    test_result_t result;
+    result.false_rate  = ((f64)false_count / TEST_QUERY_COUNT);
+    result.single_rate = (TEST_QUERY_COUNT / (time_batch - time_single)) / 1000000.0;
+    result.batch_rate  = (TEST_QUERY_COUNT / (time_end   - time_batch))  / 1000000.0;
+    memory_os_release(memory);
+    return(result);
+}
+
+int main(void) {
+
+    // the keys and queries are hashed up front, the filters only see hashes
+    const u64  size_hashes = (u64)(TEST_KEY_COUNT_MAX + TEST_QUERY_COUNT) * sizeof(hash128_t);
+    memory_t   memory      = test_memory_alloc(size_hashes + TEST_QUERY_COUNT);
+    hash128_t* keys        = (hash128_t*)memory.ptr;
+    hash128_t* queries     = keys + TEST_KEY_COUNT_MAX;
+    bool*      results     = (bool*)(queries + TEST_QUERY_COUNT);
+
+    const hash128_seed_t& seed = *(const hash128_seed_t*)MeowDefaultSeed;
+    for (u64 key = 0; key < TEST_KEY_COUNT_MAX; ++key) keys[key] = hash128_short(seed, (const byte*)&key, sizeof(key));
+    for (
+        u64 query = 0;
+            query < TEST_QUERY_COUNT;
+          ++query) {
+
+        const u64 key = (((u64)1 << 40) + query);
+        queries[query] = hash128_short(seed, (const byte*)&key, sizeof(key));
+    }
+
+    (void)printf("    M queries/s, queries are never inserted\n");
+    (void)printf("    %10s %8s %10s %10s %10s\n", "keys", "filter", "false %", "single", "batch");
+    for (
+        u32 key_count = TEST_KEY_COUNT_MIN;
+            key_count <= TEST_KEY_COUNT_MAX;
+            key_count *= 4) {
+
+        const test_result_t bloom  = test_bloom_filter  (key_count, keys, queries, results);
+        const test_result_t cuckoo = test_cuckoo_filter (key_count, keys, queries, results);
+        (void)printf("    %10u %8s %10.4f %10.1f %10.1f\n", key_count, "bloom",  bloom.false_rate  * 100.0, bloom.single_rate,  bloom.batch_rate);
+        (void)printf("    %10u %8s %10.4f %10.1f %10.1f\n", key_count, "cuckoo", cuckoo.false_rate * 100.0, cuckoo.single_rate, cuckoo.batch_rate);
+    }
+
+    memory_os_release(memory);
+    return(0);
+}
\ No newline at end of file
@@ -0,0 +1,191 @@
+#include <cassert>
+#include "sld-memory.hpp"
+#include "sld-hash32.cpp"
+#include "sld-hash128.cpp"
+#if defined(_WIN32)
+#   include "sld-win32.cpp"
+#elif defined(__linux__)
+#   include "sld-linux.cpp"
+#endif
+#include "sld-test.hpp"
+
+// hash32_search and hash128_search over arrays from 16 to 1M entries,
+// against a plain loop and each kernel the cpu can run. the needle is
+// never in the array, so every search scans it all, the cost the asset
+// registry pays on a miss. every kernel has to agree with the loop on a
+// hit placed near the end
+
+using namespace sld;
+
+constexpr u32 TEST_COUNT_MIN      = 16;
+constexpr u32 TEST_COUNT_MAX      = (1 << 20);
+constexpr u64 TEST_ELEMENTS_TOTAL = (1 << 26);
+
+using test_search32_f  = u32 (*) (const u32 count, const u32        search, const hash32_t*  array);
+using test_search128_f = u32 (*) (const u32 count, const hash128_t& search, const hash128_t* array);
+
+static u32
+test_search32_scalar(
+    const u32       count,
+    const u32       search,
+    const hash32_t* array) {
+
+    for (
+        u32 index = 0;
+            index < count;
+          ++index) {
+
+        if (array[index].as_u32 == search) return(index);
+    }
+    return(count);
+}
+
+static u32
+test_search128_scalar(
+    const u32        count,
+    const hash128_t& search,
+    const hash128_t* array) {
+
+    for (
+        u32 index = 0;
+            index < count;
+          ++index) {
+
+        const bool is_equal =
+            (array[index].val.as_u64[0] == search.val.as_u64[0]) &&
+            (array[index].val.as_u64[1] == search.val.as_u64[1]);
+        if (is_equal) return(index);
+    }
+    return(count);
+}
+
+static f64
+test_time_search32(
+    const test_search32_f search,
+    const u32             count,
+    const hash32_t*       array,
+    bool&                 is_correct) {
+
+    // the last entry is the hit, then a miss is timed
+    const u32 hit = search(count, array[count - 1].as_u32, array);
+    is_correct &= (hit == test_search32_scalar(count, array[count - 1].as_u32, array));
+
+    const u32 repeat_count = (u32)(TEST_ELEMENTS_TOTAL / count);
+    u64       sink         = 0;
+    const f64 time_start   = test_time_seconds();
+    for (
+        u32 repeat = 0;
+            repeat < repeat_count;
+          ++repeat) {
+
+        sink += search(count, 0, array);
+    }
+    const f64 time_total = test_time_seconds() - time_start;
+
+    is_correct &= (sink == ((u64)repeat_count * count));
+    return((time_total * 1e9) / ((f64)repeat_count * count));
+}
+
+static f64
+test_time_search128(
+    const test_search128_f search,
+    const u32              count,
+    const hash128_t*       array,
+    bool&                  is_correct) {
+
+    const u32 hit = search(count, array[count - 1], array);
+    is_correct &= (hit == test_search128_scalar(count, array[count - 1], array));
+
+    const hash128_t miss         = {};
+    const u32       repeat_count = (u32)(TEST_ELEMENTS_TOTAL / count);
+    u64             sink         = 0;
+    const f64       time_start   = test_time_seconds();
+    for (
+        u32 repeat = 0;
+            repeat < repeat_count;
+          ++repeat) {
+
+        sink += search(count, miss, array);
+    }
+    const f64 time_total = test_time_seconds() - time_start;
+
+    is_correct &= (sink == ((u64)repeat_count * count));
+    return((time_total * 1e9) / ((f64)repeat_count * count));
+}
+
+int main(void) {
+
+    const simd_level_e level        = simd_get_level();
+    const u32          kernel_count = (u32)level + 2;
+
+    const test_search32_f search32[] = {
+        test_search32_scalar, hash32_search_sse2, hash32_search_avx2, hash32_search_avx512
+    };
+    const test_search128_f search128[] = {
+        test_search128_scalar, hash128_search_sse2, hash128_search_avx2, hash128_search_avx512
+    };
+    const char* kernel_names[] = { "scalar", "sse2", "avx2", "avx512" };
+
+    memory_t memory;
+    memory.addr = 0;
+    memory.size = (u64)TEST_COUNT_MAX * (sizeof(hash32_t) + sizeof(hash128_t));
+    if (memory_os_reserve(memory) == 0) return(1);
+    memory_os_commit(memory);
+
+    hash128_t* array128 = (hash128_t*)memory.ptr;
+    hash32_t*  array32  = (hash32_t*)(array128 + TEST_COUNT_MAX);
+
+    // never 0, so the zero needle always misses
+    u64 random = 0x2545F4914F6CDD1D;
+    for (
+        u32 index = 0;
+            index < TEST_COUNT_MAX;
+          ++index) {
+
+        array32[index].as_u32         = (u32)test_random(random) | 1;
+        array128[index].val.as_u64[0] = test_random(random) | 1;
+        array128[index].val.as_u64[1] = test_random(random);
+    }
+
+    (void)printf("    ns per entry, lower is better\n");
+    (void)printf("    %8s %8s", "count", "hash");
+    for (
+        u32 kernel = 0;
+            kernel < kernel_count;
+          ++kernel) {
+
+        (void)printf(" %8s", kernel_names[kernel]);
+    }
+    (void)printf("\n");
+
+    bool is_correct = true;
+    for (
+        u32 count = TEST_COUNT_MIN;
+            count <= TEST_COUNT_MAX;
+            count *= 4) {
+
+        (void)printf("    %8u %8s", count, "hash32");
+        for (
+            u32 kernel = 0;
+                kernel < kernel_count;
+              ++kernel) {
+
+            (void)printf(" %8.3f", test_time_search32(search32[kernel], count, array32, is_correct));
+        }
+
+        (void)printf("\n    %8u %8s", count, "hash128");
+        for (
+            u32 kernel = 0;
+                kernel < kernel_count;
+              ++kernel) {
+
+            (void)printf(" %8.3f", test_time_search128(search128[kernel], count, array128, is_correct));
+        }
+        (void)printf("\n");
+    }
+
+    if (!is_correct) (void)printf("    MISMATCH between the kernels and the scalar loop\n");
+
+    memory_os_release(memory);
+    return(0);
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include <cassert>
+#include "sld-memory.hpp"
+#include "sld-hash128.cpp"
+#include "sld-hash-short.cpp"
+#if defined(_WIN32)
+#   include "sld-win32.cpp"
+#elif defined(__linux__)
+#   include "sld-linux.cpp"
+#endif
+#include "sld-test.hpp"
+
+// latency of hash128_short, meow and hash_data by key length. each
+// key's offset depends on the last hash, so the calls can't overlap and
+// the time is one key's latency, what a table lookup waits on.
+// hash_data should track the faster of the two at every length. the
+// first length where it trails meow is where the short path stopped
+// paying off, SLD_HASH_SHORT_LENGTH_MAX belongs just below it. a slow
+// dispatch or a define set too high both show up as that length moving
+// down
+
+using namespace sld;
+
+constexpr u32 TEST_BUFFER_SIZE  = size_kilobytes(64);
+constexpr u32 TEST_OFFSET_MASK  = (size_kilobytes(32) - 1);
+constexpr u32 TEST_REPEAT_COUNT = 1000000;
+constexpr u32 TEST_TRIAL_COUNT  = 3;
+constexpr u32 TEST_LENGTHS[]    = { 4, 8, 12, 16, 24, 32, 48, 64, 96, 112, 128, 144, 160, 192, 256, 384, 512 };
+constexpr f64 TEST_TRAIL_MARGIN = 1.05;
+
+using test_hash_f = const hash128_t (*) (const hash128_seed_t& seed, const byte* data, const u32 length);
+
+static f64
+test_time_latency(
+    const test_hash_f     hash,
+    const hash128_seed_t& seed,
+    const byte*           buffer,
+    const u32             length,
+    u64&                  sink) {
+
+    // the best of a few trials, a single one on a busy machine is noisy
+    // enough to move the crossover
+    u64 offset    = 0;
+    f64 time_best = 0.0;
+    for (
+        u32 trial = 0;
+            trial < TEST_TRIAL_COUNT;
+          ++trial) {
+
+        const f64 time_start = test_time_seconds();
+        for (
+            u32 repeat = 0;
+                repeat < TEST_REPEAT_COUNT;
+              ++repeat) {
+
+            const hash128_t result = hash(seed, &buffer[offset], length);
+            offset = (result.val.as_u64[0] ^ repeat) & TEST_OFFSET_MASK;
+        }
+        const f64 time_total = test_time_seconds() - time_start;
+        if (trial == 0 || time_total < time_best) time_best = time_total;
+    }
+
+    sink += offset;
+    return((time_best * 1e9) / TEST_REPEAT_COUNT);
+}
+
+int main(void) {
+
+    const hash128_seed_t& seed = *(const hash128_seed_t*)MeowDefaultSeed;
+
+    static byte buffer[TEST_BUFFER_SIZE];
+    u64         random = 0x2545F4914F6CDD1D;
+    for (
+        u32 index = 0;
+            index < TEST_BUFFER_SIZE;
+          ++index) {
+
+        buffer[index] = (byte)test_random(random);
+    }
+
+    (void)printf("    ns per key, SLD_HASH_SHORT_LENGTH_MAX is %u\n", (u32)SLD_HASH_SHORT_LENGTH_MAX);
+    (void)printf("    %8s %10s %10s %10s\n", "length", "short", "meow", "hash_data");
+
+    u32 crossover = 0;
+    u64 sink      = 0;
+    for (const u32 length : TEST_LENGTHS) {
+
+        const f64 ns_short = test_time_latency (hash128_short, seed, buffer, length, sink);
+        const f64 ns_meow  = test_time_latency (hash128_data,  seed, buffer, length, sink);
+        const f64 ns_data  = test_time_latency (hash_data,     seed, buffer, length, sink);
+
+        // past the define hash_data is meow, so only
+        // a clear loss counts, not timing noise
+        if (crossover == 0 && ns_data > (ns_meow * TEST_TRAIL_MARGIN)) crossover = length;
+
+        (void)printf("    %8u %10.2f %10.2f %10.2f\n", length, ns_short, ns_meow, ns_data);
+    }
+
+    if (crossover != 0) (void)printf("    hash_data trails meow from %u bytes\n", crossover);
+    else                (void)printf("    hash_data keeps up with meow at every length measured\n");
+
+    // keeps the hash chains from being optimized out
+    volatile u64 sink_keep = sink;
+    (void)sink_keep;
+    return(0);
+}
\ No newline at end of file
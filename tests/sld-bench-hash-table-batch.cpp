@@ -0,0 +1,133 @@
+#include <cassert>
+#include "sld-memory.hpp"
+#include "sld-hash32.cpp"
+#include "sld-hash128.cpp"
+#include "sld-hash-short.cpp"
+#include "sld-core-hash-table.cpp"
+#if defined(_WIN32)
+#   include "sld-win32.cpp"
+#elif defined(__linux__)
+#   include "sld-linux.cpp"
+#endif
+#include "sld-test.hpp"
+
+// one key at a time against the batch lookup, from a table that fits in
+// the cache to tables well past the last level. single lookups wait on
+// every miss in turn, the batch hashes and prefetches ahead so the misses
+// overlap. the tables are 3/4 full and the queries are random hits, so
+// the two sums have to agree
+
+using namespace sld;
+
+constexpr u32 TEST_CAPACITY_MIN  = (1 << 14);
+constexpr u32 TEST_CAPACITY_MAX  = (1 << 24);
+constexpr u32 TEST_QUERY_COUNT   = (1 << 21);
+constexpr u32 TEST_LOAD_PERCENT  = 75;
+
+static f64
+test_search_single(
+    const hash_table_t& table,
+    const u64*          queries,
+    u64&                sum) {
+
+    const f64 time_start = test_time_seconds();
+    for (
+        u32 query = 0;
+            query < TEST_QUERY_COUNT;
+          ++query) {
+
+        const hash_table_key_t key = { (const byte*)&queries[query], sizeof(u64) };
+        hash_table_value_t     value;
+        if (hash_table_search(table, key, value)) sum += *(const u64*)value.data;
+    }
+    return(test_time_seconds() - time_start);
+}
+
+static f64
+test_search_batch(
+    const hash_table_t& table,
+    const u64*          queries,
+    hash_table_value_t* values,
+    u64&                sum) {
+
+    const f64 time_start = test_time_seconds();
+    (void)hash_table_search_batch(table, TEST_QUERY_COUNT, (const byte*)queries, sizeof(u64), values);
+    for (
+        u32 query = 0;
+            query < TEST_QUERY_COUNT;
+          ++query) {
+
+        if (values[query].data != NULL) sum += *(const u64*)values[query].data;
+    }
+    return(test_time_seconds() - time_start);
+}
+
+int main(void) {
+
+    const u32 key_count_max = (u32)(((u64)TEST_CAPACITY_MAX * TEST_LOAD_PERCENT) / 100);
+
+    memory_t scratch;
+    scratch.addr = 0;
+    scratch.size = ((u64)key_count_max + TEST_QUERY_COUNT) * sizeof(u64) + ((u64)key_count_max * sizeof(hash_table_value_t));
+    if (memory_os_reserve(scratch) == 0) return(1);
+    memory_os_commit(scratch);
+
+    u64*                keys    = (u64*)scratch.ptr;
+    u64*                queries = keys + key_count_max;
+    hash_table_value_t* values  = (hash_table_value_t*)(queries + TEST_QUERY_COUNT);
+
+    for (
+        u32 key = 0;
+            key < key_count_max;
+          ++key) {
+
+        keys[key] = (key * 0x9E3779B97F4A7C15) ^ 0x5555;
+    }
+
+    (void)printf("    %10s %10s %12s %12s %8s\n", "capacity", "size mb", "single ns", "batch ns", "speedup");
+    for (
+        u32 capacity = TEST_CAPACITY_MIN;
+            capacity <= TEST_CAPACITY_MAX;
+            capacity *= 4) {
+
+        hash_table_t table = {};
+        table.capacity = capacity;
+        table.stride   = sizeof(u64);
+
+        memory_t memory;
+        memory.addr = 0;
+        memory.size = hash_table_memory_size(table);
+        if (memory_os_reserve(memory) == 0) return(1);
+        memory_os_commit(memory);
+        if (!hash_table_memory_init(table, memory)) return(1);
+
+        const u32 key_count = (u32)(((u64)capacity * TEST_LOAD_PERCENT) / 100);
+        (void)hash_table_insert_batch(table, key_count, (const byte*)keys, sizeof(u64), (const byte*)keys, values);
+
+        u64 random = 0x2545F4914F6CDD1D;
+        for (
+            u32 query = 0;
+                query < TEST_QUERY_COUNT;
+              ++query) {
+
+            queries[query] = keys[test_random(random) % key_count];
+        }
+
+        u64       sum_single  = 0;
+        u64       sum_batch   = 0;
+        const f64 time_single = test_search_single (table, queries, sum_single);
+        const f64 time_batch  = test_search_batch  (table, queries, values, sum_batch);
+
+        const f64 ns_single = (time_single * 1e9) / TEST_QUERY_COUNT;
+        const f64 ns_batch  = (time_batch  * 1e9) / TEST_QUERY_COUNT;
+        const f64 size_mb   = (f64)hash_table_memory_size(table) / (1024.0 * 1024.0);
+        (void)printf("    %10u %10.1f %12.1f %12.1f %7.2fx%s\n",
+            capacity, size_mb, ns_single, ns_batch, ns_single / ns_batch,
+            (sum_single == sum_batch) ? "" : "  MISMATCH");
+
+        memory_os_release(memory);
+    }
+
+    memory_os_release(scratch);
+    return(0);
+}
\ No newline at end of file
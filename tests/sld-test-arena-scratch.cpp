@@ -0,0 +1,71 @@
+#include <cassert>
+#include <atomic>
+#include "sld-memory.hpp"
+#include "sld-arena.hpp"
+#if defined(_WIN32)
+#   include "sld-win32.cpp"
+#elif defined(__linux__)
+#   include "sld-linux.cpp"
+#endif
+#include "sld-test.hpp"
+
+// short lived threads that each take a scratch arena and exit without
+// releasing it. the pool gives its arenas back when the thread ends, so
+// once the threads are joined none of their arenas may still be mapped,
+// and running through far more threads than the address space could
+// hold scratch reservations for must not run out
+
+using namespace sld;
+
+constexpr u32 TEST_ROUND_COUNT   = 8192;
+constexpr u32 TEST_THREAD_COUNT  = 4;
+constexpr u32 TEST_SCRATCH_BYTES = 256;
+
+struct test_arena_scratch_t {
+    arena_t*         arenas[TEST_THREAD_COUNT];
+    std::atomic<u32> wrong_count;
+};
+
+static void
+test_arena_scratch_thread(
+    const u32 thread_index,
+    void*     data) {
+
+    test_arena_scratch_t* test = (test_arena_scratch_t*)data;
+
+    arena_scope_t scope = arena_scratch_begin();
+    byte*         bytes = (byte*)arena_push_bytes(scope.arena, TEST_SCRATCH_BYTES);
+    if (bytes != NULL) memset(bytes, (int)thread_index, TEST_SCRATCH_BYTES);
+    else               test->wrong_count.fetch_add(1, std::memory_order_relaxed);
+
+    test->arenas[thread_index] = scope.arena;
+    arena_scratch_end(scope);
+}
+
+int main(void) {
+
+    static test_arena_scratch_t test;
+    test.wrong_count.store(0, std::memory_order_relaxed);
+
+    u32 mapped_count = 0;
+    for (
+        u32 round = 0;
+            round < TEST_ROUND_COUNT;
+          ++round) {
+
+        test_run_threads(TEST_THREAD_COUNT, test_arena_scratch_thread, &test);
+
+        // the header page stays committed while the arena is reserved
+        for (
+            u32 thread_index = 0;
+                thread_index < TEST_THREAD_COUNT;
+              ++thread_index) {
+
+            mapped_count += os_memory_is_committed(test.arenas[thread_index]) ? 1 : 0;
+        }
+    }
+
+    SLD_TEST_CHECK(test.wrong_count.load(std::memory_order_relaxed) == 0);
+    SLD_TEST_CHECK(mapped_count == 0);
+    return(test_result("arena scratch"));
+}
\ No newline at end of file
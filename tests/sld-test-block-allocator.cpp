@@ -0,0 +1,179 @@
+#include <cassert>
+#include <atomic>
+#include "sld-memory.hpp"
+#include "sld-block-allocator.hpp"
+#if defined(_WIN32)
+#   include "sld-win32.cpp"
+#elif defined(__linux__)
+#   include "sld-linux.cpp"
+#endif
+#include "sld-test.hpp"
+
+// commit and decommit from 1 to N threads at once. every thread keeps a
+// few blocks, stamps both ends of each with its own tag and checks the
+// stamps before it gives the block back, so a block handed to two
+// threads at once shows up as a torn stamp. when the threads are done
+// every block has to be free again. then every thread commits until the
+// allocator is empty and gives it all back, over and over, so pops race
+// the pushes that refill the list and the free count has to stay in range
+
+using namespace sld;
+
+constexpr u32 TEST_BLOCK_SIZE        = size_kilobytes(64);
+constexpr u32 TEST_BLOCK_COUNT       = 256;
+constexpr u32 TEST_BLOCKS_PER_THREAD = 8;
+constexpr u32 TEST_OPS_PER_THREAD    = 20000;
+constexpr u32 TEST_DRAIN_ROUNDS      = 1000;
+
+struct test_block_allocator_t {
+    block_allocator_t allocator;
+    std::atomic<u32>  torn_count;
+    std::atomic<u32>  range_count;
+    std::atomic<u64>  op_count;
+};
+
+static void
+test_block_allocator_thread(
+    const u32 thread_index,
+    void*     data) {
+
+    test_block_allocator_t* test = (test_block_allocator_t*)data;
+
+    u64* held[TEST_BLOCKS_PER_THREAD];
+    u32  held_count = 0;
+    u64  random     = (0x9E3779B97F4A7C15 * (thread_index + 1));
+    u64  op_count   = 0;
+    u32  torn_count = 0;
+
+    const u64 word_last = ((TEST_BLOCK_SIZE / sizeof(u64)) - 1);
+    for (
+        u32 op = 0;
+            op < TEST_OPS_PER_THREAD;
+          ++op) {
+
+        const bool do_commit = (held_count == 0) || (held_count < TEST_BLOCKS_PER_THREAD && (test_random(random) & 1));
+        if (do_commit) {
+            u64* block = (u64*)block_allocator_commit(&test->allocator);
+            if (block == NULL) continue;
+
+            const u64 stamp = ((u64)thread_index << 32) | op;
+            block[0]         = stamp;
+            block[word_last] = stamp;
+            held[held_count++] = block;
+        }
+        else {
+            u64* block = held[--held_count];
+            torn_count += (block[0] != block[word_last]) ? 1 : 0;
+            torn_count += ((block[0] >> 32) != thread_index) ? 1 : 0;
+            block_allocator_decommit(&test->allocator, block);
+        }
+        ++op_count;
+    }
+
+    while (held_count != 0) {
+        block_allocator_decommit(&test->allocator, held[--held_count]);
+    }
+
+    test->torn_count.fetch_add (torn_count, std::memory_order_relaxed);
+    test->op_count.fetch_add   (op_count,   std::memory_order_relaxed);
+}
+
+static void
+test_block_allocator_drain_thread(
+    const u32 thread_index,
+    void*     data) {
+
+    test_block_allocator_t* test = (test_block_allocator_t*)data;
+
+    void* held[TEST_BLOCK_COUNT];
+    u32   range_count = 0;
+    for (
+        u32 round = 0;
+            round < TEST_DRAIN_ROUNDS;
+          ++round) {
+
+        // read straight from the allocator, its own getters
+        // assert on a count that wrapped before we could see it
+        u32 held_count = 0;
+        while (held_count < TEST_BLOCK_COUNT) {
+            void* block = block_allocator_commit(&test->allocator);
+            range_count += (test->allocator.free_count.load(std::memory_order_relaxed) > test->allocator.block_count) ? 1 : 0;
+            if (block == NULL) break;
+            held[held_count++] = block;
+        }
+
+        while (held_count != 0) {
+            block_allocator_decommit(&test->allocator, held[--held_count]);
+            range_count += (test->allocator.free_count.load(std::memory_order_relaxed) > test->allocator.block_count) ? 1 : 0;
+        }
+    }
+
+    (void)thread_index;
+    test->range_count.fetch_add(range_count, std::memory_order_relaxed);
+}
+
+int main(void) {
+
+    static test_block_allocator_t test;
+    const bool did_reserve = block_allocator_reserve_os_memory(&test.allocator, TEST_BLOCK_SIZE * TEST_BLOCK_COUNT, TEST_BLOCK_SIZE);
+    SLD_TEST_CHECK(did_reserve);
+    if (!did_reserve) return(test_result("block allocator"));
+    SLD_TEST_CHECK(block_allocator_is_valid(&test.allocator));
+
+    const u32 block_count      = test.allocator.block_count;
+    const u32 thread_count_max = test_thread_count_max();
+    for (
+        u32 thread_count = 1;
+            thread_count <= thread_count_max;
+            thread_count *= 2) {
+
+        test.torn_count.store (0, std::memory_order_relaxed);
+        test.op_count.store   (0, std::memory_order_relaxed);
+
+        const f64 time_start = test_time_seconds();
+        test_run_threads(thread_count, test_block_allocator_thread, &test);
+        const f64 time_total = test_time_seconds() - time_start;
+
+        const u64 op_count = test.op_count.load(std::memory_order_relaxed);
+        (void)printf("    %2u threads: %8.2f M ops/s\n", thread_count, ((f64)op_count / time_total) / 1000000.0);
+
+        SLD_TEST_CHECK(test.torn_count.load(std::memory_order_relaxed) == 0);
+        SLD_TEST_CHECK(block_allocator_get_blocks_free(&test.allocator) == block_count);
+    }
+
+    // down to empty and back under contention
+    for (
+        u32 thread_count = 2;
+            thread_count <= thread_count_max;
+            thread_count *= 2) {
+
+        test.range_count.store(0, std::memory_order_relaxed);
+        test_run_threads(thread_count, test_block_allocator_drain_thread, &test);
+
+        SLD_TEST_CHECK(test.range_count.load(std::memory_order_relaxed) == 0);
+        SLD_TEST_CHECK(block_allocator_get_blocks_free(&test.allocator) == block_count);
+    }
+
+    // the free list has to hold every block exactly once
+    void* blocks[TEST_BLOCK_COUNT];
+    u32   committed_count = 0;
+    while (committed_count < TEST_BLOCK_COUNT) {
+        void* block = block_allocator_commit(&test.allocator);
+        if (block == NULL) break;
+        blocks[committed_count++] = block;
+    }
+    SLD_TEST_CHECK(committed_count == block_count);
+    SLD_TEST_CHECK(block_allocator_commit(&test.allocator) == NULL);
+
+    for (
+        u32 block = 0;
+            block < committed_count;
+          ++block) {
+
+        block_allocator_decommit(&test.allocator, blocks[block]);
+    }
+    SLD_TEST_CHECK(block_allocator_get_blocks_free(&test.allocator) == block_count);
+
+    block_allocator_release_os_memory(&test.allocator);
+    return(test_result("block allocator"));
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include <cassert>
+#include "sld-memory.hpp"
+#include "sld-hash32.cpp"
+#include "sld-hash128.cpp"
+#include "sld-hash-short.cpp"
+#include "sld-core-hash-table.cpp"
+#if defined(_WIN32)
+#   include "sld-win32.cpp"
+#elif defined(__linux__)
+#   include "sld-linux.cpp"
+#endif
+#include "sld-core-chunk-store.cpp"
+#include "sld-test.hpp"
+
+// round trips a buffer through the store, adds it again to check it's
+// deduplicated, then adds a buffer while the table is growing. that
+// buffer starts with new data and ends with chunks the store already
+// holds, so the inserts for the new chunks drain the old table and
+// release it before the batch gets to the chunks it found there
+
+using namespace sld;
+
+constexpr u32 TEST_CHUNK_SIZE_AVG = CHUNK_SIZE_AVG_MIN;
+constexpr u32 TEST_CHUNK_MAX      = (1 << 16);
+constexpr u32 TEST_DATA_SIZE      = size_kilobytes(16);
+constexpr u32 TEST_NEW_SIZE       = size_kilobytes(2);
+constexpr u32 TEST_ID_MAX         = 4096;
+
+static byte _test_data   [TEST_DATA_SIZE];
+static byte _test_resize [TEST_NEW_SIZE + TEST_DATA_SIZE];
+static byte _test_buffer [sizeof(buffer_t) + TEST_NEW_SIZE + TEST_DATA_SIZE];
+static u32  _test_ids    [TEST_ID_MAX];
+
+static void
+test_fill_random(
+    byte*     data,
+    const u32 length,
+    u64&      random) {
+
+    for (
+        u32 index = 0;
+            index < length;
+          ++index) {
+
+        data[index] = (byte)test_random(random);
+    }
+}
+
+static u32
+test_add_all(
+    chunk_store_t&        store,
+    const chunk_params_t& params,
+    const byte*           data,
+    const u32             length) {
+
+    buffer_t* buffer = buffer_init_from_memory(_test_buffer, sizeof(_test_buffer));
+    (void)buffer_append(buffer, data, length);
+
+    const u32 id_count = chunk_store_add_buffer(store, params, buffer, true, _test_ids, TEST_ID_MAX);
+    SLD_TEST_CHECK(buffer->length == 0);
+    return(id_count);
+}
+
+static bool
+test_ids_match(
+    const chunk_store_t& store,
+    const u32            id_count,
+    const byte*          data,
+    const u32            length) {
+
+    // the chunks the ids name, back to back, have to be the data
+    u32  offset   = 0;
+    bool is_match = true;
+    for (
+        u32 index = 0;
+            index < id_count && is_match;
+          ++index) {
+
+        const u32   id          = _test_ids[index];
+        const u32   chunk_size  = chunk_store_get_length (store, id);
+        const byte* chunk_data  = chunk_store_get_data   (store, id);
+
+        is_match &= (chunk_data != NULL);
+        is_match &= ((offset + chunk_size) <= length);
+        is_match &= is_match && (memcmp(chunk_data, &data[offset], chunk_size) == 0);
+        offset   += chunk_size;
+    }
+    is_match &= (offset == length);
+    return(is_match);
+}
+
+int main(void) {
+
+    chunk_params_t params;
+    SLD_TEST_CHECK(chunk_params_init(params, TEST_CHUNK_SIZE_AVG));
+
+    chunk_store_t store = {};
+    SLD_TEST_CHECK(chunk_store_reserve_os_memory(store, TEST_CHUNK_MAX, size_megabytes(16)));
+
+    u64 random = 0x2545F4914F6CDD1D;
+    test_fill_random(_test_data, TEST_DATA_SIZE, random);
+
+    // round trip and dedupe
+    const u32 id_count    = test_add_all(store, params, _test_data, TEST_DATA_SIZE);
+    const u32 chunk_count = chunk_store_get_count(store);
+    SLD_TEST_CHECK(id_count != 0);
+    SLD_TEST_CHECK(test_ids_match(store, id_count, _test_data, TEST_DATA_SIZE));
+    SLD_TEST_CHECK(store.size_stored == TEST_DATA_SIZE);
+
+    hash128_t hash;
+    SLD_TEST_CHECK(chunk_store_get_hash (store, _test_ids[0], hash));
+    SLD_TEST_CHECK(chunk_store_find     (store, hash) == _test_ids[0]);
+
+    const u32 id_count_again = test_add_all(store, params, _test_data, TEST_DATA_SIZE);
+    SLD_TEST_CHECK(id_count_again == id_count);
+    SLD_TEST_CHECK(chunk_store_get_count(store) == chunk_count);
+    SLD_TEST_CHECK(store.size_added == ((u64)TEST_DATA_SIZE * 2));
+
+    // new chunks one at a time until the next insert starts a resize
+    byte chunk[TEST_CHUNK_SIZE_AVG];
+    while (!hash_table_is_resizing(store.table)) {
+        test_fill_random(chunk, TEST_CHUNK_SIZE_AVG, random);
+        if (chunk_store_add(store, chunk, TEST_CHUNK_SIZE_AVG) == CHUNK_STORE_ID_INVALID) break;
+    }
+    SLD_TEST_CHECK(hash_table_is_resizing(store.table));
+
+    test_fill_random (_test_resize, TEST_NEW_SIZE, random);
+    memcpy           (&_test_resize[TEST_NEW_SIZE], _test_data, TEST_DATA_SIZE);
+
+    const u32 id_count_resize = test_add_all(store, params, _test_resize, sizeof(_test_resize));
+    SLD_TEST_CHECK(!hash_table_is_resizing(store.table));
+    SLD_TEST_CHECK(test_ids_match(store, id_count_resize, _test_resize, sizeof(_test_resize)));
+
+    chunk_store_release_os_memory(store);
+    return(test_result("chunk store"));
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include <cassert>
+#include <atomic>
+#include "sld-memory.hpp"
+#include "sld-hash32.cpp"
+#include "sld-hash128.cpp"
+#include "sld-hash-short.cpp"
+#include "sld-core-hash-table.cpp"
+#include "sld-core-concurrent-hash-table.cpp"
+#if defined(_WIN32)
+#   include "sld-win32.cpp"
+#elif defined(__linux__)
+#   include "sld-linux.cpp"
+#endif
+#include "sld-test.hpp"
+
+// every shard array is its own reservation, so a handful of tables holds
+// more of them than the os backend used to track. all of them have to
+// init and keep their keys apart, and a table too big for the address
+// space has to fail init and give back the shards it did reserve
+
+using namespace sld;
+
+constexpr u32 TEST_TABLE_COUNT = 16;
+constexpr u32 TEST_KEY_COUNT   = 4096;
+constexpr u32 TEST_HUGE_STRIDE = (1 << 20);
+
+static concurrent_hash_table_t _test_tables[TEST_TABLE_COUNT];
+
+int main(void) {
+
+    static epoch_domain_t epoch;
+    epoch_domain_init(epoch);
+    const u32 participant = epoch_register(epoch);
+
+    u32 init_failed_count = 0;
+    for (
+        u32 table = 0;
+            table < TEST_TABLE_COUNT;
+          ++table) {
+
+        init_failed_count += concurrent_hash_table_init(_test_tables[table], &epoch, sizeof(u64), TEST_KEY_COUNT) ? 0 : 1;
+    }
+    SLD_TEST_CHECK(init_failed_count == 0);
+    if (init_failed_count != 0) return(test_result("concurrent hash table"));
+
+    // each table holds the same keys with its own values
+    u32 insert_failed_count = 0;
+    for (
+        u32 table = 0;
+            table < TEST_TABLE_COUNT;
+          ++table) {
+
+        for (u64 key = 0; key < TEST_KEY_COUNT; ++key) {
+            const hash_table_key_t key_v = { (const byte*)&key, sizeof(key) };
+            const u64              value = ((u64)table << 32) | key;
+            insert_failed_count += concurrent_hash_table_insert(_test_tables[table], key_v, (const byte*)&value) ? 0 : 1;
+        }
+    }
+    SLD_TEST_CHECK(insert_failed_count == 0);
+
+    u32 wrong_count = 0;
+    for (
+        u32 table = 0;
+            table < TEST_TABLE_COUNT;
+          ++table) {
+
+        wrong_count += (concurrent_hash_table_get_count(_test_tables[table]) == TEST_KEY_COUNT) ? 0 : 1;
+        for (u64 key = 0; key < TEST_KEY_COUNT; ++key) {
+            const hash_table_key_t key_v = { (const byte*)&key, sizeof(key) };
+            u64                    value = 0;
+            const bool             found = concurrent_hash_table_search(_test_tables[table], participant, key_v, (byte*)&value);
+            wrong_count += (found && value == (((u64)table << 32) | key)) ? 0 : 1;
+        }
+    }
+    SLD_TEST_CHECK(wrong_count == 0);
+
+    // a few of the shards fit, the rest run out of address space
+    static concurrent_hash_table_t huge;
+    SLD_TEST_CHECK(!concurrent_hash_table_init(huge, &epoch, TEST_HUGE_STRIDE, 0x80000000));
+    SLD_TEST_CHECK(huge.epoch == NULL);
+
+    for (
+        u32 table = 0;
+            table < TEST_TABLE_COUNT;
+          ++table) {
+
+        concurrent_hash_table_release(_test_tables[table]);
+    }
+
+    epoch_unregister     (epoch, participant);
+    epoch_domain_release (epoch);
+    return(test_result("concurrent hash table"));
+}
\ No newline at end of file
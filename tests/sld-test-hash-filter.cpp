@@ -0,0 +1,179 @@
+#include <cassert>
+#include "sld-memory.hpp"
+#include "sld-hash32.cpp"
+#include "sld-hash128.cpp"
+#include "sld-hash-short.cpp"
+#if defined(_WIN32)
+#   include "sld-win32.cpp"
+#elif defined(__linux__)
+#   include "sld-linux.cpp"
+#endif
+#include "sld-core-hash-filter.cpp"
+#include "sld-test.hpp"
+
+// fills each filter with keys, then checks every key is still there and
+// that the share of keys that were never inserted but are reported is
+// under the rate the filter is sized for. at 12 bits a key with 8 probes
+// a plain bloom filter is near 0.3%, blocking it into cache lines costs
+// a little, so the bound is 1%. a cuckoo filter with 16 bit fingerprints
+// and 4 slots checks 8 fingerprints, at most 8 / 2^16. the batch lookups
+// have to agree with the single ones
+
+using namespace sld;
+
+constexpr u32 TEST_KEY_COUNT       = (1 << 18);
+constexpr u32 TEST_QUERY_COUNT     = (1 << 20);
+constexpr f64 TEST_BLOOM_RATE_MAX  = 0.01;
+constexpr f64 TEST_CUCKOO_RATE_MAX = ((f64)(CUCKOO_FILTER_SLOT_COUNT * 2) / 65536.0);
+constexpr u32 TEST_FULL_BUCKETS    = 1024;
+
+static hash128_t
+test_key_hash(
+    const u64 key) {
+
+    const hash128_seed_t& seed = *(const hash128_seed_t*)MeowDefaultSeed;
+    const hash128_t       hash = hash128_short(seed, (const byte*)&key, sizeof(key));
+    return(hash);
+}
+
+static memory_t
+test_memory_alloc(
+    const u64 size) {
+
+    memory_t memory;
+    memory.addr = 0;
+    memory.size = size;
+    const u64 page_size = memory_os_reserve(memory);
+    assert(page_size != 0);
+    memory_os_commit(memory);
+    return(memory);
+}
+
+static void
+test_bloom_filter(
+    hash128_t* queries,
+    bool*      results) {
+
+    bloom_filter_t filter = {};
+    filter.block_count = bloom_filter_block_count(TEST_KEY_COUNT, BLOOM_FILTER_BITS_PER_KEY);
+
+    memory_t memory = test_memory_alloc(bloom_filter_memory_size(filter));
+    SLD_TEST_CHECK(bloom_filter_memory_init(filter, memory));
+
+    u32 missing_count = 0;
+    for (u32 key = 0; key < TEST_KEY_COUNT; ++key) (void)bloom_filter_insert(filter, test_key_hash(key));
+    for (u32 key = 0; key < TEST_KEY_COUNT; ++key) missing_count += bloom_filter_contains(filter, test_key_hash(key)) ? 0 : 1;
+    SLD_TEST_CHECK(missing_count == 0);
+    SLD_TEST_CHECK(filter.count  == TEST_KEY_COUNT);
+
+    u32 false_count    = 0;
+    u32 mismatch_count = 0;
+    const u32 batch_count = bloom_filter_contains_batch(filter, TEST_QUERY_COUNT, queries, results);
+    for (
+        u32 query = 0;
+            query < TEST_QUERY_COUNT;
+          ++query) {
+
+        const bool is_found = bloom_filter_contains(filter, queries[query]);
+        false_count    += is_found ? 1 : 0;
+        mismatch_count += (is_found != results[query]) ? 1 : 0;
+    }
+
+    const f64 false_rate = ((f64)false_count / TEST_QUERY_COUNT);
+    (void)printf("    bloom false positives %.4f%%\n", false_rate * 100.0);
+    SLD_TEST_CHECK(false_rate     <= TEST_BLOOM_RATE_MAX);
+    SLD_TEST_CHECK(batch_count    == false_count);
+    SLD_TEST_CHECK(mismatch_count == 0);
+
+    SLD_TEST_CHECK(bloom_filter_reset(filter));
+    SLD_TEST_CHECK(!bloom_filter_contains(filter, test_key_hash(0)));
+    memory_os_release(memory);
+}
+
+static void
+test_cuckoo_filter(
+    hash128_t* queries,
+    bool*      results) {
+
+    cuckoo_filter_t filter = {};
+    filter.bucket_count = cuckoo_filter_bucket_count(TEST_KEY_COUNT);
+
+    memory_t memory = test_memory_alloc(cuckoo_filter_memory_size(filter));
+    SLD_TEST_CHECK(cuckoo_filter_memory_init(filter, memory));
+
+    u32 failed_count  = 0;
+    u32 missing_count = 0;
+    for (u32 key = 0; key < TEST_KEY_COUNT; ++key) failed_count  += cuckoo_filter_insert   (filter, test_key_hash(key)) ? 0 : 1;
+    for (u32 key = 0; key < TEST_KEY_COUNT; ++key) missing_count += cuckoo_filter_contains (filter, test_key_hash(key)) ? 0 : 1;
+    SLD_TEST_CHECK(failed_count  == 0);
+    SLD_TEST_CHECK(missing_count == 0);
+
+    u32 false_count    = 0;
+    u32 mismatch_count = 0;
+    const u32 batch_count = cuckoo_filter_contains_batch(filter, TEST_QUERY_COUNT, queries, results);
+    for (
+        u32 query = 0;
+            query < TEST_QUERY_COUNT;
+          ++query) {
+
+        const bool is_found = cuckoo_filter_contains(filter, queries[query]);
+        false_count    += is_found ? 1 : 0;
+        mismatch_count += (is_found != results[query]) ? 1 : 0;
+    }
+
+    const f64 false_rate = ((f64)false_count / TEST_QUERY_COUNT);
+    (void)printf("    cuckoo false positives %.4f%%\n", false_rate * 100.0);
+    SLD_TEST_CHECK(false_rate     <= TEST_CUCKOO_RATE_MAX);
+    SLD_TEST_CHECK(batch_count    == false_count);
+    SLD_TEST_CHECK(mismatch_count == 0);
+
+    // removing the even keys leaves every odd one
+    u32 remove_failed_count = 0;
+    for (u32 key = 0; key < TEST_KEY_COUNT; key += 2) remove_failed_count += cuckoo_filter_remove   (filter, test_key_hash(key)) ? 0 : 1;
+    missing_count = 0;
+    for (u32 key = 1; key < TEST_KEY_COUNT; key += 2) missing_count       += cuckoo_filter_contains (filter, test_key_hash(key)) ? 0 : 1;
+    SLD_TEST_CHECK(remove_failed_count == 0);
+    SLD_TEST_CHECK(missing_count       == 0);
+    SLD_TEST_CHECK(filter.count        == (TEST_KEY_COUNT / 2));
+    memory_os_release(memory);
+
+    // a small filter takes keys past the load it's sized for before it
+    // reports full, and a remove makes room again
+    cuckoo_filter_t full = {};
+    full.bucket_count = TEST_FULL_BUCKETS;
+    memory = test_memory_alloc(cuckoo_filter_memory_size(full));
+    SLD_TEST_CHECK(cuckoo_filter_memory_init(full, memory));
+
+    const u32 slot_count   = (TEST_FULL_BUCKETS * CUCKOO_FILTER_SLOT_COUNT);
+    u32       insert_count = 0;
+    while (insert_count < slot_count && cuckoo_filter_insert(full, test_key_hash(insert_count))) ++insert_count;
+
+    missing_count = 0;
+    for (u32 key = 0; key < insert_count; ++key) missing_count += cuckoo_filter_contains(full, test_key_hash(key)) ? 0 : 1;
+    SLD_TEST_CHECK(insert_count  >= ((slot_count * CUCKOO_FILTER_LOAD_PERCENT) / 100));
+    SLD_TEST_CHECK(missing_count == 0);
+    SLD_TEST_CHECK(cuckoo_filter_remove(full, test_key_hash(0)));
+    SLD_TEST_CHECK(cuckoo_filter_insert(full, test_key_hash(0)));
+    memory_os_release(memory);
+}
+
+int main(void) {
+
+    // the queries are keys that are never inserted
+    memory_t memory = test_memory_alloc((u64)TEST_QUERY_COUNT * (sizeof(hash128_t) + sizeof(bool)));
+    hash128_t* queries = (hash128_t*)memory.ptr;
+    bool*      results = (bool*)(queries + TEST_QUERY_COUNT);
+    for (
+        u32 query = 0;
+            query < TEST_QUERY_COUNT;
+          ++query) {
+
+        queries[query] = test_key_hash(((u64)1 << 40) + query);
+    }
+
+    test_bloom_filter  (queries, results);
+    test_cuckoo_filter (queries, results);
+
+    memory_os_release(memory);
+    return(test_result("hash filter"));
+}
\ No newline at end of file
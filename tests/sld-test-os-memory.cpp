@@ -0,0 +1,100 @@
+#include <cassert>
+#include "sld-memory.hpp"
+#if defined(_WIN32)
+#   include "sld-win32.cpp"
+#elif defined(__linux__)
+#   include "sld-linux.cpp"
+#endif
+#include "sld-test.hpp"
+
+// reserves far more ranges than fit in the first reservation index, so
+// it has to grow, then commits and decommits pages in them and releases
+// every other one to check lookups still land in the right range. a
+// decommit that runs past the end of its reservation has to be refused,
+// and a reservation the os can't make has to come back empty
+
+using namespace sld;
+
+constexpr u32 TEST_RESERVATION_COUNT = 4096;
+constexpr u32 TEST_PAGE_COUNT        = 4;
+
+static memory_t _test_memory[TEST_RESERVATION_COUNT];
+
+int main(void) {
+
+    const u64 page_size = os_memory_align_to_page(1);
+
+    u32 reserve_failed_count = 0;
+    u32 commit_failed_count  = 0;
+    for (
+        u32 index = 0;
+            index < TEST_RESERVATION_COUNT;
+          ++index) {
+
+        memory_t& memory = _test_memory[index];
+        memory.addr = 0;
+        memory.size = (page_size * TEST_PAGE_COUNT);
+        if (memory_os_reserve(memory) == 0) {
+            ++reserve_failed_count;
+            continue;
+        }
+
+        // the second page is committed, the rest stays reserved
+        void* page = (void*)(memory.addr + page_size);
+        if (os_memory_commit(page, page_size) != page) ++commit_failed_count;
+        else *(u32*)page = index;
+    }
+    SLD_TEST_CHECK(reserve_failed_count == 0);
+    SLD_TEST_CHECK(commit_failed_count  == 0);
+    if (reserve_failed_count != 0) return(test_result("os memory"));
+
+    u32 wrong_count = 0;
+    for (
+        u32 index = 0;
+            index < TEST_RESERVATION_COUNT;
+          ++index) {
+
+        const memory_t& memory = _test_memory[index];
+        wrong_count += os_memory_is_reserved  ((void*)memory.addr)               ? 0 : 1;
+        wrong_count += os_memory_is_committed ((void*)(memory.addr + page_size)) ? 0 : 1;
+        wrong_count += (*(u32*)(memory.addr + page_size) == index)              ? 0 : 1;
+    }
+    SLD_TEST_CHECK(wrong_count == 0);
+
+    // past the end of the reservation, nothing may change
+    const memory_t& last = _test_memory[TEST_RESERVATION_COUNT - 1];
+    SLD_TEST_CHECK(!os_memory_decommit ((void*)(last.addr + page_size), last.size));
+    SLD_TEST_CHECK(!os_memory_commit   ((void*)(last.addr + page_size), last.size));
+    SLD_TEST_CHECK(os_memory_is_committed((void*)(last.addr + page_size)));
+
+    for (
+        u32 index = 0;
+            index < TEST_RESERVATION_COUNT;
+            index += 2) {
+
+        memory_os_release(_test_memory[index]);
+    }
+
+    wrong_count = 0;
+    for (
+        u32 index = 1;
+            index < TEST_RESERVATION_COUNT;
+            index += 2) {
+
+        const memory_t& memory = _test_memory[index];
+        wrong_count += os_memory_decommit     ((void*)(memory.addr + page_size), page_size) ? 0 : 1;
+        wrong_count += os_memory_is_committed ((void*)(memory.addr + page_size))            ? 1 : 0;
+        wrong_count += os_memory_is_reserved  ((void*)(_test_memory[index - 1].addr))       ? 1 : 0;
+        memory_os_release(_test_memory[index]);
+    }
+    SLD_TEST_CHECK(wrong_count == 0);
+
+    // more address space than the process has
+    memory_t memory_huge;
+    memory_huge.addr = 0;
+    memory_huge.size = ((u64)1 << 62);
+    SLD_TEST_CHECK(memory_os_reserve(memory_huge) == 0);
+    SLD_TEST_CHECK(memory_huge.ptr == NULL);
+
+    return(test_result("os memory"));
+}
\ No newline at end of file
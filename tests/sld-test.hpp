@@ -0,0 +1,120 @@
+#ifndef SLD_TEST_HPP
+#define SLD_TEST_HPP
+
+#include <cstdio>
+#include <chrono>
+#include <thread>
+#include "sld.hpp"
+
+// every file in tests is its own program, built by
+// scripts/SLD.Build.Tests.sh. a test includes the parts of the library it
+// covers ahead of this header and returns test_result from main, so a
+// failed check fails the script. a benchmark only prints
+#define SLD_TEST_CHECK(expr) sld::test_check((expr), #expr, __FILE__, __LINE__)
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // DECLARATIONS
+    //-------------------------------------------------------------------
+
+    struct test_state_t {
+        u32 check_count;
+        u32 fail_count;
+    };
+
+    using test_thread_f = void (*) (const u32 thread_index, void* data);
+
+    static test_state_t _test_state = {};
+
+    SLD_INTERNAL_INLINE bool test_check            (const bool passed, const char* expr, const char* file, const u32 line);
+    SLD_INTERNAL_INLINE int  test_result           (const char* name);
+    SLD_INTERNAL_INLINE f64  test_time_seconds     (void);
+    SLD_INTERNAL_INLINE u32  test_thread_count_max (void);
+    SLD_INTERNAL_INLINE void test_run_threads      (const u32 thread_count, const test_thread_f function, void* data);
+    SLD_INTERNAL_INLINE u64  test_random           (u64& state);
+
+    //-------------------------------------------------------------------
+    // INLINE METHODS
+    //-------------------------------------------------------------------
+
+    SLD_INTERNAL_INLINE bool
+    test_check(
+        const bool  passed,
+        const char* expr,
+        const char* file,
+        const u32   line) {
+
+        ++_test_state.check_count;
+        if (!passed) {
+            ++_test_state.fail_count;
+            (void)printf("    FAILED %s:%u: %s\n", file, line, expr);
+        }
+        return(passed);
+    }
+
+    SLD_INTERNAL_INLINE int
+    test_result(
+        const char* name) {
+
+        (void)printf("%s: %u checks, %u failed\n", name, _test_state.check_count, _test_state.fail_count);
+        return((_test_state.fail_count == 0) ? 0 : 1);
+    }
+
+    SLD_INTERNAL_INLINE f64
+    test_time_seconds(
+        void) {
+
+        const auto now     = std::chrono::steady_clock::now().time_since_epoch();
+        const f64  seconds = std::chrono::duration<f64>(now).count();
+        return(seconds);
+    }
+
+    SLD_INTERNAL_INLINE u32
+    test_thread_count_max(
+        void) {
+
+        // at least 4, so the lock free paths get interleaved even on a
+        // machine with fewer cores
+        const u32 core_count = std::thread::hardware_concurrency();
+        return((core_count < 4) ? 4 : core_count);
+    }
+
+    SLD_INTERNAL_INLINE void
+    test_run_threads(
+        const u32           thread_count,
+        const test_thread_f function,
+        void*               data) {
+
+        std::thread threads[64];
+        const u32   count = (thread_count < 64) ? thread_count : 64;
+        for (
+            u32 thread = 0;
+                thread < count;
+              ++thread) {
+
+            threads[thread] = std::thread(function, thread, data);
+        }
+
+        for (
+            u32 thread = 0;
+                thread < count;
+              ++thread) {
+
+            threads[thread].join();
+        }
+    }
+
+    SLD_INTERNAL_INLINE u64
+    test_random(
+        u64& state) {
+
+        // xorshift64, the state can't start at 0
+        state ^= (state << 13);
+        state ^= (state >> 7);
+        state ^= (state << 17);
+        return(state);
+    }
+};
+
+#endif //SLD_TEST_HPP
\ No newline at end of file